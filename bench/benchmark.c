@@ -0,0 +1,733 @@
+/**
+ * \file benchmark.c
+ * \brief Benchmark measuring the speed of each phase of the compression and decompression on a generated corpus, written as JSON
+ * \date 2021
+ */
+
+#include <time.h>
+#include <math.h>
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/histogram.h"
+#include "../include/huffman_coding_table.h"
+#include "../include/header.h"
+#include "../include/compression.h"
+#include "../include/decompression.h"
+#include "../include/adaptive.h"
+#include "../include/context.h"
+#include "../include/library.h"
+#include "../include/benchmark.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_CYCLES 1
+#else
+#define BENCH_HAS_CYCLES 0
+#endif
+
+/**
+ * \fn uint64_t nextRandom(uint64_t* state)
+ * \brief Gives the next number of a xorshift64* pseudo-random generator, so that the corpus is the same on every machine
+ * \param state State of the generator, updated
+ * \return Pseudo-random 64 bits number
+ */
+
+uint64_t nextRandom(uint64_t* state)
+{
+    *state^=*state>>12;
+    *state^=*state<<25;
+    *state^=*state>>27;
+    return *state*0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * \fn void createZipfTable(double* cumulative, int nbValues, double exponent)
+ * \brief Fills the cumulative distribution of a Zipf law, where the value of rank k has a probability proportional to 1/(k+1)^exponent
+ * \param cumulative Array of nbValues elements, receiving the probability of drawing a rank lower or equal to each index
+ * \param nbValues Number of ranks
+ * \param exponent Exponent of the law, the bigger it is, the more skewed the distribution is
+ */
+
+void createZipfTable(double* cumulative, int nbValues, double exponent)
+{
+    double sum=0;
+
+    for(int i=0; i<nbValues; i++){
+        sum+=1/pow(i+1, exponent);
+        cumulative[i]=sum;
+    }
+    for(int i=0; i<nbValues; i++)
+        cumulative[i]/=sum;
+}
+
+/**
+ * \fn int drawZipf(double* cumulative, int nbValues, uint64_t* state)
+ * \brief Draws a rank following the distribution created by createZipfTable
+ * \param cumulative Cumulative distribution of the ranks
+ * \param nbValues Number of ranks
+ * \param state State of the pseudo-random generator
+ * \return Rank drawn, between 0 and nbValues-1
+ */
+
+int drawZipf(double* cumulative, int nbValues, uint64_t* state)
+{
+    double x=(nextRandom(state)>>11)*(1.0/9007199254740992.0);
+    int low=0;
+    int high=nbValues-1;
+
+    while(low<high){
+        int middle=(low+high)/2;
+        if(cumulative[middle]<x)
+            low=middle+1;
+        else
+            high=middle;
+    }
+    return low;
+}
+
+/**
+ * \fn void generateUniform(unsigned char* buffer, size_t size, uint64_t* state)
+ * \brief Fills the buffer with uniformly distributed bytes, which Huffman coding can't compress
+ * \param buffer Buffer filled
+ * \param size Size of the buffer
+ * \param state State of the pseudo-random generator
+ */
+
+void generateUniform(unsigned char* buffer, size_t size, uint64_t* state)
+{
+    size_t i=0;
+    uint64_t word=0;
+
+    for(i=0; i+8<=size; i+=8){
+        word=nextRandom(state);
+        memcpy(buffer+i, &word, 8);
+    }
+    word=nextRandom(state);
+    memcpy(buffer+i, &word, size-i);
+}
+
+/**
+ * \fn void generateZipfText(unsigned char* buffer, size_t size, uint64_t* state)
+ * \brief Fills the buffer with lines of words whose frequencies follow a Zipf law, like a natural language text
+ * \param buffer Buffer filled
+ * \param size Size of the buffer
+ * \param state State of the pseudo-random generator
+ */
+
+void generateZipfText(unsigned char* buffer, size_t size, uint64_t* state)
+{
+    static const char letters[]="etaoinshrdlcumwfgypbvkjxqz";
+    const int nbWords=4096;
+    char words[4096][12];
+    double* cumulativeWords=NULL;
+    double cumulativeLetters[26];
+    size_t i=0;
+    int nbWordsInLine=0;
+
+    MALLOC(cumulativeWords, double, nbWords);
+    createZipfTable(cumulativeWords, nbWords, 1.0);
+    createZipfTable(cumulativeLetters, 26, 0.8);
+    for(int w=0; w<nbWords; w++){
+        int length=1+(int) (nextRandom(state)%10);
+        for(int j=0; j<length; j++)
+            words[w][j]=letters[drawZipf(cumulativeLetters, 26, state)];
+        words[w][length]='\0';
+    }
+
+    while(i<size){
+        const char* word=words[drawZipf(cumulativeWords, nbWords, state)];
+        for(int j=0; word[j]!='\0' && i<size; j++)
+            buffer[i++]=(unsigned char) word[j];
+        nbWordsInLine++;
+        if(i<size)
+            buffer[i++]=(unsigned char) (nbWordsInLine%12==0 ? '\n' : ' ');
+    }
+    free(cumulativeWords);
+}
+
+/**
+ * \fn void generateRuns(unsigned char* buffer, size_t size, uint64_t* state)
+ * \brief Fills the buffer with runs of a single symbol, taken among 16 symbols and repeated 1 to 256 times
+ * \param buffer Buffer filled
+ * \param size Size of the buffer
+ * \param state State of the pseudo-random generator
+ */
+
+void generateRuns(unsigned char* buffer, size_t size, uint64_t* state)
+{
+    size_t i=0;
+
+    while(i<size){
+        uint64_t random=nextRandom(state);
+        size_t length=1+(random&0xFF);
+        if(length>size-i)
+            length=size-i;
+        memset(buffer+i, (int) ((random>>8)&0xF)*17, length);
+        i+=length;
+    }
+}
+
+/**
+ * \fn void generateBinary(unsigned char* buffer, size_t size, uint64_t* state)
+ * \brief Fills the buffer with bytes looking like an executable: skewed opcodes, small little endian integers and zero padding
+ * \param buffer Buffer filled
+ * \param size Size of the buffer
+ * \param state State of the pseudo-random generator
+ */
+
+void generateBinary(unsigned char* buffer, size_t size, uint64_t* state)
+{
+    double cumulative[N_VALUES_IN_BYTE];
+    unsigned char byteOfRank[N_VALUES_IN_BYTE];
+    size_t i=0;
+
+    createZipfTable(cumulative, N_VALUES_IN_BYTE, 1.2);
+    for(int c=0; c<N_VALUES_IN_BYTE; c++)
+        byteOfRank[c]=(unsigned char) c;
+    for(int c=N_VALUES_IN_BYTE-1; c>1; c--){ // 0 stays the most frequent byte, the others are shuffled
+        int other=1+(int) (nextRandom(state)%c);
+        unsigned char tmp=byteOfRank[c];
+        byteOfRank[c]=byteOfRank[other];
+        byteOfRank[other]=tmp;
+    }
+
+    while(i<size){
+        uint64_t random=nextRandom(state);
+        size_t length=0;
+        if((random&0x3F)==0){ // Padding
+            length=16+((random>>6)&0xF0);
+            if(length>size-i)
+                length=size-i;
+            memset(buffer+i, 0, length);
+        }
+        else if((random&0x7)==1){ // Small integer, such as an address offset or an immediate value
+            uint32_t value=(uint32_t) ((random>>8)&0xFFF);
+            length=size-i<4 ? size-i : 4;
+            for(size_t j=0; j<length; j++)
+                buffer[i+j]=(unsigned char) (value>>(8*j));
+        }
+        else{
+            buffer[i]=byteOfRank[drawZipf(cumulative, N_VALUES_IN_BYTE, state)];
+            length=1;
+        }
+        i+=length;
+    }
+}
+
+/**
+ * \fn void generateCorpusFile(int type, unsigned char* buffer, size_t size)
+ * \brief Generates a file of the corpus. The same type and size always give the same content
+ * \param type Kind of file, index in the names given by getCorpusTypeName
+ * \param buffer Buffer filled
+ * \param size Size of the buffer
+ */
+
+void generateCorpusFile(int type, unsigned char* buffer, size_t size)
+{
+    uint64_t state=BENCH_SEED+(uint64_t) type;
+
+    switch(type){
+        case 0:
+            generateUniform(buffer, size, &state);
+            break;
+        case 1:
+            generateZipfText(buffer, size, &state);
+            break;
+        case 2:
+            generateRuns(buffer, size, &state);
+            break;
+        default:
+            generateBinary(buffer, size, &state);
+            break;
+    }
+}
+
+/**
+ * \fn const char* getCorpusTypeName(int type)
+ * \brief Gives the name of a kind of file of the corpus, as written in the JSON results
+ * \param type Kind of file
+ * \return Name of the kind of file
+ */
+
+const char* getCorpusTypeName(int type)
+{
+    static const char* names[BENCH_NB_CORPUS_TYPES]={"uniform", "zipf_text", "runs", "binary"};
+    return names[type];
+}
+
+/**
+ * \fn double getTime()
+ * \brief Gives the time of a monotonic clock, which is not affected by the changes of the system time
+ * \return Time in seconds
+ */
+
+double getTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec+now.tv_nsec*1e-9;
+}
+
+/**
+ * \fn uint64_t getCycles()
+ * \brief Reads the time stamp counter of the processor
+ * \return Number of reference cycles, or 0 if the processor has no such counter
+ */
+
+uint64_t getCycles()
+{
+#if BENCH_HAS_CYCLES
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * \fn void runHistogram(BenchmarkData* data)
+ * \brief Phase counting the occurrences of each character
+ * \param data File and results of the previous phases
+ */
+
+void runHistogram(BenchmarkData* data)
+{
+    countOccurrences(data->input, data->size, data->arrayOfOccurrences);
+}
+
+/**
+ * \fn void runCodeLengths(BenchmarkData* data)
+ * \brief Phase building the Huffman tree, i.e. the length of the code of each character
+ * \param data File and results of the previous phases
+ */
+
+void runCodeLengths(BenchmarkData* data)
+{
+    createCodeLengths(data->arrayOfOccurrences, data->codeLengths, DEFAULT_MAX_CODE_LENGTH);
+}
+
+/**
+ * \fn void runCodeTable(BenchmarkData* data)
+ * \brief Phase creating the canonical codes from their lengths
+ * \param data File and results of the previous phases
+ */
+
+void runCodeTable(BenchmarkData* data)
+{
+    createCanonicalCodeTable(data->codeLengths, data->codeTable);
+}
+
+/**
+ * \fn void runEncoding(BenchmarkData* data)
+ * \brief Phase writing the code of each character of the file in memory
+ * \param data File and results of the previous phases
+ */
+
+void runEncoding(BenchmarkData* data)
+{
+    BitWriter writer;
+    initializeBitWriter(&writer, NULL, data->payload, data->payloadSize);
+    encodeSymbols(&writer, data->input, data->size, data->codeTable);
+    flushBitWriter(&writer);
+}
+
+/**
+ * \fn void runHeaderParsing(BenchmarkData* data)
+ * \brief Phase reading the header of the compressed file, code lengths included
+ * \param data File and results of the previous phases
+ */
+
+void runHeaderParsing(BenchmarkData* data)
+{
+    if(readFileHeader(data->headerBuffer, data->headerSize, &data->header)!=1){
+        fprintf(stderr, "ERROR: the benchmark couldn't read its own header\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * \fn void runDecoderCreation(BenchmarkData* data)
+ * \brief Phase building the decoding tables from the code lengths read in the header
+ * \param data File and results of the previous phases
+ */
+
+void runDecoderCreation(BenchmarkData* data)
+{
+    createHuffmanDecoder(data->header.codeLengths, data->header.originalSize, &data->decoder);
+}
+
+/**
+ * \fn void runDecoding(BenchmarkData* data)
+ * \brief Phase decoding the characters written by runEncoding
+ * \param data File and results of the previous phases
+ */
+
+void runDecoding(BenchmarkData* data)
+{
+    BitReader reader;
+    initializeBitReader(&reader, NULL, data->payload, data->payloadSize);
+    if(decodeSymbols(&data->decoder, &reader, data->output, data->size)!=0){
+        fprintf(stderr, "ERROR: the benchmark couldn't decode its own data\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * \fn void runInterleavedEncoding(BenchmarkData* data)
+ * \brief Phase writing the code of each character of the file in NB_INTERLEAVED_BITSTREAMS bitstreams, one after the other
+ * \param data File and results of the previous phases
+ */
+
+void runInterleavedEncoding(BenchmarkData* data)
+{
+    BitWriter writer;
+    initializeBitWriter(&writer, NULL, data->interleavedPayload, data->interleavedPayloadSize);
+    encodeBitstreams(&writer, data->input, data->size, NB_INTERLEAVED_BITSTREAMS, data->codeTable);
+}
+
+/**
+ * \fn void runInterleavedDecoding(BenchmarkData* data)
+ * \brief Phase decoding at the same time the bitstreams written by runInterleavedEncoding
+ * \param data File and results of the previous phases
+ */
+
+void runInterleavedDecoding(BenchmarkData* data)
+{
+    if(decodeBitstreams(&data->decoder, data->interleavedPayload, data->interleavedPayloadSize, NB_INTERLEAVED_BITSTREAMS, data->bitstreamSizes, data->output, data->size)!=0){
+        fprintf(stderr, "ERROR: the benchmark couldn't decode its own data\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * \fn void runAdaptiveEncoding(BenchmarkData* data)
+ * \brief Phase encoding the file in one pass with adaptive codes, from an empty tree, to compare it with the two passes of the static codes
+ * \param data File and results of the previous phases
+ */
+
+void runAdaptiveEncoding(BenchmarkData* data)
+{
+    BitWriter writer;
+    initializeAdaptiveTree(&data->adaptiveTree);
+    initializeBitWriter(&writer, NULL, data->adaptivePayload, data->adaptivePayloadCapacity);
+    encodeAdaptive(&data->adaptiveTree, &writer, data->input, data->size);
+    endAdaptiveCodes(&data->adaptiveTree, &writer);
+    data->adaptivePayloadSize=writer.index;
+}
+
+/**
+ * \fn void runAdaptiveDecoding(BenchmarkData* data)
+ * \brief Phase decoding the adaptive codes written by runAdaptiveEncoding
+ * \param data File and results of the previous phases
+ */
+
+void runAdaptiveDecoding(BenchmarkData* data)
+{
+    BitReader reader;
+    size_t nbChars=0;
+    initializeAdaptiveTree(&data->adaptiveTree);
+    initializeBitReader(&reader, NULL, data->adaptivePayload, data->adaptivePayloadSize);
+    if(decodeAdaptive(&data->adaptiveTree, &reader, data->output, data->size+1, &nbChars)!=1 || nbChars!=data->size){ // One more character can be decoded, so that the end marker is read
+        fprintf(stderr, "ERROR: the benchmark couldn't decode its own adaptive data\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * \fn void runContextModel(BenchmarkData* data)
+ * \brief Phase counting the characters after each character and creating the code tables of the order-1 mode, which replaces the histogram and the tree of the static codes
+ * \param data File and results of the previous phases
+ */
+
+void runContextModel(BenchmarkData* data)
+{
+    unsigned char section[CONTEXT_SECTION_MAX_SIZE];
+    FileHeader header;
+    countContextOccurrences(data->input, data->size, (uint64_t (*)[N_VALUES_IN_BYTE]) data->contextOccurrences);
+    data->contextEncodedBits=createContextModel((uint64_t (*)[N_VALUES_IN_BYTE]) data->contextOccurrences, DEFAULT_MAX_CODE_LENGTH, &data->contextModel);
+    header.type=FILE_TYPE_CONTEXT;
+    header.originalSize=data->size;
+    header.nbBitstreams=1;
+    data->contextHeaderSize=createFileHeader(&header, section)+saveContextModel(&data->contextModel, section);
+}
+
+/**
+ * \fn void runContextEncoding(BenchmarkData* data)
+ * \brief Phase encoding the file with the order-1 codes, the code table changing after each character
+ * \param data File and results of the previous phases
+ */
+
+void runContextEncoding(BenchmarkData* data)
+{
+    HuffmanCode* codeTables=NULL;
+    HuffmanCode* contextCodes[N_VALUES_IN_BYTE];
+    BitWriter writer;
+    MALLOC(codeTables, HuffmanCode, data->contextModel.nbTables*N_VALUES_IN_BYTE);
+    createContextCodeTables(&data->contextModel, codeTables, contextCodes);
+    initializeBitWriter(&writer, NULL, data->contextPayload, data->contextEncodedBits/8+16);
+    encodeContextSymbols(&writer, data->input, data->size, contextCodes);
+    flushBitWriter(&writer);
+    data->contextPayloadSize=writer.index;
+    free(codeTables);
+}
+
+/**
+ * \fn void runContextDecoding(BenchmarkData* data)
+ * \brief Phase creating the decoders of the order-1 tables and decoding the content written by runContextEncoding
+ * \param data File and results of the previous phases
+ */
+
+void runContextDecoding(BenchmarkData* data)
+{
+    HuffmanDecoder* decoders=NULL;
+    HuffmanDecoder* contextDecoders[N_VALUES_IN_BYTE];
+    BitReader reader;
+    unsigned char previous=0;
+    decoders=createContextDecoders(&data->contextModel, contextDecoders);
+    initializeBitReader(&reader, NULL, data->contextPayload, data->contextPayloadSize);
+    if(decodeContextSymbols(contextDecoders, &reader, data->output, data->size, &previous)<0){
+        fprintf(stderr, "ERROR: the benchmark couldn't decode its own order-1 data\n");
+        exit(EXIT_FAILURE);
+    }
+    free(decoders);
+}
+
+/**
+ * \fn void runCompression(BenchmarkData* data)
+ * \brief Whole compression of the file in memory with the library, as a reference for the sum of the phases
+ * \param data File and results of the previous phases
+ */
+
+void runCompression(BenchmarkData* data)
+{
+    data->compressedSize=huffmanCompressWithContext(data->context, data->input, data->size, data->compressed, huffmanCompressBound(data->size));
+}
+
+/**
+ * \fn void runDecompression(BenchmarkData* data)
+ * \brief Whole decompression of the file compressed by runCompression
+ * \param data File and results of the previous phases
+ */
+
+void runDecompression(BenchmarkData* data)
+{
+    if(huffmanDecompressWithContext(data->context, data->compressed, data->compressedSize, data->output, data->size)!=data->size){
+        fprintf(stderr, "ERROR: the benchmark couldn't decompress its own data\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * \fn void measurePhase(void (*phase)(BenchmarkData*), BenchmarkData* data, double* seconds, double* cycles)
+ * \brief Runs a phase until it was measured at least BENCH_MIN_RUNS times and during BENCH_MIN_TIME seconds. Each measure runs the phase enough times to last BENCH_MIN_BATCH_TIME seconds
+ * \param phase Function running the phase
+ * \param data File and results of the previous phases
+ * \param seconds Receives the shortest duration of one run, in seconds
+ * \param cycles Receives the number of cycles of one run, in the measure giving seconds
+ */
+
+void measurePhase(void (*phase)(BenchmarkData*), BenchmarkData* data, double* seconds, double* cycles)
+{
+    double totalTime=0;
+    int nbMeasures=0;
+    long nbIterations=1;
+
+    *seconds=-1;
+    *cycles=0;
+    while(nbMeasures<BENCH_MIN_RUNS || totalTime<BENCH_MIN_TIME){
+        double start=getTime();
+        uint64_t startCycles=getCycles();
+        for(long i=0; i<nbIterations; i++)
+            phase(data);
+        uint64_t elapsedCycles=getCycles()-startCycles;
+        double elapsed=getTime()-start;
+
+        totalTime+=elapsed;
+        if(elapsed<BENCH_MIN_BATCH_TIME && nbIterations<(1L<<24)){ // Too short to be precise, this measure is discarded
+            nbIterations*=2;
+            continue;
+        }
+        if(*seconds<0 || elapsed/nbIterations<*seconds){
+            *seconds=elapsed/nbIterations;
+            *cycles=(double) elapsedCycles/nbIterations;
+        }
+        nbMeasures++;
+    }
+}
+
+/**
+ * \fn void printPhaseResult(FILE* fileOutput, const char* name, double seconds, double cycles, size_t size, int isLast)
+ * \brief Writes the measures of a phase as a JSON member. A negative duration means that the phase wasn't run, it's written as null
+ * \param fileOutput File where the JSON is written
+ * \param name Name of the phase
+ * \param seconds Duration of one run
+ * \param cycles Number of cycles of one run
+ * \param size Size of the original file
+ * \param isLast 1 if it's the last member of the object, 0 otherwise
+ */
+
+void printPhaseResult(FILE* fileOutput, const char* name, double seconds, double cycles, size_t size, int isLast)
+{
+    if(seconds<0)
+        fprintf(fileOutput, "        \"%s\": null", name);
+    else{
+        fprintf(fileOutput, "        \"%s\": {\"seconds\": %.9f, \"mb_per_s\": %.3f, \"cycles_per_byte\": ", name, seconds, seconds>0 ? size/seconds/1e6 : 0);
+        if(BENCH_HAS_CYCLES)
+            fprintf(fileOutput, "%.4f}", cycles/size);
+        else
+            fprintf(fileOutput, "null}");
+    }
+    fprintf(fileOutput, isLast ? "\n" : ",\n");
+}
+
+/**
+ * \fn void benchmarkFile(int type, size_t size, FILE* fileOutput, int isFirst)
+ * \brief Generates a file of the corpus, measures each phase on it and writes the results as a JSON object
+ * \param type Kind of file
+ * \param size Size of the file
+ * \param fileOutput File where the JSON is written
+ * \param isFirst 1 if it's the first object of the results array, 0 otherwise
+ */
+
+void benchmarkFile(int type, size_t size, FILE* fileOutput, int isFirst)
+{
+    static const char* phaseNames[BENCH_NB_PHASES]={"histogram", "tree", "code_table", "encode", "header_parse", "decode_table", "decode", "encode_interleaved", "decode_interleaved", "adaptive_encode", "adaptive_decode", "context_model", "context_encode", "context_decode", "compress", "decompress"};
+    static void (*phases[BENCH_NB_PHASES])(BenchmarkData*)={runHistogram, runCodeLengths, runCodeTable, runEncoding, runHeaderParsing, runDecoderCreation, runDecoding, runInterleavedEncoding, runInterleavedDecoding, runAdaptiveEncoding, runAdaptiveDecoding, runContextModel, runContextEncoding, runContextDecoding, runCompression, runDecompression};
+    uint64_t bitstreamOccurrences[NB_INTERLEAVED_BITSTREAMS][N_VALUES_IN_BYTE];
+    double seconds[BENCH_NB_PHASES];
+    double cycles[BENCH_NB_PHASES];
+    BenchmarkData* data=NULL;
+    unsigned char* input=NULL;
+    int nbChars=0;
+
+    MALLOC(data, BenchmarkData, 1);
+    MALLOC(input, unsigned char, size);
+    generateCorpusFile(type, input, size);
+    data->input=input;
+    data->size=size;
+    data->payload=NULL;
+    data->payloadSize=0;
+    data->interleavedPayload=NULL;
+    data->interleavedPayloadSize=0;
+    data->adaptivePayloadCapacity=size/8*17+65536; // FGK writes at most 2 bits per bit of the static codes (at most 8 per character) plus 1 per character, and the escapes of the new characters
+    data->adaptivePayloadSize=0;
+    MALLOC(data->adaptivePayload, unsigned char, data->adaptivePayloadCapacity);
+    MALLOC(data->contextOccurrences, uint64_t, N_VALUES_IN_BYTE*N_VALUES_IN_BYTE);
+    data->contextPayload=NULL;
+    data->contextPayloadSize=0;
+    MALLOC(data->output, unsigned char, size+1); // The adaptive decoding has room for one more character
+    MALLOC(data->compressed, unsigned char, huffmanCompressBound(size));
+    data->context=createHuffmanContext();
+    fprintf(stderr, "%s, %zu bytes\n", getCorpusTypeName(type), size);
+
+    // Each phase is run once before being measured, since it gives its input to the next one
+    for(int i=0; i<BENCH_NB_PHASES; i++){
+        seconds[i]=-1;
+        cycles[i]=0;
+        if(phases[i]==runEncoding){
+            nbChars=checkCodeLengths(data->codeLengths);
+            FileHeader header;
+            memcpy(header.codeLengths, data->codeLengths, N_VALUES_IN_BYTE);
+            header.type=FILE_TYPE_SINGLE;
+            header.originalSize=size;
+            header.nbBitstreams=1;
+            data->headerSize=createFileHeader(&header, data->headerBuffer);
+            if(nbChars>1){
+                data->payloadSize=getEncodedSize(data->arrayOfOccurrences, data->codeTable);
+                MALLOC(data->payload, unsigned char, data->payloadSize);
+                countBitstreamOccurrences(input, size, NB_INTERLEAVED_BITSTREAMS, bitstreamOccurrences, data->arrayOfOccurrences);
+                data->interleavedPayloadSize=getBitstreamSizes(bitstreamOccurrences, NB_INTERLEAVED_BITSTREAMS, data->codeTable, data->bitstreamSizes);
+                MALLOC(data->interleavedPayload, unsigned char, data->interleavedPayloadSize);
+            }
+        }
+        if(phases[i]==runContextEncoding) // The size of the content is known once the tables are created
+            MALLOC(data->contextPayload, unsigned char, data->contextEncodedBits/8+16);
+        if(nbChars==1 && (phases[i]==runEncoding || phases[i]==runDecoderCreation || phases[i]==runDecoding || phases[i]==runInterleavedEncoding || phases[i]==runInterleavedDecoding))
+            continue; // A file containing a single character is only a header
+        phases[i](data);
+        measurePhase(phases[i], data, &seconds[i], &cycles[i]);
+        if((phases[i]==runDecoding || phases[i]==runInterleavedDecoding || phases[i]==runAdaptiveDecoding || phases[i]==runContextDecoding) && memcmp(data->output, input, size)!=0){
+            fprintf(stderr, "ERROR: the decoded data differs from the corpus\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    fprintf(fileOutput, isFirst ? "    {\n" : ",\n    {\n");
+    fprintf(fileOutput, "      \"corpus\": \"%s\",\n", getCorpusTypeName(type));
+    fprintf(fileOutput, "      \"size\": %zu,\n", size);
+    fprintf(fileOutput, "      \"compressed_size\": %zu,\n", data->compressedSize);
+    fprintf(fileOutput, "      \"adaptive_compressed_size\": %zu,\n", FILE_HEADER_FIXED_SIZE+data->adaptivePayloadSize);
+    fprintf(fileOutput, "      \"context_compressed_size\": %zu,\n", data->contextHeaderSize+data->contextPayloadSize);
+    fprintf(fileOutput, "      \"header_size\": %d,\n", data->headerSize);
+    fprintf(fileOutput, "      \"nb_chars\": %d,\n", nbChars);
+    fprintf(fileOutput, "      \"phases\": {\n");
+    for(int i=0; i<BENCH_NB_PHASES; i++)
+        printPhaseResult(fileOutput, phaseNames[i], seconds[i], cycles[i], size, i==BENCH_NB_PHASES-1);
+    fprintf(fileOutput, "      }\n    }");
+    fflush(fileOutput);
+
+    freeHuffmanContext(&data->context);
+    free(data->compressed);
+    free(data->output);
+    free(data->payload);
+    free(data->interleavedPayload);
+    free(data->adaptivePayload);
+    free(data->contextOccurrences);
+    free(data->contextPayload);
+    free(input);
+    free(data);
+}
+
+/**
+ * \fn int main(int argc, char *argv[])
+ * \brief Main function of the benchmark. Options: --max-size N (size of the biggest file, in MiB) and -o FILE (JSON output, stdout by default)
+ * \param argc Number of arguments
+ * \param argv Array of arguments
+ * \return EXIT_SUCCESS
+ */
+
+int main(int argc, char *argv[])
+{
+    uint64_t maxSize=(uint64_t) BENCH_DEFAULT_MAX_SIZE<<20;
+    FILE* fileOutput=stdout;
+    int isFirst=1;
+
+    for(int i=1; i<argc; i++){
+        if(strcmp(argv[i], "--max-size")==0 && i+1<argc){
+            long value=strtol(argv[++i], NULL, 10);
+            if(value<1 || value>4096){
+                fprintf(stderr, "ERROR: the maximum size must be between 1 and 4096 MiB\n");
+                exit(EXIT_FAILURE);
+            }
+            maxSize=(uint64_t) value<<20;
+        }
+        else if(strcmp(argv[i], "-o")==0 && i+1<argc){
+            fileOutput=fopen(argv[++i], "w");
+            if(fileOutput==NULL){
+                fprintf(stderr, "ERROR: can't open the file %s\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else{
+            fprintf(stderr, "Usage: %s [--max-size N] [-o FILE]\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    fprintf(fileOutput, "{\n  \"max_code_length\": %d,\n  \"cycles\": %s,\n  \"results\": [\n", DEFAULT_MAX_CODE_LENGTH, BENCH_HAS_CYCLES ? "\"rdtsc\"" : "null");
+    for(int type=0; type<BENCH_NB_CORPUS_TYPES; type++){
+        uint64_t size=BENCH_MIN_SIZE;
+        while(1){
+            benchmarkFile(type, (size_t) size, fileOutput, isFirst);
+            isFirst=0;
+            if(size>=maxSize)
+                break;
+            size*=BENCH_SIZE_FACTOR;
+            if(size>maxSize) // The biggest size is always measured
+                size=maxSize;
+        }
+    }
+    fprintf(fileOutput, "\n  ]\n}\n");
+    if(fileOutput!=stdout)
+        fclose(fileOutput);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,22 @@
+/**
+ * \file adaptive.h
+ * \brief Contains the functions prototypes of adaptive.c
+ * \date 2021
+ */
+
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+void initializeAdaptiveTree(AdaptiveTree* tree);
+void linkAdaptiveNode(AdaptiveTree* tree, int index);
+void swapAdaptiveNodes(AdaptiveTree* tree, int first, int second);
+void updateAdaptiveTree(AdaptiveTree* tree, int symbol);
+void writeAdaptiveCode(AdaptiveTree* tree, int node, BitWriter* writer);
+void encodeAdaptive(AdaptiveTree* tree, BitWriter* writer, const unsigned char* input, size_t inputSize);
+void endAdaptiveCodes(AdaptiveTree* tree, BitWriter* writer);
+int decodeAdaptive(AdaptiveTree* tree, BitReader* reader, unsigned char* output, size_t outputSize, size_t* nbDecodedChars);
+uint64_t adaptiveCompression(FILE* fileInput, FILE* fileOutput, uint64_t* originalSize);
+uint64_t adaptiveDecompression(FILE* fileInput, const unsigned char* input, size_t inputSize, FILE* fileOutput);
+
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * \file archive.h
+ * \brief Contains the functions prototypes of archive.c
+ * \date 2021
+ */
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+char* joinPath(const char* directoryName, const char* fileName);
+void addDirectoryFiles(const char* directoryName, const char* relativeName, ArchiveMember** members, int* nbMembers, int* nbAllocatedMembers);
+int compareArchiveMembers(const void* first, const void* second);
+ArchiveMember* listArchiveMembers(const char* directoryName, int* nbMembers, uint64_t* originalSize);
+void freeArchiveMembers(ArchiveMember** members, int nbMembers);
+size_t readWholeFile(const char* fileName, unsigned char** buffer, size_t* bufferSize);
+void* archiveCompressionWorker(void* argument);
+uint64_t archiveCompression(const char* directoryName, ArchiveMember* members, int nbMembers, FILE* fileOutput, int nbThreads, int maxCodeLength);
+int isSafeMemberName(const char* name);
+ArchiveMember* readArchiveDirectory(const unsigned char* input, size_t inputSize, int* nbMembers);
+void extractArchiveMember(HuffmanContext* context, const unsigned char* input, ArchiveMember* member, unsigned char** output, size_t* outputSize, FILE* fileOutput);
+void createParentDirectories(const char* fileName);
+void* archiveExtractionWorker(void* argument);
+uint64_t archiveExtraction(const unsigned char* input, size_t inputSize, const char* directoryName, int nbThreads, int* nbMembers);
+uint64_t archiveMemberExtraction(const unsigned char* input, size_t inputSize, const char* memberName, FILE* fileOutput);
+
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * \file benchmark.h
+ * \brief Contains the functions prototypes of benchmark.c
+ * \date 2021
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+uint64_t nextRandom(uint64_t* state);
+void createZipfTable(double* cumulative, int nbValues, double exponent);
+int drawZipf(double* cumulative, int nbValues, uint64_t* state);
+void generateUniform(unsigned char* buffer, size_t size, uint64_t* state);
+void generateZipfText(unsigned char* buffer, size_t size, uint64_t* state);
+void generateRuns(unsigned char* buffer, size_t size, uint64_t* state);
+void generateBinary(unsigned char* buffer, size_t size, uint64_t* state);
+void generateCorpusFile(int type, unsigned char* buffer, size_t size);
+const char* getCorpusTypeName(int type);
+double getTime();
+uint64_t getCycles();
+void runHistogram(BenchmarkData* data);
+void runCodeLengths(BenchmarkData* data);
+void runCodeTable(BenchmarkData* data);
+void runEncoding(BenchmarkData* data);
+void runHeaderParsing(BenchmarkData* data);
+void runDecoderCreation(BenchmarkData* data);
+void runDecoding(BenchmarkData* data);
+void runInterleavedEncoding(BenchmarkData* data);
+void runInterleavedDecoding(BenchmarkData* data);
+void runAdaptiveEncoding(BenchmarkData* data);
+void runAdaptiveDecoding(BenchmarkData* data);
+void runCompression(BenchmarkData* data);
+void runDecompression(BenchmarkData* data);
+void measurePhase(void (*phase)(BenchmarkData*), BenchmarkData* data, double* seconds, double* cycles);
+void printPhaseResult(FILE* fileOutput, const char* name, double seconds, double cycles, size_t size, int isLast);
+void benchmarkFile(int type, size_t size, FILE* fileOutput, int isFirst);
+
+
+#endif
@@ -0,0 +1,20 @@
+/**
+ * \file blocks.h
+ * \brief Contains the functions prototypes of blocks.c
+ * \date 2021
+ */
+
+#ifndef BLOCKS_H
+#define BLOCKS_H
+
+void compressBlock(const unsigned char* input, int inputSize, int nbBitstreams, int maxCodeLength, CompressedBlock* block);
+void* blockCompressionWorker(void* argument);
+uint64_t blockCompression(const unsigned char* input, uint64_t fileSize, FILE* fileOutput, int blockSize, int nbBitstreams, int nbThreads, int maxCodeLength);
+uint64_t streamCompression(const unsigned char* prefix, size_t prefixSize, FILE* fileInput, FILE* fileOutput, int chunkSize, int nbBitstreams, int maxCodeLength, uint64_t* originalSize, uint64_t* compressedSize);
+void decompressBlock(const unsigned char* block, size_t blockSize, int nbBitstreams, unsigned char* output, int originalSize);
+uint64_t blockDecompression(FILE* fileInput, int blockSize, int nbBitstreams, FILE* fileOutput);
+void* blockDecompressionWorker(void* argument);
+void parallelBlockDecompression(const unsigned char* input, size_t inputSize, size_t headerSize, int blockSize, int nbBitstreams, uint64_t originalSize, FILE* fileOutput, int nbThreads);
+
+
+#endif
@@ -7,9 +7,20 @@
 #ifndef COMPRESSION_H
 #define COMPRESSION_H
 
-void huffManCompression(FILE* fileInput, unsigned char * huffmanArray[N_VALUES_IN_BYTE], FILE* fileOutput);
+void writeWord(unsigned char* outputBuffer, uint64_t word);
+void initializeBitWriter(BitWriter* writer, FILE* file, unsigned char* content, size_t size);
+void emptyBitWriter(BitWriter* writer);
+void writeBits(BitWriter* writer, uint64_t value, int nbBits);
+void encodeSymbols(BitWriter* writer, const unsigned char* input, size_t inputSize, HuffmanCode codeTable[N_VALUES_IN_BYTE]);
+void flushBitWriter(BitWriter* writer);
+uint64_t getEncodedSize(uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE], HuffmanCode codeTable[N_VALUES_IN_BYTE]);
+uint64_t getBitstreamLength(uint64_t nbChars, int bitstream, int nbBitstreams);
+uint64_t getBitstreamSizes(uint64_t bitstreamOccurrences[][N_VALUES_IN_BYTE], int nbBitstreams, HuffmanCode codeTable[N_VALUES_IN_BYTE], uint64_t* bitstreamSizes);
+void encodeBitstreams(BitWriter* writer, const unsigned char* input, size_t inputSize, int nbBitstreams, HuffmanCode codeTable[N_VALUES_IN_BYTE]);
+uint64_t huffManCompression(const unsigned char* input, size_t inputSize, int nbBitstreams, HuffmanCode codeTable[N_VALUES_IN_BYTE], FILE* fileOutput);
+uint64_t sampledCompression(const unsigned char* input, size_t inputSize, HuffmanCode codeTable[N_VALUES_IN_BYTE], FILE* fileOutput, uint64_t* arrayOfOccurrences, double* countingTime);
 
 
 
 
-#endif
\ No newline at end of file
+#endif
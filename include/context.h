@@ -0,0 +1,25 @@
+/**
+ * \file context.h
+ * \brief Contains the functions prototypes of context.c
+ * \date 2021
+ */
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+uint64_t getCodingCost(uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE], unsigned char codeLengths[N_VALUES_IN_BYTE]);
+int getCodeLengthsCost(unsigned char codeLengths[N_VALUES_IN_BYTE]);
+int addContextTable(ContextModel* model, unsigned char codeLengths[N_VALUES_IN_BYTE]);
+uint64_t createContextModel(uint64_t contextOccurrences[][N_VALUES_IN_BYTE], int maxCodeLength, ContextModel* model);
+int saveContextModel(ContextModel* model, unsigned char* buffer);
+int readContextModel(const unsigned char* buffer, size_t size, ContextModel* model);
+int readContextModelFromFile(FILE* fileInput, ContextModel* model);
+void createContextCodeTables(ContextModel* model, HuffmanCode* codeTables, HuffmanCode* contextCodes[N_VALUES_IN_BYTE]);
+HuffmanDecoder* createContextDecoders(ContextModel* model, HuffmanDecoder* contextDecoders[N_VALUES_IN_BYTE]);
+void encodeContextSymbols(BitWriter* writer, const unsigned char* input, size_t inputSize, HuffmanCode* contextCodes[N_VALUES_IN_BYTE]);
+int decodeContextSymbols(HuffmanDecoder* contextDecoders[N_VALUES_IN_BYTE], BitReader* reader, unsigned char* output, size_t nbChars, unsigned char* previous);
+uint64_t contextCompression(const unsigned char* input, size_t inputSize, ContextModel* model, FILE* fileOutput);
+void contextDecompression(FILE* fileInput, const unsigned char* input, size_t inputSize, uint64_t fileSize, ContextModel* model, FILE* fileOutput);
+
+
+#endif
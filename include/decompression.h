@@ -7,9 +7,23 @@
 #ifndef DECOMPRESSION_H
 #define DECOMPRESSION_H
 
-void huffManDecompression(FILE* fileInput, int fileSize, TreeNode* treeHead, FILE* fileOutput);
+void initializeBitReader(BitReader* reader, FILE* file, const unsigned char* content, size_t size);
+void fillBitReader(BitReader* reader);
+void freeBitReader(BitReader* reader);
+void alignBitReader(BitReader* reader);
+void createHuffmanDecoder(unsigned char codeLengths[N_VALUES_IN_BYTE], uint64_t nbChars, HuffmanDecoder* decoder);
+void createMultiDecodeTable(HuffmanDecoder* decoder);
+int decodeLongCode(HuffmanDecoder* decoder, uint64_t bits, unsigned char* c);
+int decodeSymbols(HuffmanDecoder* decoder, BitReader* reader, unsigned char* output, size_t nbChars);
+int decodeLongCodeFromReader(HuffmanDecoder* decoder, BitReader* reader, unsigned char* c);
+int decodeInterleavedSymbols(HuffmanDecoder* decoder, BitReader readers[NB_INTERLEAVED_BITSTREAMS], unsigned char* outputs[NB_INTERLEAVED_BITSTREAMS], size_t nbChars[NB_INTERLEAVED_BITSTREAMS]);
+int initializeBitstreamReaders(const unsigned char* input, size_t inputSize, uint64_t* bitstreamSizes, BitReader readers[NB_INTERLEAVED_BITSTREAMS]);
+int decodeBitstreams(HuffmanDecoder* decoder, const unsigned char* input, size_t inputSize, int nbBitstreams, uint64_t* bitstreamSizes, unsigned char* output, size_t nbChars);
+void huffManDecompression(FILE* fileInput, const unsigned char* input, size_t inputSize, uint64_t fileSize, int nbBitstreams, HuffmanDecoder* decoder, FILE* fileOutput);
+void huffManDecompressionInterleaved(const unsigned char* input, size_t inputSize, uint64_t fileSize, uint64_t* bitstreamSizes, HuffmanDecoder* decoder, FILE* fileOutput);
+void huffManDecompressionTreeWalk(FILE* fileInput, uint64_t fileSize, int nbBitstreams, TreeNode* treeHead, FILE* fileOutput);
 
 
 
 
-#endif
\ No newline at end of file
+#endif
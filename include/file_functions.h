@@ -7,10 +7,18 @@
 #ifndef FILE_FUNCTIONS_H
 #define FILE_FUNCTIONS_H
 
-void getFileName(unsigned char fileName[FILENAME_MAX]);
-int getSizeOfFile(FILE* file);
+#include <sys/types.h>  // Used for off_t
+
+void getFileName(char fileName[FILENAME_MAX]);
+uint64_t getSizeOfFile(FILE* file);
+int isRegularFile(FILE* file);
 void checkFopen(FILE* file);
 void fcloseAndCheck(FILE* file);
+void writeLittleEndian(unsigned char* buffer, uint64_t value, int nbBytes);
+uint64_t readLittleEndian(const unsigned char* buffer, int nbBytes);
+void fwriteAndCheck(const void* buffer, size_t size, FILE* file);
+void freadAndCheck(void* buffer, size_t size, FILE* file);
+void pwriteAndCheck(int fileDescriptor, const void* buffer, size_t size, off_t offset);
 
 
-#endif
\ No newline at end of file
+#endif
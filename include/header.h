@@ -0,0 +1,19 @@
+/**
+ * \file header.h
+ * \brief Contains the functions prototypes of header.c
+ * \date 2021
+ */
+
+#ifndef HEADER_H
+#define HEADER_H
+
+int writeVarint(unsigned char* buffer, uint64_t value);
+int readVarint(const unsigned char* buffer, size_t size, uint64_t* value);
+int hasOriginalSize(int type);
+int createFileHeader(FileHeader* header, unsigned char* buffer);
+void saveFileHeader(FileHeader* header, FILE* fileOutput);
+int readFileHeader(const unsigned char* input, size_t inputSize, FileHeader* header);
+int getFileHeaderFromFile(FILE* fileInput, FileHeader* header);
+
+
+#endif
@@ -0,0 +1,20 @@
+/**
+ * \file histogram.h
+ * \brief Contains the functions prototypes of histogram.c
+ * \date 2021
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+void addWordToSubHistograms(uint64_t word, uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE]);
+size_t countOccurrencesScalar(const unsigned char* input, size_t inputSize, uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE]);
+size_t countOccurrencesSSE2(const unsigned char* input, size_t inputSize, uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE]);
+size_t countOccurrencesAVX2(const unsigned char* input, size_t inputSize, uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE]);
+void countOccurrences(const unsigned char* input, size_t inputSize, uint64_t *arrayOfOccurrences);
+size_t countSampledOccurrences(const unsigned char* input, size_t inputSize, uint64_t* arrayOfOccurrences);
+void countContextOccurrences(const unsigned char* input, size_t inputSize, uint64_t contextOccurrences[][N_VALUES_IN_BYTE]);
+void countBitstreamOccurrences(const unsigned char* input, size_t inputSize, int nbBitstreams, uint64_t bitstreamOccurrences[][N_VALUES_IN_BYTE], uint64_t* arrayOfOccurrences);
+
+
+#endif
@@ -9,30 +9,24 @@
 
 
 void freeTree(TreeNode** tree);
-void copyArray(unsigned char* source, unsigned char* destination, int size);
-void freeArray(unsigned char * huffmanArray[N_VALUES_IN_BYTE]);
-void freeList(ListNode** head);
-TreeNode* createTreeNode(int cInput, int occurrenceInput, TreeNode* leftNodeInput, TreeNode* rightNodeInput);
-ListNode* createListNode(TreeNode* x, ListNode* nextInput);
-void push(ListNode** head, TreeNode* x);
-TreeNode* popFirst(ListNode** head);
-void initializeBuffersPosChar(Buffer* bufferPos, Buffer* bufferChar);
-ListNode* createListOfNodes(int *arrayOfOccurrences);
-int createArrayOfOccurrences(int *arrayOfOccurrences, FILE* fileInput);
-ListNode* listMinOccurrence(ListNode* head, ListNode** nodeBeforeMinElement);
-TreeNode* popMin(ListNode** head);
-TreeNode* mergeNodes(TreeNode* nodeToMergeLeft, TreeNode* nodeToMergeRight);
-TreeNode* createHuffmanTree(ListNode** head);
-void insertInBufferPos(unsigned char *buffer, Buffer *bufferPos, int *i_BufferPos, int *filling);
-void fillBuffers(TreeNode* tree, Buffer *bufferPos, Buffer *bufferChar, int *i_BufferPos, int *i_BufferChar, unsigned char *buffer, int* filling);
-int saveHuffmanTree(TreeNode* tree, Buffer *bufferPos, Buffer *bufferChar, FILE* fileOutput, int fileSize);
-void getDataFromCompressedFile(FILE* fileInput, int* fileSize, Buffer* bufferChar, Buffer* bufferPos);
+TreeNode* createTreeNode(int cInput, uint64_t occurrenceInput, TreeNode* leftNodeInput, TreeNode* rightNodeInput);
+void siftDownKey(uint64_t* keys, int root, int nbKeys);
+void sortKeys(uint64_t* keys, int nbKeys);
+int sortCharsByOccurrence(uint64_t *arrayOfOccurrences, uint64_t sortedKeys[N_VALUES_IN_BYTE]);
+uint64_t limitCodeLengths(uint64_t sortedKeys[N_VALUES_IN_BYTE], int* depths, int nbChars, unsigned char codeLengths[N_VALUES_IN_BYTE], int maxCodeLength);
+uint64_t createCodeLengths(uint64_t *arrayOfOccurrences, unsigned char codeLengths[N_VALUES_IN_BYTE], int maxCodeLength);
+int checkCodeLengths(unsigned char codeLengths[N_VALUES_IN_BYTE]);
+void createCanonicalCodeTable(unsigned char codeLengths[N_VALUES_IN_BYTE], HuffmanCode codeTable[N_VALUES_IN_BYTE]);
+TreeNode* buildHuffmanTreeFromCodeTable(HuffmanCode codeTable[N_VALUES_IN_BYTE]);
+int saveCodeLengthsInBuffer(unsigned char codeLengths[N_VALUES_IN_BYTE], unsigned char* buffer);
+int getCodeLengthsSectionSize(unsigned char firstByte);
+int getCodeLengthsFromBuffer(const unsigned char* buffer, size_t size, unsigned char codeLengths[N_VALUES_IN_BYTE], int* nbChars);
+int isVersion1File(const unsigned char* input, size_t inputSize);
+void getDataFromCompressedFile(FILE* fileInput, uint64_t* fileSize, Buffer* bufferChar, Buffer* bufferPos);
 void fillAndCheckBufferFromBufferPos(Buffer *bufferPos, int *i_BufferPos, int *nbReadBits, unsigned char *buffer);
 TreeNode* buildHuffmanTreeFromBuffersRec(Buffer *bufferPos, Buffer *bufferChar, int *i_BufferPos, int *i_BufferChar, unsigned char *buffer, int* nbReadBits, unsigned char* prevInstruction);
 TreeNode* buildHuffmanTreeFromBuffers(Buffer *bufferPos, Buffer *bufferChar);
-void createHuffmanArray(TreeNode* huffmanTree, unsigned char * huffmanArray[N_VALUES_IN_BYTE]);
-void createHuffmanArrayRec(TreeNode* huffmanTree, unsigned char * huffmanArray[N_VALUES_IN_BYTE], unsigned char tempArray[33], int *currentByteIndex, int *bitIndex);
 
 
 
-#endif
\ No newline at end of file
+#endif
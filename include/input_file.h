@@ -0,0 +1,18 @@
+/**
+ * \file input_file.h
+ * \brief Contains the functions prototypes of input_file.c
+ * \date 2021
+ */
+
+#ifndef INPUT_FILE_H
+#define INPUT_FILE_H
+
+int isStreamName(const char* fileName);
+void openInputStream(const char* fileName, InputFile* inputFile);
+void openInputFile(const char* fileName, InputFile* inputFile);
+void readInputFile(InputFile* inputFile);
+int readInputFileWithinBudget(InputFile* inputFile, size_t budget);
+void closeInputFile(InputFile* inputFile);
+
+
+#endif
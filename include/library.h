@@ -0,0 +1,21 @@
+/**
+ * \file library.h
+ * \brief Contains the functions prototypes of library.c. It's the header included by the programs using libhuffman
+ * \date 2021
+ */
+
+#ifndef LIBRARY_H
+#define LIBRARY_H
+
+#include "types.h"  // Used for HuffmanContext
+
+HuffmanContext* createHuffmanContext();
+void freeHuffmanContext(HuffmanContext** context);
+size_t huffmanCompressBound(size_t srcSize);
+size_t huffmanCompressWithContext(HuffmanContext* context, const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstCapacity);
+size_t huffmanDecompressWithContext(HuffmanContext* context, const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstCapacity);
+size_t huffmanCompress(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstCapacity);
+size_t huffmanDecompress(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstCapacity);
+
+
+#endif
@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>  // Used for strncmp, strchr and strncpy in main.c and file_functions.c
+#include <inttypes.h>  // Used to print and read the 64 bits sizes
 
 //CONSTANTS
 
@@ -20,6 +21,552 @@
 
 #define N_VALUES_IN_BYTE 256
 
+/**
+ * \def FILE_MAGIC
+ * \brief Bytes at the beginning of the compressed files with a binary header. The first one can't start a file of version 1, which starts with the size of the original file in text
+ */
+
+#define FILE_MAGIC "\x89HUF"
+
+/**
+ * \def TABLE_MAGIC
+ * \brief Bytes at the beginning of the shared table files created by --train
+ */
+
+#define TABLE_MAGIC "\x89HUT"
+
+/**
+ * \def TABLE_FORMAT_VERSION
+ * \brief Version of the format of the shared table files
+ */
+
+#define TABLE_FORMAT_VERSION 1
+
+/**
+ * \def TABLE_HEADER_SIZE
+ * \brief Size of the header of the shared table files: TABLE_MAGIC, the version and the ID of the table on 4 bytes. It's followed by the length of the codes
+ */
+
+#define TABLE_HEADER_SIZE 9
+
+/**
+ * \def FILE_FORMAT_VERSION
+ * \brief Version of the format of the compressed files with a binary header
+ */
+
+#define FILE_FORMAT_VERSION 5
+
+/**
+ * \def FILE_TYPE_SINGLE
+ * \brief Type of the compressed files made of a single stream of codes, whose lengths are in the header
+ */
+
+#define FILE_TYPE_SINGLE 0
+
+/**
+ * \def FILE_TYPE_BLOCKS
+ * \brief Type of the compressed files split in blocks compressed separately, followed by an index of the blocks
+ */
+
+#define FILE_TYPE_BLOCKS 1
+
+/**
+ * \def FILE_TYPE_STREAM
+ * \brief Type of the compressed streams, made of chunks compressed separately and followed by an end marker, without index
+ */
+
+#define FILE_TYPE_STREAM 2
+
+/**
+ * \def FILE_TYPE_TABLE
+ * \brief Type of the compressed files made of a single stream of codes taken from a shared table file, whose ID is in the header instead of the length of the codes
+ */
+
+#define FILE_TYPE_TABLE 3
+
+/**
+ * \def FILE_TYPE_ADAPTIVE
+ * \brief Type of the compressed files encoded in one pass with adaptive Huffman codes, updated after each character by the compression and the decompression, so the header contains no code. The codes end with an end marker
+ */
+
+#define FILE_TYPE_ADAPTIVE 4
+
+/**
+ * \def FILE_TYPE_ARCHIVE
+ * \brief Type of the archives of a directory, containing its files compressed separately (each one being a compressed file of a single stream, with its own header), followed by their central directory
+ */
+
+#define FILE_TYPE_ARCHIVE 5
+
+/**
+ * \def FILE_TYPE_CONTEXT
+ * \brief Type of the compressed files made of a single stream of order-1 codes: the code of each character is taken from the table of the character before it. The header is followed by the context section describing the tables
+ */
+
+#define FILE_TYPE_CONTEXT 6
+
+/**
+ * \def FILE_TYPE_STORED
+ * \brief Type of the compressed files whose characters are copied after the header without being encoded, because they can't be compressed
+ */
+
+#define FILE_TYPE_STORED 7
+
+/**
+ * \def STORED_MIN_GAIN
+ * \brief A file or a block is stored instead of being encoded when its codes would save less than 1/STORED_MIN_GAIN of its size, which isn't worth decoding them
+ */
+
+#define STORED_MIN_GAIN 64
+
+/**
+ * \def STORED_BLOCK_FLAG
+ * \brief Flag added to the size of the compressed data of a block (which is never above MAX_BLOCK_SIZE MiB) when it's stored: its characters directly follow its header, without codes
+ */
+
+#define STORED_BLOCK_FLAG 0x80000000
+
+/**
+ * \def CONTEXT_MAP_SIZE
+ * \brief Size of the bitmap of the context section giving the characters that are followed by another one (or the character 0, which is the context of the first character)
+ */
+
+#define CONTEXT_MAP_SIZE (N_VALUES_IN_BYTE/8)
+
+/**
+ * \def CONTEXT_SECTION_MAX_SIZE
+ * \brief Maximum size of the context section: the number of tables minus 1, the bitmap of the contexts, the table of each context and the length of the codes of each table
+ */
+
+#define CONTEXT_SECTION_MAX_SIZE (1+CONTEXT_MAP_SIZE+N_VALUES_IN_BYTE+N_VALUES_IN_BYTE*(N_VALUES_IN_BYTE+1))
+
+/**
+ * \def FILE_TYPE_MASK
+ * \brief Bits of the type byte of the header that give the type of the file, the other ones being flags
+ */
+
+#define FILE_TYPE_MASK 0x0F
+
+/**
+ * \def FILE_FLAG_INTERLEAVED
+ * \brief Flag of the type byte set when the compressed data of the file, or of each of its blocks, is split in NB_INTERLEAVED_BITSTREAMS bitstreams
+ */
+
+#define FILE_FLAG_INTERLEAVED 0x10
+
+/**
+ * \def NB_INTERLEAVED_BITSTREAMS
+ * \brief Number of bitstreams of the interleaved files. The characters are split in as many consecutive parts, each one encoded in its own bitstream with the same codes, so that they can be decoded at the same time
+ */
+
+#define NB_INTERLEAVED_BITSTREAMS 4
+
+/**
+ * \def INTERLEAVED_MIN_SIZE
+ * \brief Minimum size of a file for its compressed data to be split in bitstreams, below which the bigger header isn't worth it
+ */
+
+#define INTERLEAVED_MIN_SIZE 16384
+
+/**
+ * \def BITSTREAM_TABLE_SIZE
+ * \brief Size of the table following the length of the codes in the blocks of the interleaved files: the size of each bitstream but the last one, on 4 bytes
+ */
+
+#define BITSTREAM_TABLE_SIZE (4*(NB_INTERLEAVED_BITSTREAMS-1))
+
+/**
+ * \def FILE_HEADER_FIXED_SIZE
+ * \brief Size of the fixed part of the binary header: the magic (4 bytes), the version (1 byte), the type (1 byte) and the size of the header (2 bytes). It's also the offset of the section containing the length of the codes
+ */
+
+#define FILE_HEADER_FIXED_SIZE 8
+
+/**
+ * \def MAX_VARINT_SIZE
+ * \brief Maximum number of bytes of a 64 bits integer saved as a varint (7 bits per byte)
+ */
+
+#define MAX_VARINT_SIZE 10
+
+/**
+ * \def FILE_HEADER_MAX_SIZE
+ * \brief Maximum size of the binary header: the fixed part, the length of the codes, two varints and the size of the bitstreams but the last one
+ */
+
+#define FILE_HEADER_MAX_SIZE (FILE_HEADER_FIXED_SIZE+N_VALUES_IN_BYTE+1+(NB_INTERLEAVED_BITSTREAMS+1)*MAX_VARINT_SIZE)
+
+/**
+ * \def INDEX_MAGIC
+ * \brief Characters at the end of the compressed files split in blocks, after the position of the index
+ */
+
+#define INDEX_MAGIC "HUFI"
+
+/**
+ * \def ARCHIVE_MAGIC
+ * \brief Characters at the end of the archives, after the position of the central directory on 8 bytes and the number of files on 4 bytes (TRAILER_SIZE bytes in all, like the files split in blocks)
+ */
+
+#define ARCHIVE_MAGIC "HUFA"
+
+/**
+ * \def FRAME_HEADER_SIZE
+ * \brief Size of the header of a block: its original size and the size of its compressed data, both on 4 bytes
+ */
+
+#define FRAME_HEADER_SIZE 8
+
+/**
+ * \def MAX_FRAME_OVERHEAD
+ * \brief Maximum number of bytes that a compressed block has more than its original size: its header, the length of the codes and the size of its bitstreams, plus the last byte of each bitstream that may be incomplete. The codes are never longer than 8 bits in average
+ */
+
+#define MAX_FRAME_OVERHEAD (FRAME_HEADER_SIZE+N_VALUES_IN_BYTE+1+BITSTREAM_TABLE_SIZE+NB_INTERLEAVED_BITSTREAMS)
+
+/**
+ * \def INDEX_ENTRY_SIZE
+ * \brief Size of an entry of the index of the blocks: the position of the block on 8 bytes, its original size and its compressed size on 4 bytes
+ */
+
+#define INDEX_ENTRY_SIZE 16
+
+/**
+ * \def TRAILER_SIZE
+ * \brief Size of the end of the compressed files split in blocks: the position of the index on 8 bytes, the number of blocks on 4 bytes and INDEX_MAGIC
+ */
+
+#define TRAILER_SIZE 16
+
+/**
+ * \def DEFAULT_BLOCK_SIZE
+ * \brief Default size of the blocks, in MiB
+ */
+
+#define DEFAULT_BLOCK_SIZE 4
+
+/**
+ * \def MAX_BLOCK_SIZE
+ * \brief Maximum size of the blocks, in MiB
+ */
+
+#define MAX_BLOCK_SIZE 1024
+
+/**
+ * \def DEFAULT_MEMORY_BUDGET
+ * \brief Default maximum size, in MiB, of a stream (e.g. stdin) that is read in memory to be compressed like a file, with a single header and a single pass on its characters. Bigger streams are compressed by chunks
+ */
+
+#define DEFAULT_MEMORY_BUDGET 64
+
+/**
+ * \def MAX_PIPELINE_DEPTH
+ * \brief Maximum number of buffers between the coding and the thread reading or writing a stream, given by --pipeline
+ */
+
+#define MAX_PIPELINE_DEPTH 64
+
+/**
+ * \def DEFAULT_PIPELINE_BUFFER_SIZE
+ * \brief Default size, in KiB, of the buffers between the coding and the thread reading or writing a stream
+ */
+
+#define DEFAULT_PIPELINE_BUFFER_SIZE 1024
+
+/**
+ * \def MAX_PIPELINE_BUFFER_SIZE
+ * \brief Maximum size, in KiB, of the buffers between the coding and the thread reading or writing a stream
+ */
+
+#define MAX_PIPELINE_BUFFER_SIZE 65536
+
+/**
+ * \def MAX_CODE_LENGTH
+ * \brief Maximum length of a Huffman code, so that it fits in the 64 bits buffers used to compress and decompress even when they already contain 7 bits
+ */
+
+#define MAX_CODE_LENGTH 57
+
+/**
+ * \def DEFAULT_MAX_CODE_LENGTH
+ * \brief Default maximum length of the Huffman codes (--max-code-len), so that most codes are decoded by the decode table and skewed files don't get very long codes
+ */
+
+#define DEFAULT_MAX_CODE_LENGTH 15
+
+/**
+ * \def MIN_MAX_CODE_LENGTH
+ * \brief Lowest value accepted by --max-code-len, so that the 256 characters can always have a code
+ */
+
+#define MIN_MAX_CODE_LENGTH 8
+
+/**
+ * \def ADAPTIVE_MAX_NODES
+ * \brief Maximum number of nodes of the adaptive Huffman tree: a leaf per character, the NYT leaf (Not Yet Transmitted, standing for the characters not seen yet) and the internal nodes
+ */
+
+#define ADAPTIVE_MAX_NODES (2*N_VALUES_IN_BYTE+1)
+
+/**
+ * \def ADAPTIVE_SYMBOL_BITS
+ * \brief Number of bits written after the code of the NYT leaf: the value of a new character, or ADAPTIVE_END_OF_DATA
+ */
+
+#define ADAPTIVE_SYMBOL_BITS 9
+
+/**
+ * \def ADAPTIVE_END_OF_DATA
+ * \brief Value written after the code of the NYT leaf at the end of the adaptive codes, so that a stream can be compressed without knowing its size
+ */
+
+#define ADAPTIVE_END_OF_DATA N_VALUES_IN_BYTE
+
+/**
+ * \def DECODE_TABLE_BITS
+ * \brief Number of bits decoded at once by huffManDecompression. Codes that are longer need a slower path
+ */
+
+#define DECODE_TABLE_BITS 11
+
+/**
+ * \def DECODE_TABLE_SIZE
+ * \brief Number of entries of the decode table
+ */
+
+#define DECODE_TABLE_SIZE (1<<DECODE_TABLE_BITS)
+
+/**
+ * \def MAX_SYMBOLS_PER_LOOKUP
+ * \brief Maximum number of characters decoded by a lookup in the multi-symbol decode table
+ */
+
+#define MAX_SYMBOLS_PER_LOOKUP 6
+
+/**
+ * \def LOOKUPS_PER_REFILL
+ * \brief Number of lookups of DECODE_TABLE_BITS bits done between two fillings of the bit reader, which gives at least 57 bits
+ */
+
+#define LOOKUPS_PER_REFILL (57/DECODE_TABLE_BITS)
+
+/**
+ * \def MULTI_DECODE_MAX_AVERAGE_LENGTH
+ * \brief The multi-symbol decode table is used when the average length of the codes, weighted by the probability 2^-length implied by each code, is at most this number of bits, so that a lookup decodes about two characters or more
+ */
+
+#define MULTI_DECODE_MAX_AVERAGE_LENGTH 5.5
+
+/**
+ * \def MULTI_DECODE_MIN_CHARS
+ * \brief Minimum number of characters decoded for the multi-symbol decode table to be created, since it takes longer to build than the single-symbol one
+ */
+
+#define MULTI_DECODE_MIN_CHARS (32*DECODE_TABLE_SIZE)
+
+/**
+ * \def NB_SUB_HISTOGRAMS
+ * \brief Number of histograms incremented in turn when counting the characters, so that runs of the same character don't wait for the same counter
+ */
+
+#define NB_SUB_HISTOGRAMS 4
+
+/**
+ * \def HISTOGRAM_CHUNK_SIZE
+ * \brief Number of characters counted before the sub-histograms are merged, so that their 32 bits counters can't overflow
+ */
+
+#define HISTOGRAM_CHUNK_SIZE (1<<30)
+
+/**
+ * \def SAMPLE_NB_READS
+ * \brief Number of parts of the file read by --sample to create the codes, one in each of the SAMPLE_NB_READS slices of the file
+ */
+
+#define SAMPLE_NB_READS 64
+
+/**
+ * \def SAMPLE_READ_SIZE
+ * \brief Size of each part of the file read by --sample, in bytes. Files that aren't bigger than SAMPLE_NB_READS parts are counted entirely
+ */
+
+#define SAMPLE_READ_SIZE (1024*1024)
+
+/**
+ * \def SAMPLE_ALIGNMENT
+ * \brief The parts read by --sample start at a multiple of this size, so that they only contain whole pages of the file
+ */
+
+#define SAMPLE_ALIGNMENT 4096
+
+/**
+ * \def IO_BUFFER_SIZE
+ * \brief Size of the buffers used to read and write files by blocks instead of byte by byte
+ */
+
+#define IO_BUFFER_SIZE 65536
+
+/**
+ * \def STATS_TEXT
+ * \brief Format of the statistics displayed by --stats, readable by a human
+ */
+
+#define STATS_TEXT 0
+
+/**
+ * \def STATS_JSON
+ * \brief Format of the statistics displayed by --stats=json
+ */
+
+#define STATS_JSON 1
+
+/**
+ * \def PHASE_OPEN
+ * \brief Phase opening the input file, mapping it or reading it when it can't be mapped
+ */
+
+#define PHASE_OPEN 0
+
+/**
+ * \def PHASE_HISTOGRAM
+ * \brief Phase counting the occurrences of each character. The pages of a mapped file are read from the disk during this phase
+ */
+
+#define PHASE_HISTOGRAM 1
+
+/**
+ * \def PHASE_CODE_LENGTHS
+ * \brief Phase building the Huffman tree and the length of the codes
+ */
+
+#define PHASE_CODE_LENGTHS 2
+
+/**
+ * \def PHASE_CODE_TABLE
+ * \brief Phase building the canonical codes, or the tree used by --tree-walk
+ */
+
+#define PHASE_CODE_TABLE 3
+
+/**
+ * \def PHASE_HEADER
+ * \brief Phase writing or reading the header of the compressed file
+ */
+
+#define PHASE_HEADER 4
+
+/**
+ * \def PHASE_ENCODE
+ * \brief Phase encoding the characters and writing them in the output file
+ */
+
+#define PHASE_ENCODE 5
+
+/**
+ * \def PHASE_DECODE_TABLE
+ * \brief Phase building the decode table from the length of the codes
+ */
+
+#define PHASE_DECODE_TABLE 6
+
+/**
+ * \def PHASE_DECODE
+ * \brief Phase decoding the characters and writing them in the output file
+ */
+
+#define PHASE_DECODE 7
+
+/**
+ * \def PHASE_BLOCKS
+ * \brief Phase compressing or decompressing blocks or a stream, whose own phases are interleaved between the threads
+ */
+
+#define PHASE_BLOCKS 8
+
+/**
+ * \def PHASE_CLOSE
+ * \brief Phase closing the files, which writes the data still buffered
+ */
+
+#define PHASE_CLOSE 9
+
+/**
+ * \def NB_PHASES
+ * \brief Number of phases measured by --stats
+ */
+
+#define NB_PHASES 10
+
+/**
+ * \def NB_PERF_COUNTERS
+ * \brief Number of hardware counters read with perf_event_open by --stats: cycles, instructions, branch misses, L1 data cache misses and last level cache misses
+ */
+
+#define NB_PERF_COUNTERS 5
+
+/**
+ * \def BENCH_MIN_SIZE
+ * \brief Size of the smallest file of the benchmark corpus, in bytes
+ */
+
+#define BENCH_MIN_SIZE 1024
+
+/**
+ * \def BENCH_SIZE_FACTOR
+ * \brief Ratio between the sizes of two consecutive files of the benchmark corpus
+ */
+
+#define BENCH_SIZE_FACTOR 16
+
+/**
+ * \def BENCH_DEFAULT_MAX_SIZE
+ * \brief Default size of the biggest file of the benchmark corpus, in MiB. It can go up to 4096 with --max-size
+ */
+
+#define BENCH_DEFAULT_MAX_SIZE 64
+
+/**
+ * \def BENCH_MIN_RUNS
+ * \brief Minimum number of times each phase is measured by the benchmark, the fastest run being kept
+ */
+
+#define BENCH_MIN_RUNS 3
+
+/**
+ * \def BENCH_MIN_TIME
+ * \brief Minimum time, in seconds, spent measuring each phase, so that the fast phases are repeated enough to be timed
+ */
+
+#define BENCH_MIN_TIME 0.1
+
+/**
+ * \def BENCH_MIN_BATCH_TIME
+ * \brief Minimum duration, in seconds, of a measure. The phases faster than that are run several times per measure
+ */
+
+#define BENCH_MIN_BATCH_TIME 0.001
+
+/**
+ * \def BENCH_NB_PHASES
+ * \brief Number of phases measured by the benchmark for each file
+ */
+
+#define BENCH_NB_PHASES 16
+
+/**
+ * \def BENCH_NB_CORPUS_TYPES
+ * \brief Number of kinds of files generated by the benchmark: uniform random bytes, Zipf-skewed text, single-symbol runs and machine code
+ */
+
+#define BENCH_NB_CORPUS_TYPES 4
+
+/**
+ * \def BENCH_SEED
+ * \brief Seed of the pseudo-random generator building the corpus, so that every run compresses the same files
+ */
+
+#define BENCH_SEED 0x9E3779B97F4A7C15ULL
+
 //MACROS
 
 
@@ -60,4 +607,4 @@
 
 
 
-#endif
\ No newline at end of file
+#endif
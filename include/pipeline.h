@@ -0,0 +1,21 @@
+/**
+ * \file pipeline.h
+ * \brief Contains the functions prototypes of pipeline.c
+ * \date 2021
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+void* pipelineReader(void* argument);
+void* pipelineWriter(void* argument);
+void submitPipelineBuffer(Pipeline* pipeline);
+ssize_t readPipeline(void* cookie, char* buffer, size_t size);
+ssize_t writePipeline(void* cookie, const char* buffer, size_t size);
+int seekPipeline(void* cookie, int64_t* offset, int whence);
+int closePipeline(void* cookie);
+FILE* openPipelinedFile(FILE* file, int isWriter, int depth, size_t bufferSize);
+FILE* openOutputFile(const char* fileName, int pipelineDepth, size_t pipelineBufferSize, int* isWrittenByPosition);
+
+
+#endif
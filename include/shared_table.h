@@ -0,0 +1,18 @@
+/**
+ * \file shared_table.h
+ * \brief Contains the functions prototypes of shared_table.c
+ * \date 2021
+ */
+
+#ifndef SHARED_TABLE_H
+#define SHARED_TABLE_H
+
+uint32_t getTableId(unsigned char codeLengths[N_VALUES_IN_BYTE]);
+uint64_t countFileOccurrences(const char* fileName, uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE]);
+uint64_t countSampleOccurrences(const char* path, uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE], int* nbFiles);
+uint64_t createSharedTable(uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE], int maxCodeLength, SharedTable* table);
+void saveSharedTable(SharedTable* table, const char* fileName);
+void loadSharedTable(const char* fileName, SharedTable* table);
+
+
+#endif
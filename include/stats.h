@@ -0,0 +1,26 @@
+/**
+ * \file stats.h
+ * \brief Contains the functions prototypes of stats.c
+ * \date 2021
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <time.h>  // Used for clockid_t
+
+Stats* createStats(int format);
+void freeStats(Stats** stats);
+void openPerfCounters(Stats* stats);
+uint64_t readPerfCounter(int perfDescriptor);
+double getClockTime(clockid_t clock);
+void startPhase(Stats* stats, int phase);
+void endPhase(Stats* stats);
+void setCodeStats(Stats* stats, unsigned char codeLengths[N_VALUES_IN_BYTE], double averageCodeLength);
+const char* getPhaseName(int phase);
+const char* getPerfCounterName(int counter);
+void printStatsSize(FILE* fileOutput, const char* label, uint64_t size, const char* unknown, const char* end);
+void printStats(Stats* stats, FILE* fileOutput);
+
+
+#endif
@@ -0,0 +1,15 @@
+/**
+ * \file stored.h
+ * \brief Contains the functions prototypes of stored.c
+ * \date 2021
+ */
+
+#ifndef STORED_H
+#define STORED_H
+
+int isCompressible(uint64_t originalSize, uint64_t compressedSize);
+uint64_t storedCompression(const unsigned char* input, size_t inputSize, FileHeader* header, FILE* fileOutput);
+void storedDecompression(FILE* fileInput, const InputFile* inputFile, uint64_t offset, uint64_t fileSize, FILE* fileOutput);
+
+
+#endif
@@ -0,0 +1,15 @@
+/**
+ * \file threads.h
+ * \brief Contains the functions prototypes of threads.c
+ * \date 2021
+ */
+
+#ifndef THREADS_H
+#define THREADS_H
+
+pthread_t* startThreads(void* (*function)(void*), void* argument, int nbThreads);
+void joinThreads(pthread_t* threads, int nbThreads);
+int getNumberOfCores();
+
+
+#endif
@@ -7,6 +7,10 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <stdint.h>  // Used for the 64 bits buffers and codes
+#include <pthread.h>  // Used to compress and decompress blocks in parallel
+#include "macros_constants_headers.h"  // Used for the sizes of the arrays
+
 
 /**
  * \struct TreeNode
@@ -15,21 +19,11 @@
 
 typedef struct TreeNode{
     unsigned char c; /*!< Character contained in the node. */
-    int occurrence; /*!< Number of occurrences of the characters in the leaves of the tree (having this node as a root) */
+    uint64_t occurrence; /*!< Number of occurrences of the characters in the leaves of the tree (having this node as a root) */
     struct TreeNode* left; /*!< Pointer to the left node */
     struct TreeNode* right; /*!< Pointer to the right node */
 }TreeNode;
 
-/**
- * \struct ListNode
- * \brief Node of a list containing tree nodes
- */
-
-typedef struct ListNode{
-    TreeNode* element; /*!< The element contained in a node of the list */
-    struct ListNode* next; /*!< Pointer to the next element in the list after this node */
-}ListNode;
-
 /**
  * \struct Buffer
  * \brief Buffer containing characters and its size
@@ -40,4 +34,369 @@ typedef struct Buffer{
     unsigned int size; /*!< Size of the array "content" */
 }Buffer;
 
-#endif
\ No newline at end of file
+/**
+ * \struct HuffmanCode
+ * \brief Huffman code of a character
+ */
+
+typedef struct HuffmanCode{
+    uint64_t code; /*!< Bits of the code. The first bit of the code is the most significant one among the "length" least significant bits */
+    unsigned char length; /*!< Number of bits of the code. 0 if the character doesn't have a code */
+}HuffmanCode;
+
+/**
+ * \struct DecodeTableEntry
+ * \brief Entry of the table used to decode DECODE_TABLE_BITS bits at once
+ */
+
+typedef struct DecodeTableEntry{
+    unsigned char c; /*!< Character decoded from the bits used as an index of this entry */
+    unsigned char length; /*!< Length of the code of c. 0 if the code is longer than DECODE_TABLE_BITS */
+}DecodeTableEntry;
+
+/**
+ * \struct MultiDecodeTableEntry
+ * \brief Entry of the table used to decode several short codes with a single lookup of DECODE_TABLE_BITS bits
+ */
+
+typedef struct MultiDecodeTableEntry{
+    unsigned char symbols[MAX_SYMBOLS_PER_LOOKUP]; /*!< Characters decoded from the bits used as an index of this entry, in order */
+    unsigned char nbSymbols; /*!< Number of characters in symbols. 0 if the first code is longer than DECODE_TABLE_BITS */
+    unsigned char length; /*!< Total length of the codes of the characters in symbols */
+}MultiDecodeTableEntry;
+
+/**
+ * \struct HuffmanDecoder
+ * \brief Tables built from the lengths of the canonical codes to decode them without a tree
+ */
+
+typedef struct HuffmanDecoder{
+    DecodeTableEntry table[DECODE_TABLE_SIZE]; /*!< Gives the character whose code starts the index, when it's not longer than DECODE_TABLE_BITS */
+    int nbCodesOfLength[MAX_CODE_LENGTH+1]; /*!< Number of codes of each length */
+    uint64_t firstCode[MAX_CODE_LENGTH+1]; /*!< First canonical code of each length */
+    uint64_t lastCodeShifted[MAX_CODE_LENGTH+1]; /*!< Last code of each length followed by 1s up to 64 bits, to compare it with the bits read */
+    int firstIndex[MAX_CODE_LENGTH+1]; /*!< Index in sortedChars of the first character whose code has this length */
+    unsigned char sortedChars[N_VALUES_IN_BYTE]; /*!< Characters sorted by the length of their code, and then by their value */
+    int maxLength; /*!< Length of the longest code */
+    MultiDecodeTableEntry multiTable[DECODE_TABLE_SIZE]; /*!< Gives all the characters whose codes fit in the index. Only filled if useMultiTable is 1 */
+    int useMultiTable; /*!< 1 if the codes are short enough for multiTable to decode several characters per lookup, 0 otherwise */
+}HuffmanDecoder;
+
+/**
+ * \struct BitReader
+ * \brief Reads the bits of a file by filling a 64 bits buffer from a bigger buffer of bytes
+ */
+
+typedef struct BitReader{
+    FILE* file; /*!< File from which the bits are read. NULL if the bits are only read from content */
+    unsigned char* content; /*!< Bytes read from the file (or given when there is no file) but not yet added to bits */
+    size_t size; /*!< Number of bytes contained in content */
+    size_t index; /*!< Index of the next byte of content that will be added to bits */
+    uint64_t bits; /*!< Bits that can be read. The next bit is the most significant one */
+    int nbBits; /*!< Number of bits of "bits" that come from the file. It's negative if more bits were read than the file contains */
+}BitReader;
+
+/**
+ * \struct BitWriter
+ * \brief Writes bits in a buffer of bytes by using a 64 bits buffer. The buffer of bytes is written in a file when it's full
+ */
+
+typedef struct BitWriter{
+    FILE* file; /*!< File where content is written when it's full. NULL if the bits are only written in content */
+    unsigned char* content; /*!< Bytes that are written */
+    size_t size; /*!< Size of the array "content" */
+    size_t index; /*!< Index of the next byte of content that will be written */
+    uint64_t nbWrittenBytes; /*!< Number of bytes already written in file */
+    uint64_t bits; /*!< Bits waiting to be written in content. The first one is the most significant bit */
+    int nbBits; /*!< Number of bits in "bits". It's between 0 & 63 */
+}BitWriter;
+
+/**
+ * \struct InputFile
+ * \brief Input file whose whole content can be read in memory, either mapped or read by blocks
+ */
+
+typedef struct InputFile{
+    int fileDescriptor; /*!< File descriptor of the opened file */
+    const unsigned char* content; /*!< Content of the file. NULL if the file is empty */
+    size_t size; /*!< Size of the array "content" */
+    int isMapped; /*!< 1 if content is mapped in memory, 0 if it was read and allocated */
+}InputFile;
+
+/**
+ * \struct FileHeader
+ * \brief Content of the binary header of a compressed file
+ */
+
+typedef struct FileHeader{
+    int type; /*!< FILE_TYPE_SINGLE, FILE_TYPE_BLOCKS, FILE_TYPE_STREAM, FILE_TYPE_TABLE, FILE_TYPE_ADAPTIVE, FILE_TYPE_ARCHIVE, FILE_TYPE_CONTEXT or FILE_TYPE_STORED */
+    int nbBitstreams; /*!< 1, or NB_INTERLEAVED_BITSTREAMS if the compressed data of the file or of its blocks is split in bitstreams */
+    size_t size; /*!< Size of the header in the compressed file. The compressed data starts just after it */
+    uint64_t originalSize; /*!< Size of the original file. It's unknown for the streams and the adaptive files */
+    uint64_t blockSize; /*!< Size of the blocks or of the chunks. It's only used by the files split in blocks and the streams */
+    unsigned char codeLengths[N_VALUES_IN_BYTE]; /*!< Length of the code of each character. It's only used by the files made of a single stream */
+    int nbChars; /*!< Number of characters that have a code */
+    uint64_t tableId; /*!< ID of the shared table used by the files of type FILE_TYPE_TABLE */
+    uint64_t bitstreamSizes[NB_INTERLEAVED_BITSTREAMS]; /*!< Size of each bitstream of the files made of a single stream, the last one being unknown (0) when the header is read */
+}FileHeader;
+
+/**
+ * \struct AdaptiveNode
+ * \brief Node of an adaptive Huffman tree, stored in an array ordered by weight
+ */
+
+typedef struct AdaptiveNode{
+    uint64_t weight; /*!< Number of occurrences of the characters of the subtree */
+    int parent; /*!< Index of the parent, -1 for the root */
+    int children[2]; /*!< Index of the children reached by the bits 0 and 1, -1 for the leaves */
+    int symbol; /*!< Character of a leaf, -1 for the NYT leaf and the internal nodes */
+}AdaptiveNode;
+
+/**
+ * \struct AdaptiveTree
+ * \brief Adaptive Huffman tree (FGK algorithm), updated in the same way by the compression and the decompression after each character. The nodes are numbered by increasing weight (sibling property), the root being the last one
+ */
+
+typedef struct AdaptiveTree{
+    AdaptiveNode nodes[ADAPTIVE_MAX_NODES]; /*!< Nodes of the tree. The nodes are added from the end of the array */
+    int leaves[N_VALUES_IN_BYTE]; /*!< Index of the leaf of each character, -1 if it wasn't seen yet */
+    int nyt; /*!< Index of the NYT leaf, whose code comes before the new characters */
+}AdaptiveTree;
+
+/**
+ * \struct SharedTable
+ * \brief Huffman codes trained on a sample corpus and saved in a table file, so that many small files can be compressed without counting their characters nor saving their codes
+ */
+
+typedef struct SharedTable{
+    uint32_t id; /*!< ID of the table, saved in the header of the files compressed with it */
+    unsigned char codeLengths[N_VALUES_IN_BYTE]; /*!< Length of the code of each character */
+    HuffmanCode codeTable[N_VALUES_IN_BYTE]; /*!< Canonical code of each character */
+    int nbChars; /*!< Number of characters that have a code */
+}SharedTable;
+
+/**
+ * \struct HuffmanContext
+ * \brief Tables kept between the calls of the library functions, so that compressing or decompressing a buffer doesn't allocate memory
+ */
+
+typedef struct HuffmanContext{
+    int maxCodeLength; /*!< Maximum length of the Huffman codes used to compress. It can be changed between two calls */
+    uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE]; /*!< Number of occurrences of each character of the last compressed buffer */
+    uint64_t bitstreamOccurrences[NB_INTERLEAVED_BITSTREAMS][N_VALUES_IN_BYTE]; /*!< Number of occurrences of each character in each bitstream of the last compressed buffer */
+    HuffmanCode codeTable[N_VALUES_IN_BYTE]; /*!< Codes of the last compressed buffer */
+    FileHeader header; /*!< Header of the last compressed or decompressed buffer */
+    unsigned char headerBuffer[FILE_HEADER_MAX_SIZE]; /*!< Binary header of the last compressed buffer */
+    HuffmanDecoder decoder; /*!< Decoder of the last decompressed buffer */
+    unsigned char decoderCodeLengths[N_VALUES_IN_BYTE]; /*!< Length of the codes used to create the decoder. It's reused if the next buffer has the same lengths */
+    int hasDecoder; /*!< 1 if the decoder was created, 0 otherwise */
+}HuffmanContext;
+
+/**
+ * \struct ContextModel
+ * \brief Code tables of the order-1 mode. Each character that is followed by another one is a context, linked to the table giving the codes of the characters after it. Similar contexts share a table
+ */
+
+typedef struct ContextModel{
+    int nbTables; /*!< Number of tables, between 1 and N_VALUES_IN_BYTE */
+    unsigned char isUsedContext[N_VALUES_IN_BYTE]; /*!< 1 if the character is followed by another one, 0 otherwise */
+    unsigned char tableOfContext[N_VALUES_IN_BYTE]; /*!< Index of the table used after each character. 0 for the contexts that are not used */
+    unsigned char codeLengths[N_VALUES_IN_BYTE][N_VALUES_IN_BYTE]; /*!< Length of the codes of each table */
+}ContextModel;
+
+/**
+ * \struct BenchmarkData
+ * \brief File of the benchmark corpus and the results of each phase, given as input to the next phase
+ */
+
+typedef struct BenchmarkData{
+    const unsigned char* input; /*!< Content of the file */
+    size_t size; /*!< Size of the file */
+    uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE]; /*!< Occurrences of each character */
+    unsigned char codeLengths[N_VALUES_IN_BYTE]; /*!< Length of the code of each character */
+    HuffmanCode codeTable[N_VALUES_IN_BYTE]; /*!< Canonical code of each character */
+    unsigned char headerBuffer[FILE_HEADER_MAX_SIZE]; /*!< Header of the compressed file */
+    int headerSize; /*!< Size of the header */
+    FileHeader header; /*!< Header read from headerBuffer */
+    unsigned char* payload; /*!< Encoded content */
+    size_t payloadSize; /*!< Size of the encoded content */
+    unsigned char* interleavedPayload; /*!< Encoded content split in NB_INTERLEAVED_BITSTREAMS bitstreams */
+    size_t interleavedPayloadSize; /*!< Size of the bitstreams */
+    uint64_t bitstreamSizes[NB_INTERLEAVED_BITSTREAMS]; /*!< Size of each bitstream */
+    HuffmanDecoder decoder; /*!< Decoding tables built from the code lengths */
+    unsigned char* output; /*!< Decoded content, or decompressed file for the end-to-end phases */
+    unsigned char* compressed; /*!< File compressed by the library */
+    size_t compressedSize; /*!< Size of the file compressed by the library */
+    HuffmanContext* context; /*!< Context used by the library functions */
+    AdaptiveTree adaptiveTree; /*!< Tree of the adaptive codes, rebuilt by each adaptive phase */
+    unsigned char* adaptivePayload; /*!< Content encoded with adaptive codes */
+    size_t adaptivePayloadCapacity; /*!< Size of the array adaptivePayload */
+    size_t adaptivePayloadSize; /*!< Size of the content encoded with adaptive codes */
+    uint64_t* contextOccurrences; /*!< Occurrences of each character after each character, N_VALUES_IN_BYTE per character */
+    ContextModel contextModel; /*!< Code tables of the order-1 mode */
+    uint64_t contextEncodedBits; /*!< Number of bits of the content encoded with the order-1 codes */
+    int contextHeaderSize; /*!< Size of the header of the order-1 mode, followed by its context section */
+    unsigned char* contextPayload; /*!< Content encoded with the order-1 codes */
+    size_t contextPayloadSize; /*!< Size of the content encoded with the order-1 codes */
+}BenchmarkData;
+
+/**
+ * \struct PhaseStats
+ * \brief Resources used by a phase of the compression or the decompression, summed over all the times it was run
+ */
+
+typedef struct PhaseStats{
+    int nbRuns; /*!< Number of times the phase was run, 0 if it wasn't */
+    double wallTime; /*!< Elapsed time, in seconds */
+    double cpuTime; /*!< Processor time of all the threads, in seconds */
+    long minorFaults; /*!< Page faults resolved without reading the disk */
+    long majorFaults; /*!< Page faults that read the disk */
+    uint64_t counters[NB_PERF_COUNTERS]; /*!< Values of the hardware counters */
+}PhaseStats;
+
+/**
+ * \struct Stats
+ * \brief Statistics displayed by --stats. Nothing is measured when the option isn't given, since the stats are then NULL
+ */
+
+typedef struct Stats{
+    int format; /*!< STATS_TEXT or STATS_JSON */
+    PhaseStats phases[NB_PHASES]; /*!< Resources used by each phase */
+    int currentPhase; /*!< Phase being measured, -1 if there is none */
+    double startWallTime; /*!< Elapsed time when the current phase started */
+    double startCpuTime; /*!< Processor time when the current phase started */
+    long startMinorFaults; /*!< Minor page faults when the current phase started */
+    long startMajorFaults; /*!< Major page faults when the current phase started */
+    uint64_t startCounters[NB_PERF_COUNTERS]; /*!< Hardware counters when the current phase started */
+    int perfDescriptors[NB_PERF_COUNTERS]; /*!< File descriptors of the hardware counters, -1 if a counter isn't available */
+    uint64_t bytesRead; /*!< Size of the input file, UINT64_MAX if unknown */
+    uint64_t bytesWritten; /*!< Size of the output file, UINT64_MAX if unknown (when a pipe is written) */
+    int headerSize; /*!< Size of the header of the compressed file, 0 if unknown */
+    int nbChars; /*!< Number of different characters, 0 if unknown */
+    int maxCodeLength; /*!< Length of the longest code, 0 if unknown */
+    double averageCodeLength; /*!< Average number of bits per character, negative if unknown */
+}Stats;
+
+/**
+ * \struct CompressedBlock
+ * \brief Block of the original file compressed separately, with its header and the length of its codes
+ */
+
+typedef struct CompressedBlock{
+    unsigned char* content; /*!< Compressed block, as it's written in the compressed file. It has to be dynamically allocated */
+    size_t size; /*!< Size of the array "content" */
+    int originalSize; /*!< Size of the block in the original file */
+    uint64_t addedBits; /*!< Number of bits added to the block by the limit of the length of the codes */
+    int done; /*!< 1 when the block is compressed, 0 otherwise */
+}CompressedBlock;
+
+/**
+ * \struct BlockCompressionJob
+ * \brief Data shared by the threads compressing the blocks of a file and the thread writing them in the compressed file
+ */
+
+typedef struct BlockCompressionJob{
+    const unsigned char* input; /*!< Content of the original file */
+    uint64_t fileSize; /*!< Size of the original file */
+    int blockSize; /*!< Size of the blocks, in bytes. Only the last block can be smaller */
+    int nbBlocks; /*!< Number of blocks in the file */
+    CompressedBlock* blocks; /*!< Array containing the blocks */
+    int nextBlock; /*!< Index of the next block that will be compressed */
+    int nbWrittenBlocks; /*!< Number of blocks already written in the compressed file and freed */
+    int maxBlocksInMemory; /*!< Maximum number of blocks compressed but not yet written, to limit the memory used */
+    int maxCodeLength; /*!< Maximum length of the Huffman codes */
+    int nbBitstreams; /*!< Number of bitstreams of each block */
+    pthread_mutex_t mutex; /*!< Protects all the fields above that are modified */
+    pthread_cond_t blockDone; /*!< Signaled when a block is compressed */
+    pthread_cond_t blockWritten; /*!< Signaled when a block is written */
+}BlockCompressionJob;
+
+/**
+ * \struct BlockDecompressionJob
+ * \brief Data shared by the threads decompressing the blocks of a file by using its index
+ */
+
+typedef struct BlockDecompressionJob{
+    const unsigned char* input; /*!< Content of the compressed file */
+    int outputDescriptor; /*!< File descriptor of the decompressed file, written with pwrite by each thread */
+    int blockSize; /*!< Maximum size of the decompressed blocks */
+    int nbBitstreams; /*!< Number of bitstreams of each block */
+    uint32_t nbBlocks; /*!< Number of blocks in the file */
+    uint64_t* blockOffsets; /*!< Position of each block in the compressed file */
+    uint32_t* compressedSizes; /*!< Size of each compressed block */
+    uint32_t* originalSizes; /*!< Size of each decompressed block */
+    uint64_t* outputOffsets; /*!< Position of each decompressed block in the decompressed file */
+    uint32_t nextBlock; /*!< Index of the next block that will be decompressed */
+    pthread_mutex_t mutex; /*!< Protects nextBlock */
+}BlockDecompressionJob;
+
+/**
+ * \struct ArchiveMember
+ * \brief File of an archive, saved in its central directory
+ */
+
+typedef struct ArchiveMember{
+    char* name; /*!< Path of the file relative to the archived directory, with '/' between the directories */
+    uint64_t originalSize; /*!< Size of the file */
+    uint64_t offset; /*!< Position of the compressed file in the archive */
+    uint64_t compressedSize; /*!< Size of the compressed file, 0 if the file is empty */
+    unsigned char* content; /*!< Compressed file waiting to be written in the archive, NULL otherwise */
+    int done; /*!< 1 when the file is compressed, 0 otherwise */
+}ArchiveMember;
+
+/**
+ * \struct ArchiveCompressionJob
+ * \brief Data shared by the threads compressing the files of a directory and the thread writing them in the archive
+ */
+
+typedef struct ArchiveCompressionJob{
+    const char* directoryName; /*!< Name of the archived directory */
+    ArchiveMember* members; /*!< Files of the directory */
+    int nbMembers; /*!< Number of files */
+    int nextMember; /*!< Index of the next file that will be compressed */
+    int nbWrittenMembers; /*!< Number of files already written in the archive and freed */
+    int maxMembersInMemory; /*!< Maximum number of files compressed but not yet written, to limit the memory used */
+    int maxCodeLength; /*!< Maximum length of the Huffman codes */
+    pthread_mutex_t mutex; /*!< Protects all the fields above that are modified */
+    pthread_cond_t memberDone; /*!< Signaled when a file is compressed */
+    pthread_cond_t memberWritten; /*!< Signaled when a file is written */
+}ArchiveCompressionJob;
+
+/**
+ * \struct ArchiveExtractionJob
+ * \brief Data shared by the threads extracting the files of an archive
+ */
+
+typedef struct ArchiveExtractionJob{
+    const unsigned char* input; /*!< Content of the archive */
+    const char* directoryName; /*!< Name of the directory where the files are extracted */
+    ArchiveMember* members; /*!< Files of the archive, read from its central directory */
+    int nbMembers; /*!< Number of files */
+    int nextMember; /*!< Index of the next file that will be extracted */
+    pthread_mutex_t mutex; /*!< Protects nextMember */
+}ArchiveExtractionJob;
+
+/**
+ * \struct Pipeline
+ * \brief Ring of buffers between the coding and a thread that reads or writes a file, so that waiting for the file doesn't stop the coding
+ */
+
+typedef struct Pipeline{
+    FILE* file; /*!< File read or written by the thread */
+    int isWriter; /*!< 1 if the thread writes the buffers filled by the coding, 0 if it fills them by reading the file */
+    unsigned char* content; /*!< The depth buffers of bufferSize bytes, one after the other */
+    size_t* sizes; /*!< Number of bytes in each full buffer */
+    int depth; /*!< Number of buffers */
+    size_t bufferSize; /*!< Size of each buffer */
+    int first; /*!< Index of the oldest full buffer: the next one written by the thread, or the one read by the coding */
+    int nbFullBuffers; /*!< Number of full buffers from first. The next buffer is the one filled by the coding, or by the thread */
+    int current; /*!< Index of the buffer filled by the coding, only used when it writes */
+    size_t position; /*!< Position of the coding in its buffer */
+    uint64_t nbBytes; /*!< Number of bytes given to or by the coding, returned by ftell */
+    int isEnded; /*!< 1 when the thread read the end of the file, when the coding has nothing left to write or when it stops reading */
+    pthread_t thread; /*!< Thread reading or writing the file */
+    pthread_mutex_t mutex; /*!< Protects first, nbFullBuffers, sizes and isEnded */
+    pthread_cond_t changed; /*!< Signaled when a buffer is filled or emptied, or when the pipeline ends */
+}Pipeline;
+
+#endif
@@ -0,0 +1,320 @@
+/**
+ * \file adaptive.c
+ * \brief Contains functions used to compress and decompress a file in one pass with adaptive Huffman codes (FGK algorithm): the tree is updated after each character in the same way by the compression and the decompression, so it's never saved
+ * \date 2021
+ */
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/file_functions.h"
+#include "../include/header.h"
+#include "../include/compression.h"
+#include "../include/decompression.h"
+#include "../include/adaptive.h"
+
+/**
+ * \fn void initializeAdaptiveTree(AdaptiveTree* tree)
+ * \brief Initializes an adaptive Huffman tree containing only the NYT leaf, which is the root
+ * \param tree Tree that is initialized
+ */
+
+void initializeAdaptiveTree(AdaptiveTree* tree)
+{
+    tree->nyt=ADAPTIVE_MAX_NODES-1;
+    tree->nodes[tree->nyt].weight=0;
+    tree->nodes[tree->nyt].parent=-1;
+    tree->nodes[tree->nyt].children[0]=-1;
+    tree->nodes[tree->nyt].children[1]=-1;
+    tree->nodes[tree->nyt].symbol=-1;
+    for(int i=0; i<N_VALUES_IN_BYTE; i++)
+        tree->leaves[i]=-1;
+}
+
+/**
+ * \fn void linkAdaptiveNode(AdaptiveTree* tree, int index)
+ * \brief Updates the links to a node that was moved: the parent of its children, or the index of its leaf
+ * \param tree Adaptive Huffman tree
+ * \param index New index of the node
+ */
+
+void linkAdaptiveNode(AdaptiveTree* tree, int index)
+{
+    AdaptiveNode* node=&tree->nodes[index];
+
+    if(node->children[0]>=0){
+        tree->nodes[node->children[0]].parent=index;
+        tree->nodes[node->children[1]].parent=index;
+    }
+    else if(node->symbol>=0)
+        tree->leaves[node->symbol]=index;
+    else
+        tree->nyt=index;
+}
+
+/**
+ * \fn void swapAdaptiveNodes(AdaptiveTree* tree, int first, int second)
+ * \brief Swaps two subtrees of the same weight. Each one takes the place of the other one in the array and under its parent
+ * \param tree Adaptive Huffman tree
+ * \param first Index of the first subtree
+ * \param second Index of the second subtree. It must not be an ancestor of the first one
+ */
+
+void swapAdaptiveNodes(AdaptiveTree* tree, int first, int second)
+{
+    AdaptiveNode node=tree->nodes[first];
+
+    tree->nodes[first]=tree->nodes[second];
+    tree->nodes[first].parent=node.parent; // The parents don't move
+    node.parent=tree->nodes[second].parent;
+    tree->nodes[second]=node;
+    linkAdaptiveNode(tree, first);
+    linkAdaptiveNode(tree, second);
+}
+
+/**
+ * \fn void updateAdaptiveTree(AdaptiveTree* tree, int symbol)
+ * \brief Adds an occurrence of a character to the tree. A new character splits the NYT leaf into a new NYT leaf and its own leaf. Then from its leaf to the root, each node is swapped with the last node of the same weight (unless it's its parent) before its weight is incremented, so that the nodes stay ordered by weight (sibling property)
+ * \param tree Adaptive Huffman tree
+ * \param symbol Character that was encoded or decoded
+ */
+
+void updateAdaptiveTree(AdaptiveTree* tree, int symbol)
+{
+    AdaptiveNode* nodes=tree->nodes;
+    int node=tree->leaves[symbol];
+    int leader=0;
+
+    if(node<0){ // The NYT leaf becomes the parent of the new NYT leaf and of the leaf of the character
+        node=tree->nyt;
+        nodes[node].children[0]=node-2;
+        nodes[node].children[1]=node-1;
+        nodes[node-1].weight=0;
+        nodes[node-1].parent=node;
+        nodes[node-1].children[0]=-1;
+        nodes[node-1].children[1]=-1;
+        nodes[node-1].symbol=symbol;
+        nodes[node-2]=nodes[node-1];
+        nodes[node-2].symbol=-1;
+        tree->leaves[symbol]=node-1;
+        tree->nyt=node-2;
+        node--;
+    }
+    while(node>=0){
+        leader=node;
+        while(leader+1<ADAPTIVE_MAX_NODES && nodes[leader+1].weight==nodes[node].weight)
+            leader++;
+        if(leader!=node && leader!=nodes[node].parent){
+            swapAdaptiveNodes(tree, node, leader);
+            node=leader;
+        }
+        nodes[node].weight++;
+        node=nodes[node].parent;
+    }
+}
+
+/**
+ * \fn void writeAdaptiveCode(AdaptiveTree* tree, int node, BitWriter* writer)
+ * \brief Writes the current code of a leaf: the path from the root to the leaf, 0 for the first child and 1 for the second one
+ * \param tree Adaptive Huffman tree
+ * \param node Index of the leaf
+ * \param writer Bit writer where the code is written
+ */
+
+void writeAdaptiveCode(AdaptiveTree* tree, int node, BitWriter* writer)
+{
+    unsigned char path[ADAPTIVE_MAX_NODES]; // Bits from the leaf to the root
+    int length=0;
+    uint64_t value=0;
+    int nbBits=0;
+
+    while(tree->nodes[node].parent>=0){
+        path[length]=(tree->nodes[tree->nodes[node].parent].children[1]==node);
+        length++;
+        node=tree->nodes[node].parent;
+    }
+    for(int i=length-1; i>=0; i--){ // The code can be longer than what writeBits accepts
+        value=(value<<1)|path[i];
+        nbBits++;
+        if(nbBits==MAX_CODE_LENGTH){
+            writeBits(writer, value, nbBits);
+            value=0;
+            nbBits=0;
+        }
+    }
+    if(nbBits>0)
+        writeBits(writer, value, nbBits);
+}
+
+/**
+ * \fn void encodeAdaptive(AdaptiveTree* tree, BitWriter* writer, const unsigned char* input, size_t inputSize)
+ * \brief Writes the adaptive code of each character of input, updating the tree after each one. A character that wasn't seen yet is written as the code of the NYT leaf followed by its value on ADAPTIVE_SYMBOL_BITS bits
+ * \param tree Adaptive Huffman tree, kept from the previous part of the file
+ * \param writer Bit writer where the codes are written
+ * \param input Characters that are encoded
+ * \param inputSize Number of characters in input
+ */
+
+void encodeAdaptive(AdaptiveTree* tree, BitWriter* writer, const unsigned char* input, size_t inputSize)
+{
+    for(size_t i=0; i<inputSize; i++){
+        if(tree->leaves[input[i]]>=0)
+            writeAdaptiveCode(tree, tree->leaves[input[i]], writer);
+        else{
+            writeAdaptiveCode(tree, tree->nyt, writer);
+            writeBits(writer, input[i], ADAPTIVE_SYMBOL_BITS);
+        }
+        updateAdaptiveTree(tree, input[i]);
+    }
+}
+
+/**
+ * \fn void endAdaptiveCodes(AdaptiveTree* tree, BitWriter* writer)
+ * \brief Writes the end marker after the adaptive codes (the code of the NYT leaf followed by ADAPTIVE_END_OF_DATA) and flushes the writer
+ * \param tree Adaptive Huffman tree
+ * \param writer Bit writer where the codes are written
+ */
+
+void endAdaptiveCodes(AdaptiveTree* tree, BitWriter* writer)
+{
+    writeAdaptiveCode(tree, tree->nyt, writer);
+    writeBits(writer, ADAPTIVE_END_OF_DATA, ADAPTIVE_SYMBOL_BITS);
+    flushBitWriter(writer);
+}
+
+/**
+ * \fn int decodeAdaptive(AdaptiveTree* tree, BitReader* reader, unsigned char* output, size_t outputSize, size_t* nbDecodedChars)
+ * \brief Decodes adaptive codes by walking in the tree bit by bit from the root, updating the tree after each character like encodeAdaptive
+ * \param tree Adaptive Huffman tree, kept from the previous part of the file
+ * \param reader Bit reader from which the codes are read
+ * \param output Buffer where the decoded characters are written
+ * \param outputSize Maximum number of characters decoded
+ * \param nbDecodedChars Receives the number of characters written in output
+ * \return 1 if the end marker was read, 0 if output is full, -1 if the compressed data is incorrect or truncated
+ */
+
+int decodeAdaptive(AdaptiveTree* tree, BitReader* reader, unsigned char* output, size_t outputSize, size_t* nbDecodedChars)
+{
+    int node=0;
+    int symbol=0;
+    size_t i=0;
+
+    for(i=0; i<outputSize; i++){
+        node=ADAPTIVE_MAX_NODES-1;
+        while(tree->nodes[node].children[0]>=0){
+            if(reader->nbBits<=0){
+                fillBitReader(reader);
+                if(reader->nbBits<=0)
+                    return -1;
+            }
+            node=tree->nodes[node].children[reader->bits>>63];
+            reader->bits<<=1;
+            reader->nbBits--;
+        }
+        if(node==tree->nyt){ // A new character or the end marker
+            if(reader->nbBits<ADAPTIVE_SYMBOL_BITS){
+                fillBitReader(reader);
+                if(reader->nbBits<ADAPTIVE_SYMBOL_BITS)
+                    return -1;
+            }
+            symbol=reader->bits>>(64-ADAPTIVE_SYMBOL_BITS);
+            reader->bits<<=ADAPTIVE_SYMBOL_BITS;
+            reader->nbBits-=ADAPTIVE_SYMBOL_BITS;
+            if(symbol==ADAPTIVE_END_OF_DATA){
+                *nbDecodedChars=i;
+                return 1;
+            }
+            if(symbol>ADAPTIVE_END_OF_DATA)
+                return -1;
+        }
+        else
+            symbol=tree->nodes[node].symbol;
+        output[i]=symbol;
+        updateAdaptiveTree(tree, symbol);
+    }
+    *nbDecodedChars=i;
+    return 0;
+}
+
+/**
+ * \fn uint64_t adaptiveCompression(FILE* fileInput, FILE* fileOutput, uint64_t* originalSize)
+ * \brief Compresses a file or a stream in one pass with adaptive Huffman codes: each character is read once, and nothing but the binary header is written before the codes
+ * \param fileInput File or stream that is compressed. It's read by blocks until its end
+ * \param fileOutput File where is written the compressed version of fileInput
+ * \param originalSize Receives the number of bytes read from fileInput
+ * \return The number of bytes written in fileOutput
+ */
+
+uint64_t adaptiveCompression(FILE* fileInput, FILE* fileOutput, uint64_t* originalSize)
+{
+    AdaptiveTree* tree=NULL;
+    BitWriter writer;
+    FileHeader header;
+    unsigned char* input=NULL;
+    unsigned char* outputBuffer=NULL;
+    size_t inputSize=0;
+
+    MALLOC(tree, AdaptiveTree, 1);
+    MALLOC(input, unsigned char, IO_BUFFER_SIZE);
+    MALLOC(outputBuffer, unsigned char, IO_BUFFER_SIZE);
+    header.type=FILE_TYPE_ADAPTIVE;
+    header.nbBitstreams=1;
+    saveFileHeader(&header, fileOutput);
+    initializeAdaptiveTree(tree);
+    initializeBitWriter(&writer, fileOutput, outputBuffer, IO_BUFFER_SIZE);
+    *originalSize=0;
+
+    while((inputSize=fread(input, 1, IO_BUFFER_SIZE, fileInput))>0){
+        encodeAdaptive(tree, &writer, input, inputSize);
+        *originalSize+=inputSize;
+    }
+    if(ferror(fileInput)){
+        fprintf(stderr, "ERROR: fread can't read the input file in adaptiveCompression\n");
+        exit(EXIT_FAILURE);
+    }
+    endAdaptiveCodes(tree, &writer);
+
+    free(outputBuffer);
+    free(input);
+    free(tree);
+    return header.size+writer.nbWrittenBytes;
+}
+
+/**
+ * \fn uint64_t adaptiveDecompression(FILE* fileInput, const unsigned char* input, size_t inputSize, FILE* fileOutput)
+ * \brief Decompresses a file compressed by adaptiveCompression, until its end marker
+ * \param fileInput Compressed file, read by blocks from its current position, just after the header. If it's NULL then input is used instead
+ * \param input Compressed data, after the header of the compressed file. It's only used if fileInput is NULL
+ * \param inputSize Size of input
+ * \param fileOutput File where is written the decompressed version of the file
+ * \return The number of bytes written in fileOutput
+ */
+
+uint64_t adaptiveDecompression(FILE* fileInput, const unsigned char* input, size_t inputSize, FILE* fileOutput)
+{
+    AdaptiveTree* tree=NULL;
+    BitReader reader;
+    unsigned char* outputBuffer=NULL;
+    size_t nbChars=0;
+    uint64_t outputSize=0;
+    int status=0;
+
+    MALLOC(tree, AdaptiveTree, 1);
+    MALLOC(outputBuffer, unsigned char, IO_BUFFER_SIZE);
+    initializeAdaptiveTree(tree);
+    initializeBitReader(&reader, fileInput, input, inputSize);
+
+    while(status==0){
+        status=decodeAdaptive(tree, &reader, outputBuffer, IO_BUFFER_SIZE, &nbChars);
+        if(status<0){
+            fprintf(stderr, "ERROR: the compressed data is incorrect or truncated\n");
+            exit(EXIT_FAILURE);
+        }
+        fwriteAndCheck(outputBuffer, nbChars, fileOutput);
+        outputSize+=nbChars;
+    }
+
+    freeBitReader(&reader);
+    free(outputBuffer);
+    free(tree);
+    return outputSize;
+}
@@ -0,0 +1,583 @@
+/**
+ * \file archive.c
+ * \brief Contains functions used to compress all the files of a directory in parallel in a single archive, and to extract all of them or only one of them by using its central directory
+ * \date 2021
+ */
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/file_functions.h"
+#include "../include/header.h"
+#include "../include/threads.h"
+#include "../include/library.h"
+#include "../include/archive.h"
+#include <dirent.h>  // Used for opendir and readdir
+#include <fcntl.h>  // Used for open
+#include <unistd.h>  // Used for read and close
+#include <sys/stat.h>  // Used for stat and mkdir
+#include <errno.h>  // Used to check why mkdir failed
+
+/**
+ * \fn char* joinPath(const char* directoryName, const char* fileName)
+ * \brief Gives the path of a file contained in a directory
+ * \param directoryName Name of the directory, or an empty string for the current directory
+ * \param fileName Name of the file in the directory
+ * \return The path of the file, which has to be freed
+ */
+
+char* joinPath(const char* directoryName, const char* fileName)
+{
+    char* path=NULL;
+
+    MALLOC(path, char, strlen(directoryName)+strlen(fileName)+2);
+    if(directoryName[0]=='\0')
+        strcpy(path, fileName);
+    else
+        sprintf(path, "%s/%s", directoryName, fileName);
+    return path;
+}
+
+/**
+ * \fn void addDirectoryFiles(const char* directoryName, const char* relativeName, ArchiveMember** members, int* nbMembers, int* nbAllocatedMembers)
+ * \brief Adds the regular files of a directory and of its sub-directories to the files of an archive
+ * \param directoryName Name of the archived directory
+ * \param relativeName Path of the directory that is read, relative to directoryName (an empty string for directoryName itself)
+ * \param members Array of files, reallocated when it's full
+ * \param nbMembers Number of files in the array
+ * \param nbAllocatedMembers Size of the array
+ */
+
+void addDirectoryFiles(const char* directoryName, const char* relativeName, ArchiveMember** members, int* nbMembers, int* nbAllocatedMembers)
+{
+    struct stat fileStat;
+    DIR* directory=NULL;
+    struct dirent* entry=NULL;
+    char* path=joinPath(directoryName, relativeName);
+    char* name=NULL;
+    char* fileName=NULL;
+
+    directory=opendir(path);
+    if(directory==NULL){
+        fprintf(stderr, "ERROR: the directory %s can't be opened\n", path);
+        exit(EXIT_FAILURE);
+    }
+    while((entry=readdir(directory))!=NULL){
+        if(!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
+            continue;
+        name=joinPath(relativeName, entry->d_name);
+        fileName=joinPath(directoryName, name);
+        if(stat(fileName, &fileStat)!=0){
+            fprintf(stderr, "ERROR: the file %s can't be read\n", fileName);
+            exit(EXIT_FAILURE);
+        }
+        if(S_ISDIR(fileStat.st_mode)){
+            addDirectoryFiles(directoryName, name, members, nbMembers, nbAllocatedMembers);
+            free(name);
+        }
+        else if(S_ISREG(fileStat.st_mode)){
+            if(*nbMembers==*nbAllocatedMembers){
+                *nbAllocatedMembers*=2;
+                REALLOC(*members, ArchiveMember, *nbAllocatedMembers);
+            }
+            (*members)[*nbMembers].name=name;
+            (*members)[*nbMembers].originalSize=fileStat.st_size;
+            (*members)[*nbMembers].compressedSize=0;
+            (*members)[*nbMembers].content=NULL;
+            (*members)[*nbMembers].done=0;
+            (*nbMembers)++;
+        }
+        else
+            free(name);
+        free(fileName);
+    }
+    closedir(directory);
+    free(path);
+}
+
+/**
+ * \fn int compareArchiveMembers(const void* first, const void* second)
+ * \brief Compares the names of two files of an archive, used by qsort so that the same directory always gives the same archive
+ * \param first First file
+ * \param second Second file
+ * \return A negative number, 0 or a positive number if the name of first is before, equal to or after the name of second
+ */
+
+int compareArchiveMembers(const void* first, const void* second)
+{
+    return strcmp(((const ArchiveMember*) first)->name, ((const ArchiveMember*) second)->name);
+}
+
+/**
+ * \fn ArchiveMember* listArchiveMembers(const char* directoryName, int* nbMembers, uint64_t* originalSize)
+ * \brief Lists the regular files of a directory and of its sub-directories, sorted by name
+ * \param directoryName Name of the directory
+ * \param nbMembers Receives the number of files
+ * \param originalSize Receives the size of all the files
+ * \return The array of files, freed by freeArchiveMembers
+ */
+
+ArchiveMember* listArchiveMembers(const char* directoryName, int* nbMembers, uint64_t* originalSize)
+{
+    ArchiveMember* members=NULL;
+    int nbAllocatedMembers=64;
+
+    MALLOC(members, ArchiveMember, nbAllocatedMembers);
+    *nbMembers=0;
+    addDirectoryFiles(directoryName, "", &members, nbMembers, &nbAllocatedMembers);
+    qsort(members, *nbMembers, sizeof(ArchiveMember), compareArchiveMembers);
+    *originalSize=0;
+    for(int i=0; i<*nbMembers; i++)
+        *originalSize+=members[i].originalSize;
+    return members;
+}
+
+/**
+ * \fn void freeArchiveMembers(ArchiveMember** members, int nbMembers)
+ * \brief Frees the files of an archive and their names
+ * \param members Array of files
+ * \param nbMembers Number of files in the array
+ */
+
+void freeArchiveMembers(ArchiveMember** members, int nbMembers)
+{
+    for(int i=0; i<nbMembers; i++){
+        free((*members)[i].name);
+        free((*members)[i].content);
+    }
+    free(*members);
+    *members=NULL;
+}
+
+/**
+ * \fn size_t readWholeFile(const char* fileName, unsigned char** buffer, size_t* bufferSize)
+ * \brief Reads a whole file with read() in a buffer kept between the calls. Small files are read faster than by mapping them
+ * \param fileName Name of the file
+ * \param buffer Buffer where the file is read, reallocated when it's too small
+ * \param bufferSize Size of the buffer
+ * \return The size of the file
+ */
+
+size_t readWholeFile(const char* fileName, unsigned char** buffer, size_t* bufferSize)
+{
+    int fileDescriptor=open(fileName, O_RDONLY);
+    ssize_t nbReadBytes=0;
+    size_t size=0;
+
+    if(fileDescriptor<0){
+        fprintf(stderr, "ERROR: the file %s can't be opened\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    while((nbReadBytes=read(fileDescriptor, *buffer+size, *bufferSize-size))!=0){
+        if(nbReadBytes<0){
+            fprintf(stderr, "ERROR: read can't read the file %s\n", fileName);
+            exit(EXIT_FAILURE);
+        }
+        size+=nbReadBytes;
+        if(size==*bufferSize){
+            *bufferSize*=2;
+            REALLOC(*buffer, unsigned char, *bufferSize);
+        }
+    }
+    close(fileDescriptor);
+    return size;
+}
+
+/**
+ * \fn void* archiveCompressionWorker(void* argument)
+ * \brief Function run by each thread compressing the files of an archive. Each thread compresses the next file that is not compressed yet with its own library context, until all of them are compressed
+ * \param argument Pointer to the ArchiveCompressionJob shared by the threads
+ * \return NULL
+ */
+
+void* archiveCompressionWorker(void* argument)
+{
+    ArchiveCompressionJob* job=(ArchiveCompressionJob*) argument;
+    HuffmanContext* context=createHuffmanContext();
+    ArchiveMember* member=NULL;
+    unsigned char* input=NULL;
+    size_t inputBufferSize=IO_BUFFER_SIZE;
+    size_t inputSize=0;
+    unsigned char* content=NULL;
+    size_t compressedSize=0;
+    char* fileName=NULL;
+
+    context->maxCodeLength=job->maxCodeLength;
+    MALLOC(input, unsigned char, inputBufferSize);
+    pthread_mutex_lock(&job->mutex);
+    while(job->nextMember<job->nbMembers){
+        if(job->nextMember>=job->nbWrittenMembers+job->maxMembersInMemory){ // Too many files are waiting to be written
+            pthread_cond_wait(&job->memberWritten, &job->mutex);
+            continue;
+        }
+        member=&job->members[job->nextMember];
+        job->nextMember++;
+        pthread_mutex_unlock(&job->mutex);
+
+        fileName=joinPath(job->directoryName, member->name);
+        inputSize=readWholeFile(fileName, &input, &inputBufferSize);
+        free(fileName);
+        content=NULL;
+        compressedSize=0;
+        if(inputSize>0){ // Nothing is saved for the empty files
+            MALLOC(content, unsigned char, huffmanCompressBound(inputSize));
+            compressedSize=huffmanCompressWithContext(context, input, inputSize, content, huffmanCompressBound(inputSize));
+            if(compressedSize==0){
+                fprintf(stderr, "ERROR: the file %s can't be compressed\n", member->name);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        pthread_mutex_lock(&job->mutex);
+        member->originalSize=inputSize; // The file may have changed since it was listed
+        member->compressedSize=compressedSize;
+        member->content=content;
+        member->done=1;
+        pthread_cond_broadcast(&job->memberDone);
+    }
+    pthread_mutex_unlock(&job->mutex);
+    free(input);
+    freeHuffmanContext(&context);
+    return NULL;
+}
+
+/**
+ * \fn uint64_t archiveCompression(const char* directoryName, ArchiveMember* members, int nbMembers, FILE* fileOutput, int nbThreads, int maxCodeLength)
+ * \brief Compresses the files of a directory in parallel and writes them in an archive: the header, the compressed files in the order of members, their central directory (for each file: the length of its name, its name, its original size, its position and its compressed size, saved as varints) and the trailer giving the position of the central directory
+ * \param directoryName Name of the archived directory
+ * \param members Files of the directory, given by listArchiveMembers
+ * \param nbMembers Number of files
+ * \param fileOutput File where the archive is written
+ * \param nbThreads Number of threads compressing the files
+ * \param maxCodeLength Maximum length of the Huffman codes
+ * \return The size of the archive
+ */
+
+uint64_t archiveCompression(const char* directoryName, ArchiveMember* members, int nbMembers, FILE* fileOutput, int nbThreads, int maxCodeLength)
+{
+    ArchiveCompressionJob job;
+    pthread_t* threads=NULL;
+    unsigned char* centralDirectory=NULL;
+    size_t directorySize=0;
+    size_t nameLength=0;
+    unsigned char buffer[TRAILER_SIZE];
+    uint64_t offset=0; // position in fileOutput
+    FileHeader header;
+
+    job.directoryName=directoryName;
+    job.members=members;
+    job.nbMembers=nbMembers;
+    job.nextMember=0;
+    job.nbWrittenMembers=0;
+    job.maxMembersInMemory=16*nbThreads; // The files are often small, so more of them are kept than blocks
+    job.maxCodeLength=maxCodeLength;
+    pthread_mutex_init(&job.mutex, NULL);
+    pthread_cond_init(&job.memberDone, NULL);
+    pthread_cond_init(&job.memberWritten, NULL);
+
+    header.type=FILE_TYPE_ARCHIVE;
+    header.nbBitstreams=1;
+    saveFileHeader(&header, fileOutput);
+    offset=header.size;
+
+    threads=startThreads(archiveCompressionWorker, &job, nbThreads);
+    for(int i=0; i<nbMembers; i++){ // The files are written in order, as soon as they are compressed
+        pthread_mutex_lock(&job.mutex);
+        while(!members[i].done)
+            pthread_cond_wait(&job.memberDone, &job.mutex);
+        pthread_mutex_unlock(&job.mutex);
+
+        fwriteAndCheck(members[i].content, members[i].compressedSize, fileOutput);
+        members[i].offset=offset;
+        offset+=members[i].compressedSize;
+        free(members[i].content);
+        members[i].content=NULL;
+
+        pthread_mutex_lock(&job.mutex);
+        job.nbWrittenMembers++;
+        pthread_cond_broadcast(&job.memberWritten);
+        pthread_mutex_unlock(&job.mutex);
+    }
+    joinThreads(threads, nbThreads);
+
+    for(int i=0; i<nbMembers; i++)
+        directorySize+=strlen(members[i].name)+4*MAX_VARINT_SIZE;
+    MALLOC(centralDirectory, unsigned char, directorySize);
+    directorySize=0;
+    for(int i=0; i<nbMembers; i++){
+        nameLength=strlen(members[i].name);
+        directorySize+=writeVarint(centralDirectory+directorySize, nameLength);
+        memcpy(centralDirectory+directorySize, members[i].name, nameLength);
+        directorySize+=nameLength;
+        directorySize+=writeVarint(centralDirectory+directorySize, members[i].originalSize);
+        directorySize+=writeVarint(centralDirectory+directorySize, members[i].offset);
+        directorySize+=writeVarint(centralDirectory+directorySize, members[i].compressedSize);
+    }
+    fwriteAndCheck(centralDirectory, directorySize, fileOutput);
+    writeLittleEndian(buffer, offset, 8);
+    writeLittleEndian(buffer+8, nbMembers, 4);
+    memcpy(buffer+12, ARCHIVE_MAGIC, 4);
+    fwriteAndCheck(buffer, TRAILER_SIZE, fileOutput);
+
+    pthread_mutex_destroy(&job.mutex);
+    pthread_cond_destroy(&job.memberDone);
+    pthread_cond_destroy(&job.memberWritten);
+    free(centralDirectory);
+    return offset+directorySize+TRAILER_SIZE;
+}
+
+/**
+ * \fn int isSafeMemberName(const char* name)
+ * \brief Checks that the name of a file of an archive stays in the directory where it's extracted: it's not absolute and none of its directories is ".." or empty
+ * \param name Name of the file
+ * \return 1 if the name can be extracted, 0 otherwise
+ */
+
+int isSafeMemberName(const char* name)
+{
+    const char* part=name;
+    size_t partLength=0;
+
+    while(1){
+        partLength=strcspn(part, "/");
+        if(partLength==0 || (partLength==2 && !strncmp(part, "..", 2)) || (partLength==1 && part[0]=='.'))
+            return 0;
+        if(part[partLength]=='\0')
+            return 1;
+        part+=partLength+1;
+    }
+}
+
+/**
+ * \fn ArchiveMember* readArchiveDirectory(const unsigned char* input, size_t inputSize, int* nbMembers)
+ * \brief Checks the header and the trailer of an archive and reads its central directory. If the archive is incorrect then the program is stopped
+ * \param input Content of the archive
+ * \param inputSize Size of input
+ * \param nbMembers Receives the number of files of the archive
+ * \return The array of files, freed by freeArchiveMembers
+ */
+
+ArchiveMember* readArchiveDirectory(const unsigned char* input, size_t inputSize, int* nbMembers)
+{
+    ArchiveMember* members=NULL;
+    FileHeader header;
+    const unsigned char* trailer=input+inputSize-TRAILER_SIZE;
+    uint64_t directoryOffset=0;
+    uint64_t position=0;
+    uint64_t nameLength=0;
+    int nbReadBytes=0;
+
+    if(inputSize<FILE_HEADER_FIXED_SIZE+TRAILER_SIZE || readFileHeader(input, inputSize, &header)!=1 || header.type!=FILE_TYPE_ARCHIVE){
+        fprintf(stderr, "ERROR: this file is not an archive\n");
+        exit(EXIT_FAILURE);
+    }
+    directoryOffset=readLittleEndian(trailer, 8);
+    *nbMembers=readLittleEndian(trailer+8, 4);
+    if(memcmp(trailer+12, ARCHIVE_MAGIC, 4) || directoryOffset<header.size || directoryOffset>inputSize-TRAILER_SIZE || *nbMembers<0 || (uint64_t) *nbMembers>inputSize){
+        fprintf(stderr, "ERROR: the central directory of the archive is incorrect\n");
+        exit(EXIT_FAILURE);
+    }
+
+    MALLOC(members, ArchiveMember, *nbMembers+1);
+    position=directoryOffset;
+    for(int i=0; i<*nbMembers; i++){
+        members[i].name=NULL;
+        members[i].content=NULL;
+        nbReadBytes=readVarint(input+position, inputSize-TRAILER_SIZE-position, &nameLength);
+        if(nbReadBytes>0 && nameLength>0 && nameLength<FILENAME_MAX && position+nbReadBytes+nameLength<=inputSize-TRAILER_SIZE){
+            position+=nbReadBytes;
+            MALLOC(members[i].name, char, nameLength+1);
+            memcpy(members[i].name, input+position, nameLength);
+            members[i].name[nameLength]='\0';
+            position+=nameLength;
+            nbReadBytes=readVarint(input+position, inputSize-TRAILER_SIZE-position, &members[i].originalSize);
+            position+=nbReadBytes>0 ? nbReadBytes : 0;
+            if(nbReadBytes>0)
+                nbReadBytes=readVarint(input+position, inputSize-TRAILER_SIZE-position, &members[i].offset);
+            position+=nbReadBytes>0 ? nbReadBytes : 0;
+            if(nbReadBytes>0)
+                nbReadBytes=readVarint(input+position, inputSize-TRAILER_SIZE-position, &members[i].compressedSize);
+            position+=nbReadBytes>0 ? nbReadBytes : 0;
+        }
+        else
+            nbReadBytes=-1;
+        if(nbReadBytes<=0 || strlen(members[i].name)!=nameLength || !isSafeMemberName(members[i].name) || members[i].offset<header.size || members[i].offset>directoryOffset || members[i].compressedSize>directoryOffset-members[i].offset || (members[i].compressedSize==0)!=(members[i].originalSize==0)){
+            fprintf(stderr, "ERROR: the central directory of the archive is incorrect\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if(position!=inputSize-TRAILER_SIZE){
+        fprintf(stderr, "ERROR: the central directory of the archive is incorrect\n");
+        exit(EXIT_FAILURE);
+    }
+    return members;
+}
+
+/**
+ * \fn void extractArchiveMember(HuffmanContext* context, const unsigned char* input, ArchiveMember* member, unsigned char** output, size_t* outputSize, FILE* fileOutput)
+ * \brief Decompresses a file of an archive, by reading only its compressed content
+ * \param context Library context used to decompress the file
+ * \param input Content of the archive
+ * \param member File of the archive, read from its central directory
+ * \param output Buffer where the file is decompressed, reallocated when it's too small
+ * \param outputSize Size of the buffer
+ * \param fileOutput File where the decompressed file is written
+ */
+
+void extractArchiveMember(HuffmanContext* context, const unsigned char* input, ArchiveMember* member, unsigned char** output, size_t* outputSize, FILE* fileOutput)
+{
+    if(member->originalSize==0)
+        return;
+    if(member->originalSize>*outputSize){
+        *outputSize=member->originalSize;
+        REALLOC(*output, unsigned char, *outputSize);
+    }
+    if(huffmanDecompressWithContext(context, input+member->offset, member->compressedSize, *output, member->originalSize)!=member->originalSize){
+        fprintf(stderr, "ERROR: the file %s of the archive is incorrect\n", member->name);
+        exit(EXIT_FAILURE);
+    }
+    fwriteAndCheck(*output, member->originalSize, fileOutput);
+}
+
+/**
+ * \fn void createParentDirectories(const char* fileName)
+ * \brief Creates the directories containing a file, if they don't exist
+ * \param fileName Path of the file
+ */
+
+void createParentDirectories(const char* fileName)
+{
+    char* path=NULL;
+    char* separator=NULL;
+
+    MALLOC(path, char, strlen(fileName)+1);
+    strcpy(path, fileName);
+    separator=strchr(path+1, '/');
+    while(separator!=NULL){
+        *separator='\0';
+        if(mkdir(path, 0777)!=0 && errno!=EEXIST){
+            fprintf(stderr, "ERROR: the directory %s can't be created\n", path);
+            exit(EXIT_FAILURE);
+        }
+        *separator='/';
+        separator=strchr(separator+1, '/');
+    }
+    free(path);
+}
+
+/**
+ * \fn void* archiveExtractionWorker(void* argument)
+ * \brief Function run by each thread extracting the files of an archive. Each thread extracts the next file that is not extracted yet, until all of them are extracted
+ * \param argument Pointer to the ArchiveExtractionJob shared by the threads
+ * \return NULL
+ */
+
+void* archiveExtractionWorker(void* argument)
+{
+    ArchiveExtractionJob* job=(ArchiveExtractionJob*) argument;
+    HuffmanContext* context=createHuffmanContext();
+    unsigned char* output=NULL;
+    size_t outputSize=0;
+    char* fileName=NULL;
+    FILE* fileOutput=NULL;
+    int i_Member=0;
+
+    while(1){
+        pthread_mutex_lock(&job->mutex);
+        i_Member=job->nextMember;
+        job->nextMember++;
+        pthread_mutex_unlock(&job->mutex);
+        if(i_Member>=job->nbMembers)
+            break;
+
+        fileName=joinPath(job->directoryName, job->members[i_Member].name);
+        createParentDirectories(fileName);
+        fileOutput=fopen(fileName, "wb");
+        checkFopen(fileOutput);
+        extractArchiveMember(context, job->input, &job->members[i_Member], &output, &outputSize, fileOutput);
+        fcloseAndCheck(fileOutput);
+        free(fileName);
+    }
+    free(output);
+    freeHuffmanContext(&context);
+    return NULL;
+}
+
+/**
+ * \fn uint64_t archiveExtraction(const unsigned char* input, size_t inputSize, const char* directoryName, int nbThreads, int* nbMembers)
+ * \brief Extracts in parallel all the files of an archive in a directory, keeping their sub-directories
+ * \param input Content of the archive
+ * \param inputSize Size of input
+ * \param directoryName Name of the directory where the files are extracted. It's created if it doesn't exist
+ * \param nbThreads Number of threads extracting the files
+ * \param nbMembers Receives the number of files extracted
+ * \return The size of all the extracted files
+ */
+
+uint64_t archiveExtraction(const unsigned char* input, size_t inputSize, const char* directoryName, int nbThreads, int* nbMembers)
+{
+    ArchiveExtractionJob job;
+    pthread_t* threads=NULL;
+    uint64_t outputSize=0;
+
+    job.members=readArchiveDirectory(input, inputSize, nbMembers);
+    for(int i=0; i<*nbMembers; i++)
+        outputSize+=job.members[i].originalSize;
+    if(mkdir(directoryName, 0777)!=0 && errno!=EEXIST){
+        fprintf(stderr, "ERROR: the directory %s can't be created\n", directoryName);
+        exit(EXIT_FAILURE);
+    }
+
+    job.input=input;
+    job.directoryName=directoryName;
+    job.nbMembers=*nbMembers;
+    job.nextMember=0;
+    pthread_mutex_init(&job.mutex, NULL);
+    if(nbThreads>job.nbMembers)
+        nbThreads=job.nbMembers;
+    if(nbThreads<1)
+        nbThreads=1;
+    threads=startThreads(archiveExtractionWorker, &job, nbThreads);
+    joinThreads(threads, nbThreads);
+    pthread_mutex_destroy(&job.mutex);
+
+    freeArchiveMembers(&job.members, job.nbMembers);
+    return outputSize;
+}
+
+/**
+ * \fn uint64_t archiveMemberExtraction(const unsigned char* input, size_t inputSize, const char* memberName, FILE* fileOutput)
+ * \brief Extracts a single file of an archive: it's found in the central directory, so only its compressed content is read
+ * \param input Content of the archive
+ * \param inputSize Size of input
+ * \param memberName Name of the file in the archive, as given by the central directory
+ * \param fileOutput File where the extracted file is written
+ * \return The size of the extracted file
+ */
+
+uint64_t archiveMemberExtraction(const unsigned char* input, size_t inputSize, const char* memberName, FILE* fileOutput)
+{
+    ArchiveMember* members=NULL;
+    ArchiveMember key;
+    ArchiveMember* member=NULL;
+    HuffmanContext* context=NULL;
+    unsigned char* output=NULL;
+    size_t outputSize=0;
+    uint64_t originalSize=0;
+    int nbMembers=0;
+
+    members=readArchiveDirectory(input, inputSize, &nbMembers);
+    key.name=(char*) memberName;
+    member=bsearch(&key, members, nbMembers, sizeof(ArchiveMember), compareArchiveMembers); // The central directory is sorted by name
+    if(member==NULL){
+        fprintf(stderr, "ERROR: the file %s is not in the archive\n", memberName);
+        exit(EXIT_FAILURE);
+    }
+    context=createHuffmanContext();
+    extractArchiveMember(context, input, member, &output, &outputSize, fileOutput);
+    originalSize=member->originalSize;
+
+    free(output);
+    freeHuffmanContext(&context);
+    freeArchiveMembers(&members, nbMembers);
+    return originalSize;
+}
@@ -0,0 +1,476 @@
+/**
+ * \file blocks.c
+ * \brief Contains functions used to compress and decompress a file split in blocks, each block having its own Huffman codes
+ * \date 2021
+ */
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/file_functions.h"
+#include "../include/huffman_coding_table.h"
+#include "../include/histogram.h"
+#include "../include/compression.h"
+#include "../include/decompression.h"
+#include "../include/threads.h"
+#include "../include/header.h"
+#include "../include/stored.h"
+#include "../include/blocks.h"
+
+/**
+ * \fn void compressBlock(const unsigned char* input, int inputSize, int nbBitstreams, int maxCodeLength, CompressedBlock* block)
+ * \brief Compresses a block with its own Huffman codes. The compressed block contains its original size, the size of its compressed data, the length of the codes, the size of its bitstreams if there are several ones, and the compressed data. If the codes wouldn't save enough bytes, the block is stored instead: the size of its data has the flag STORED_BLOCK_FLAG and is followed by the characters of the block
+ * \param input Block of the original file that is compressed
+ * \param inputSize Size of the block. It must not be 0
+ * \param nbBitstreams Number of bitstreams in which the block is split, 1 or NB_INTERLEAVED_BITSTREAMS
+ * \param maxCodeLength Maximum length of the Huffman codes
+ * \param block Compressed block. Its content is allocated by this function
+ */
+
+void compressBlock(const unsigned char* input, int inputSize, int nbBitstreams, int maxCodeLength, CompressedBlock* block)
+{
+    uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE];
+    uint64_t bitstreamOccurrences[NB_INTERLEAVED_BITSTREAMS][N_VALUES_IN_BYTE];
+    uint64_t bitstreamSizes[NB_INTERLEAVED_BITSTREAMS]={0};
+    unsigned char codeLengths[N_VALUES_IN_BYTE];
+    HuffmanCode codeTable[N_VALUES_IN_BYTE];
+    BitWriter writer;
+    int sectionSize=0;
+    int tableSize=(nbBitstreams>1) ? BITSTREAM_TABLE_SIZE : 0;
+    uint64_t payloadSize=0;
+
+    countBitstreamOccurrences(input, inputSize, nbBitstreams, bitstreamOccurrences, arrayOfOccurrences);
+    block->addedBits=createCodeLengths(arrayOfOccurrences, codeLengths, maxCodeLength);
+    createCanonicalCodeTable(codeLengths, codeTable);
+    if(checkCodeLengths(codeLengths)>1) // If there is only one character, its size is enough to decompress the block
+        payloadSize=getBitstreamSizes(bitstreamOccurrences, nbBitstreams, codeTable, bitstreamSizes);
+    sectionSize=getCodeLengthsSectionSize(checkCodeLengths(codeLengths)-1);
+    if(!isCompressible(inputSize, FRAME_HEADER_SIZE+sectionSize+tableSize+payloadSize)){ // The characters are copied, so that decompressing them costs nothing
+        MALLOC(block->content, unsigned char, FRAME_HEADER_SIZE+inputSize);
+        writeLittleEndian(block->content, inputSize, 4);
+        writeLittleEndian(block->content+4, STORED_BLOCK_FLAG|inputSize, 4);
+        memcpy(block->content+FRAME_HEADER_SIZE, input, inputSize);
+        block->size=FRAME_HEADER_SIZE+inputSize;
+        block->originalSize=inputSize;
+        return;
+    }
+
+    MALLOC(block->content, unsigned char, FRAME_HEADER_SIZE+N_VALUES_IN_BYTE+1+tableSize+payloadSize);
+    sectionSize=saveCodeLengthsInBuffer(codeLengths, block->content+FRAME_HEADER_SIZE);
+    writeLittleEndian(block->content, inputSize, 4);
+    writeLittleEndian(block->content+4, payloadSize, 4);
+    for(int i=0; i<nbBitstreams-1; i++)
+        writeLittleEndian(block->content+FRAME_HEADER_SIZE+sectionSize+4*i, bitstreamSizes[i], 4);
+    if(payloadSize>0){
+        initializeBitWriter(&writer, NULL, block->content+FRAME_HEADER_SIZE+sectionSize+tableSize, payloadSize);
+        encodeBitstreams(&writer, input, inputSize, nbBitstreams, codeTable);
+    }
+    block->size=FRAME_HEADER_SIZE+sectionSize+tableSize+payloadSize;
+    block->originalSize=inputSize;
+}
+
+/**
+ * \fn void* blockCompressionWorker(void* argument)
+ * \brief Function run by each thread compressing blocks. Each thread compresses the next block that is not compressed yet until all of them are compressed
+ * \param argument Pointer to the BlockCompressionJob shared by the threads
+ * \return NULL
+ */
+
+void* blockCompressionWorker(void* argument)
+{
+    BlockCompressionJob* job=(BlockCompressionJob*) argument;
+    int i_Block=0;
+    uint64_t inputSize=0;
+
+    pthread_mutex_lock(&job->mutex);
+    while(job->nextBlock<job->nbBlocks){
+        if(job->nextBlock>=job->nbWrittenBlocks+job->maxBlocksInMemory){ // Too many blocks are waiting to be written
+            pthread_cond_wait(&job->blockWritten, &job->mutex);
+            continue;
+        }
+        i_Block=job->nextBlock;
+        job->nextBlock++;
+        pthread_mutex_unlock(&job->mutex);
+
+        inputSize=job->fileSize-((uint64_t) i_Block)*job->blockSize;
+        if(inputSize>(uint64_t) job->blockSize)
+            inputSize=job->blockSize;
+        compressBlock(job->input+((size_t) i_Block)*job->blockSize, inputSize, job->nbBitstreams, job->maxCodeLength, &job->blocks[i_Block]);
+
+        pthread_mutex_lock(&job->mutex);
+        job->blocks[i_Block].done=1;
+        pthread_cond_broadcast(&job->blockDone);
+    }
+    pthread_mutex_unlock(&job->mutex);
+    return NULL;
+}
+
+/**
+ * \fn uint64_t blockCompression(const unsigned char* input, uint64_t fileSize, FILE* fileOutput, int blockSize, int nbBitstreams, int nbThreads, int maxCodeLength)
+ * \brief Compresses a file split in blocks that are compressed in parallel. The compressed file contains the blocks in the same order, followed by their index
+ * \param input Content of the file that is being compressed
+ * \param fileSize Size of input. It must not be 0
+ * \param fileOutput File where is written the compressed version of input
+ * \param blockSize Size of the blocks, in bytes
+ * \param nbBitstreams Number of bitstreams in which each block is split, 1 or NB_INTERLEAVED_BITSTREAMS
+ * \param nbThreads Number of threads compressing the blocks
+ * \param maxCodeLength Maximum length of the Huffman codes
+ * \return The number of bits added to the compressed blocks by the limit of the length of the codes
+ */
+
+uint64_t blockCompression(const unsigned char* input, uint64_t fileSize, FILE* fileOutput, int blockSize, int nbBitstreams, int nbThreads, int maxCodeLength)
+{
+    BlockCompressionJob job;
+    pthread_t* threads=NULL;
+    unsigned char* index=NULL;
+    unsigned char buffer[TRAILER_SIZE];
+    uint64_t offset=0; // position in fileOutput
+    uint64_t addedBits=0;
+    FileHeader header;
+
+    job.input=input;
+    job.fileSize=fileSize;
+    job.blockSize=blockSize;
+    job.nbBlocks=(fileSize-1)/blockSize+1;
+    job.nextBlock=0;
+    job.nbWrittenBlocks=0;
+    job.maxBlocksInMemory=2*nbThreads;
+    job.maxCodeLength=maxCodeLength;
+    job.nbBitstreams=nbBitstreams;
+    MALLOC(job.blocks, CompressedBlock, job.nbBlocks);
+    for(int i=0; i<job.nbBlocks; i++)
+        job.blocks[i].done=0;
+    MALLOC(index, unsigned char, ((size_t) job.nbBlocks)*INDEX_ENTRY_SIZE);
+    pthread_mutex_init(&job.mutex, NULL);
+    pthread_cond_init(&job.blockDone, NULL);
+    pthread_cond_init(&job.blockWritten, NULL);
+
+    header.type=FILE_TYPE_BLOCKS;
+    header.originalSize=fileSize;
+    header.blockSize=blockSize;
+    header.nbBitstreams=nbBitstreams;
+    saveFileHeader(&header, fileOutput);
+    offset=header.size;
+
+    threads=startThreads(blockCompressionWorker, &job, nbThreads);
+    for(int i=0; i<job.nbBlocks; i++){ // The blocks are written in order, as soon as they are compressed
+        pthread_mutex_lock(&job.mutex);
+        while(!job.blocks[i].done)
+            pthread_cond_wait(&job.blockDone, &job.mutex);
+        pthread_mutex_unlock(&job.mutex);
+
+        fwriteAndCheck(job.blocks[i].content, job.blocks[i].size, fileOutput);
+        writeLittleEndian(index+((size_t) i)*INDEX_ENTRY_SIZE, offset, 8);
+        writeLittleEndian(index+((size_t) i)*INDEX_ENTRY_SIZE+8, job.blocks[i].originalSize, 4);
+        writeLittleEndian(index+((size_t) i)*INDEX_ENTRY_SIZE+12, job.blocks[i].size, 4);
+        offset+=job.blocks[i].size;
+        addedBits+=job.blocks[i].addedBits;
+        free(job.blocks[i].content);
+
+        pthread_mutex_lock(&job.mutex);
+        job.nbWrittenBlocks++;
+        pthread_cond_broadcast(&job.blockWritten);
+        pthread_mutex_unlock(&job.mutex);
+    }
+    joinThreads(threads, nbThreads);
+
+    writeLittleEndian(buffer, 0, 4); // A block of size 0 marks the end of the blocks
+    fwriteAndCheck(buffer, 4, fileOutput);
+    offset+=4;
+    fwriteAndCheck(index, ((size_t) job.nbBlocks)*INDEX_ENTRY_SIZE, fileOutput);
+    writeLittleEndian(buffer, offset, 8);
+    writeLittleEndian(buffer+8, job.nbBlocks, 4);
+    memcpy(buffer+12, INDEX_MAGIC, 4);
+    fwriteAndCheck(buffer, TRAILER_SIZE, fileOutput);
+
+    pthread_mutex_destroy(&job.mutex);
+    pthread_cond_destroy(&job.blockDone);
+    pthread_cond_destroy(&job.blockWritten);
+    free(index);
+    free(job.blocks);
+    return addedBits;
+}
+
+/**
+ * \fn uint64_t streamCompression(const unsigned char* prefix, size_t prefixSize, FILE* fileInput, FILE* fileOutput, int chunkSize, int nbBitstreams, int maxCodeLength, uint64_t* originalSize, uint64_t* compressedSize)
+ * \brief Compresses a stream (e.g. stdin) whose size is unknown, without seeking in it nor in fileOutput. The stream is read by chunks compressed one after the other like the blocks of blockCompression, followed by an end marker, so only one chunk is in memory at a time
+ * \param prefix Beginning of the stream, already read in memory (e.g. when it didn't fit in the memory budget), or NULL. Its full chunks are compressed where they are
+ * \param prefixSize Size of prefix
+ * \param fileInput Stream that is compressed, read after prefix
+ * \param fileOutput Stream where is written the compressed version of fileInput
+ * \param chunkSize Size of the chunks, in bytes
+ * \param nbBitstreams Number of bitstreams in which each chunk is split, 1 or NB_INTERLEAVED_BITSTREAMS
+ * \param maxCodeLength Maximum length of the Huffman codes
+ * \param originalSize Number of bytes read from fileInput
+ * \param compressedSize Number of bytes written in fileOutput
+ * \return The number of bits added to the compressed chunks by the limit of the length of the codes
+ */
+
+uint64_t streamCompression(const unsigned char* prefix, size_t prefixSize, FILE* fileInput, FILE* fileOutput, int chunkSize, int nbBitstreams, int maxCodeLength, uint64_t* originalSize, uint64_t* compressedSize)
+{
+    CompressedBlock chunk;
+    unsigned char* input=NULL;
+    const unsigned char* chunkContent=NULL;
+    unsigned char buffer[4];
+    size_t inputSize=0;
+    uint64_t addedBits=0;
+    FileHeader header;
+
+    MALLOC(input, unsigned char, chunkSize);
+    header.type=FILE_TYPE_STREAM;
+    header.blockSize=chunkSize;
+    header.nbBitstreams=nbBitstreams;
+    saveFileHeader(&header, fileOutput);
+    *originalSize=0;
+    *compressedSize=header.size;
+
+    while(1){
+        if(prefixSize>=(size_t) chunkSize){ // The chunks that were already read are not copied
+            chunkContent=prefix;
+            inputSize=chunkSize;
+            prefix+=chunkSize;
+            prefixSize-=chunkSize;
+        }
+        else{ // The end of the prefix is completed by the stream
+            if(prefixSize>0)
+                memcpy(input, prefix, prefixSize);
+            chunkContent=input;
+            inputSize=prefixSize+fread(input+prefixSize, 1, chunkSize-prefixSize, fileInput);
+            prefixSize=0;
+        }
+        if(inputSize==0)
+            break;
+        compressBlock(chunkContent, inputSize, nbBitstreams, maxCodeLength, &chunk);
+        fwriteAndCheck(chunk.content, chunk.size, fileOutput);
+        free(chunk.content);
+        *originalSize+=inputSize;
+        *compressedSize+=chunk.size;
+        addedBits+=chunk.addedBits;
+    }
+    if(ferror(fileInput)){
+        fprintf(stderr, "ERROR: fread can't read the input file in streamCompression\n");
+        exit(EXIT_FAILURE);
+    }
+
+    writeLittleEndian(buffer, 0, 4); // A chunk of size 0 marks the end of the stream
+    fwriteAndCheck(buffer, 4, fileOutput);
+    *compressedSize+=4;
+    free(input);
+    return addedBits;
+}
+
+/**
+ * \fn void decompressBlock(const unsigned char* block, size_t blockSize, int nbBitstreams, unsigned char* output, int originalSize)
+ * \brief Decompresses a block compressed by compressBlock, by copying its characters if it's stored
+ * \param block Compressed block, starting with its header
+ * \param blockSize Size of the compressed block
+ * \param nbBitstreams Number of bitstreams in which the block is split, read from the header of the file
+ * \param output Buffer where the decompressed block is written
+ * \param originalSize Size of the decompressed block
+ */
+
+void decompressBlock(const unsigned char* block, size_t blockSize, int nbBitstreams, unsigned char* output, int originalSize)
+{
+    unsigned char codeLengths[N_VALUES_IN_BYTE];
+    uint64_t bitstreamSizes[NB_INTERLEAVED_BITSTREAMS];
+    HuffmanDecoder decoder;
+    int nbChars=0;
+    int sectionSize=0;
+    int tableSize=(nbBitstreams>1) ? BITSTREAM_TABLE_SIZE : 0;
+    uint64_t payloadSize=0;
+
+    if(blockSize<FRAME_HEADER_SIZE || readLittleEndian(block, 4)!=(uint64_t) originalSize){
+        fprintf(stderr, "ERROR: the header of a block is incorrect\n");
+        exit(EXIT_FAILURE);
+    }
+    payloadSize=readLittleEndian(block+4, 4);
+    if(payloadSize==(STORED_BLOCK_FLAG|originalSize)){
+        if((size_t) (FRAME_HEADER_SIZE+originalSize)!=blockSize){
+            fprintf(stderr, "ERROR: the header of a block is incorrect\n");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(output, block+FRAME_HEADER_SIZE, originalSize);
+        return;
+    }
+    sectionSize=getCodeLengthsFromBuffer(block+FRAME_HEADER_SIZE, blockSize-FRAME_HEADER_SIZE, codeLengths, &nbChars);
+    if(sectionSize<0 || FRAME_HEADER_SIZE+sectionSize+tableSize+payloadSize!=blockSize){
+        fprintf(stderr, "ERROR: the header of a block is incorrect\n");
+        exit(EXIT_FAILURE);
+    }
+    if(nbChars==1){ // The block contains only one character
+        for(int i=0; i<N_VALUES_IN_BYTE; i++){
+            if(codeLengths[i]>0)
+                memset(output, i, originalSize);
+        }
+    }
+    else{
+        for(int i=0; i<nbBitstreams-1; i++)
+            bitstreamSizes[i]=readLittleEndian(block+FRAME_HEADER_SIZE+sectionSize+4*i, 4);
+        createHuffmanDecoder(codeLengths, originalSize, &decoder);
+        if(decodeBitstreams(&decoder, block+FRAME_HEADER_SIZE+sectionSize+tableSize, payloadSize, nbBitstreams, bitstreamSizes, output, originalSize)<0){
+            fprintf(stderr, "ERROR: the compressed data of a block is incorrect or truncated\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+/**
+ * \fn uint64_t blockDecompression(FILE* fileInput, int blockSize, int nbBitstreams, FILE* fileOutput)
+ * \brief Decompresses a file compressed by blockCompression or streamCompression by reading its blocks one after the other, without seeking, so it can read a stream. The index of the blocks is not read
+ * \param fileInput Compressed file or stream that we want to decompress. Its position must be at the beginning of the first block, just after the header
+ * \param blockSize Maximum size of the decompressed blocks, read from the header
+ * \param nbBitstreams Number of bitstreams in which each block is split, read from the header
+ * \param fileOutput File where is written the decompressed version of fileInput
+ * \return The size of the decompressed file
+ */
+
+uint64_t blockDecompression(FILE* fileInput, int blockSize, int nbBitstreams, FILE* fileOutput)
+{
+    unsigned char header[FRAME_HEADER_SIZE+1];
+    unsigned char* block=NULL;
+    unsigned char* output=NULL;
+    int originalSize=0;
+    size_t compressedSize=0;
+    uint64_t outputSize=0;
+
+    if(blockSize<1 || blockSize>MAX_BLOCK_SIZE*1024*1024){
+        fprintf(stderr, "ERROR: the data read from the file header is incorrect\n");
+        exit(EXIT_FAILURE);
+    }
+    MALLOC(output, unsigned char, blockSize);
+    MALLOC(block, unsigned char, MAX_FRAME_OVERHEAD+blockSize);
+    while(1){
+        freadAndCheck(header, 4, fileInput);
+        originalSize=readLittleEndian(header, 4);
+        if(originalSize==0) // End of the blocks
+            break;
+        if(originalSize>blockSize){
+            fprintf(stderr, "ERROR: the header of a block is incorrect\n");
+            exit(EXIT_FAILURE);
+        }
+        freadAndCheck(header+4, FRAME_HEADER_SIZE+1-4, fileInput);
+        if(readLittleEndian(header+4, 4)==(STORED_BLOCK_FLAG|originalSize)) // The characters directly follow the header
+            compressedSize=FRAME_HEADER_SIZE+originalSize;
+        else
+            compressedSize=FRAME_HEADER_SIZE+getCodeLengthsSectionSize(header[FRAME_HEADER_SIZE])+((nbBitstreams>1) ? BITSTREAM_TABLE_SIZE : 0)+readLittleEndian(header+4, 4);
+        if(compressedSize>(size_t) (MAX_FRAME_OVERHEAD+originalSize)){
+            fprintf(stderr, "ERROR: the header of a block is incorrect\n");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(block, header, FRAME_HEADER_SIZE+1);
+        freadAndCheck(block+FRAME_HEADER_SIZE+1, compressedSize-FRAME_HEADER_SIZE-1, fileInput);
+        decompressBlock(block, compressedSize, nbBitstreams, output, originalSize);
+        fwriteAndCheck(output, originalSize, fileOutput);
+        outputSize+=originalSize;
+    }
+    free(block);
+    free(output);
+    return outputSize;
+}
+
+/**
+ * \fn void* blockDecompressionWorker(void* argument)
+ * \brief Function run by each thread decompressing blocks. Each thread decompresses the next block that is not decompressed yet, and writes it at its position in the decompressed file
+ * \param argument Pointer to the BlockDecompressionJob shared by the threads
+ * \return NULL
+ */
+
+void* blockDecompressionWorker(void* argument)
+{
+    BlockDecompressionJob* job=(BlockDecompressionJob*) argument;
+    unsigned char* output=NULL;
+    uint32_t i_Block=0;
+
+    MALLOC(output, unsigned char, job->blockSize);
+    while(1){
+        pthread_mutex_lock(&job->mutex);
+        i_Block=job->nextBlock;
+        job->nextBlock++;
+        pthread_mutex_unlock(&job->mutex);
+        if(i_Block>=job->nbBlocks)
+            break;
+
+        if(job->compressedSizes[i_Block]==FRAME_HEADER_SIZE+job->originalSizes[i_Block] && readLittleEndian(job->input+job->blockOffsets[i_Block]+4, 4)==(STORED_BLOCK_FLAG|job->originalSizes[i_Block])){ // A stored block is written directly from the input
+            pwriteAndCheck(job->outputDescriptor, job->input+job->blockOffsets[i_Block]+FRAME_HEADER_SIZE, job->originalSizes[i_Block], job->outputOffsets[i_Block]);
+            continue;
+        }
+        decompressBlock(job->input+job->blockOffsets[i_Block], job->compressedSizes[i_Block], job->nbBitstreams, output, job->originalSizes[i_Block]);
+        pwriteAndCheck(job->outputDescriptor, output, job->originalSizes[i_Block], job->outputOffsets[i_Block]);
+    }
+    free(output);
+    return NULL;
+}
+
+/**
+ * \fn void parallelBlockDecompression(const unsigned char* input, size_t inputSize, size_t headerSize, int blockSize, int nbBitstreams, uint64_t originalSize, FILE* fileOutput, int nbThreads)
+ * \brief Decompresses a file compressed by blockCompression by reading its index, so that its blocks are decompressed in parallel and written directly at their position
+ * \param input Content of the compressed file that we want to decompress
+ * \param inputSize Size of input
+ * \param headerSize Size of the header of input, i.e. position of the first block
+ * \param blockSize Maximum size of the decompressed blocks, read from the header
+ * \param nbBitstreams Number of bitstreams in which each block is split, read from the header
+ * \param originalSize Size of the original file, read from the header. The sizes of the blocks in the index must add up to it before anything is written
+ * \param fileOutput Regular file where is written the decompressed version of input. Nothing must have been written in it
+ * \param nbThreads Number of threads decompressing the blocks
+ */
+
+void parallelBlockDecompression(const unsigned char* input, size_t inputSize, size_t headerSize, int blockSize, int nbBitstreams, uint64_t originalSize, FILE* fileOutput, int nbThreads)
+{
+    BlockDecompressionJob job;
+    pthread_t* threads=NULL;
+    const unsigned char* index=NULL;
+    const unsigned char* trailer=input+inputSize-TRAILER_SIZE;
+    uint64_t indexOffset=0;
+    uint64_t outputSize=0;
+
+    if(inputSize<headerSize+4+TRAILER_SIZE){
+        fprintf(stderr, "ERROR: the compressed file is too small\n");
+        exit(EXIT_FAILURE);
+    }
+    job.blockSize=blockSize;
+    job.nbBitstreams=nbBitstreams;
+    indexOffset=readLittleEndian(trailer, 8);
+    job.nbBlocks=readLittleEndian(trailer+8, 4);
+    // The index must fill the space between the blocks and the trailer. Its size is checked before it's subtracted, so that a huge nbBlocks or indexOffset can't wrap around
+    if(memcmp(trailer+12, INDEX_MAGIC, 4) || job.blockSize<1 || job.blockSize>MAX_BLOCK_SIZE*1024*1024 || job.nbBlocks>(inputSize-headerSize-TRAILER_SIZE)/INDEX_ENTRY_SIZE || indexOffset!=inputSize-TRAILER_SIZE-((uint64_t) job.nbBlocks)*INDEX_ENTRY_SIZE || indexOffset<headerSize){
+        fprintf(stderr, "ERROR: the index of the blocks is incorrect\n");
+        exit(EXIT_FAILURE);
+    }
+
+    index=input+indexOffset;
+    MALLOC(job.blockOffsets, uint64_t, job.nbBlocks);
+    MALLOC(job.compressedSizes, uint32_t, job.nbBlocks);
+    MALLOC(job.originalSizes, uint32_t, job.nbBlocks);
+    MALLOC(job.outputOffsets, uint64_t, job.nbBlocks);
+    for(uint32_t i=0; i<job.nbBlocks; i++){
+        job.blockOffsets[i]=readLittleEndian(index+((size_t) i)*INDEX_ENTRY_SIZE, 8);
+        job.originalSizes[i]=readLittleEndian(index+((size_t) i)*INDEX_ENTRY_SIZE+8, 4);
+        job.compressedSizes[i]=readLittleEndian(index+((size_t) i)*INDEX_ENTRY_SIZE+12, 4);
+        job.outputOffsets[i]=outputSize;
+        outputSize+=job.originalSizes[i];
+        if(job.originalSizes[i]<1 || job.originalSizes[i]>(uint32_t) job.blockSize || job.compressedSizes[i]>MAX_FRAME_OVERHEAD+job.originalSizes[i] || job.blockOffsets[i]<headerSize || job.blockOffsets[i]>indexOffset || job.compressedSizes[i]>indexOffset-job.blockOffsets[i]){
+            fprintf(stderr, "ERROR: the index of the blocks is incorrect\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if(outputSize!=originalSize){ // Otherwise the blocks would be written beyond or before the end of the decompressed file
+        fprintf(stderr, "ERROR: the index of the blocks doesn't match the size of the original file\n");
+        exit(EXIT_FAILURE);
+    }
+
+    job.input=input;
+    job.outputDescriptor=fileno(fileOutput);
+    job.nextBlock=0;
+    pthread_mutex_init(&job.mutex, NULL);
+    if((uint32_t) nbThreads>job.nbBlocks)
+        nbThreads=job.nbBlocks;
+    if(nbThreads<1)
+        nbThreads=1;
+    threads=startThreads(blockDecompressionWorker, &job, nbThreads);
+    joinThreads(threads, nbThreads);
+    pthread_mutex_destroy(&job.mutex);
+
+    free(job.blockOffsets);
+    free(job.compressedSizes);
+    free(job.originalSizes);
+    free(job.outputOffsets);
+}
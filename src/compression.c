@@ -7,64 +7,293 @@
 #include "../include/types.h"
 #include "../include/macros_constants_headers.h"
 #include "../include/huffman_coding_table.h"
+#include "../include/histogram.h"
+#include "../include/stats.h"
 #include "../include/compression.h"
 
 /**
- * \fn void huffManCompression(FILE* fileInput, unsigned char * huffmanArray[N_VALUES_IN_BYTE], FILE* fileOutput)
- * \brief Compresses a file by using Huffman
- * \param fileInput File that is being compressed
- * \param huffmanArray Array that is being filled in this function. It links all the characters to their Huffman code
- * \param fileOutput File where is written the decompressed version of fileInput
+ * \fn void writeWord(unsigned char* outputBuffer, uint64_t word)
+ * \brief Writes the 8 bytes of word in outputBuffer, starting with the most significant byte
+ * \param outputBuffer Buffer in which the word is written. It must have at least 8 free bytes
+ * \param word Bits that are written
  */
 
-void huffManCompression(FILE* fileInput, unsigned char * huffmanArray[N_VALUES_IN_BYTE], FILE* fileOutput)
+void writeWord(unsigned char* outputBuffer, uint64_t word)
 {
-    unsigned char buffer=0; // "character" that will be inserted in fileOutput
-    int c=0;
-    int size=0;
-    int currentByteIndex=1; // current index of huffmanArray[c] for the current character c. 0 corresponds to the index of the cell containing the size
-    int currentBitIndex=0; // current bit read in huffmanArray[c][currentByteIndex]. It's between 0 & 8
-    int bufferIndex=0; // counts the number of bits inserted in buffer, when it's equal to 8, the buffer is inserted in fileOutput. It's between 0 & 8
-    int indexTotalBitsInCode=1; // integer between 0 and size-1 that counts the number of bits read from the code in the huffman array
-    rewind(fileInput);
-    while(!feof(fileInput)){
-        if(indexTotalBitsInCode>=size){ // all bits from huffmanArray[c] has been read or the loop has just started
-            c=fgetc(fileInput);
-            if(c==EOF) // if we are at the end of the file then we stop
-                break;
-            size=huffmanArray[c][0];
-            if(size==0){
-                fprintf(stderr, "ERROR: in huffmanCompression the input file and the huffman array are not compatible\n");
-                exit(EXIT_FAILURE);
-            }
-            currentByteIndex=1;
-            currentBitIndex=0;
-            indexTotalBitsInCode=0;
+    for(int i=0; i<8; i++)
+        outputBuffer[i]=(unsigned char) (word>>(56-8*i));
+}
+
+/**
+ * \fn void initializeBitWriter(BitWriter* writer, FILE* file, unsigned char* content, size_t size)
+ * \brief Initializes a bit writer
+ * \param writer Bit writer that is initialized
+ * \param file File where the bytes are written when content is full. If it's NULL, content must be big enough to contain all the bits
+ * \param content Buffer where the bytes are written. It's not freed by the writer
+ * \param size Size of content. It must be at least 8
+ */
+
+void initializeBitWriter(BitWriter* writer, FILE* file, unsigned char* content, size_t size)
+{
+    writer->file=file;
+    writer->content=content;
+    writer->size=size;
+    writer->index=0;
+    writer->nbWrittenBytes=0;
+    writer->bits=0;
+    writer->nbBits=0;
+}
+
+/**
+ * \fn void emptyBitWriter(BitWriter* writer)
+ * \brief Writes the bytes of the writer in its file so that its buffer can be filled again
+ * \param writer Bit writer that is emptied. If it has no file, the program is stopped since its buffer is too small
+ */
+
+void emptyBitWriter(BitWriter* writer)
+{
+    if(writer->file==NULL){
+        fprintf(stderr, "ERROR: the buffer given to the bit writer is too small\n");
+        exit(EXIT_FAILURE);
+    }
+    if(writer->index>0 && fwrite(writer->content, 1, writer->index, writer->file)<writer->index){
+        fprintf(stderr, "ERROR: fwrite can't write in the output file in emptyBitWriter\n");
+        exit(EXIT_FAILURE);
+    }
+    writer->nbWrittenBytes+=writer->index;
+    writer->index=0;
+}
+
+/**
+ * \fn void writeBits(BitWriter* writer, uint64_t value, int nbBits)
+ * \brief Adds the last bits of value to the writer, the most significant one first
+ * \param writer Bit writer where the bits are written
+ * \param value Bits that are written, in its nbBits least significant bits
+ * \param nbBits Number of bits written, between 1 and 57
+ */
+
+void writeBits(BitWriter* writer, uint64_t value, int nbBits)
+{
+    int nbRemainingBits=0; // number of bits of value that don't fit in writer->bits
+
+    value&=(((uint64_t) 1)<<nbBits)-1;
+    if(writer->nbBits+nbBits<64){
+        writer->bits|=value<<(64-writer->nbBits-nbBits);
+        writer->nbBits+=nbBits;
+    }
+    else{ // writer->bits is full: its 64 bits are written and the end of value starts the next word
+        nbRemainingBits=writer->nbBits+nbBits-64;
+        writer->bits|=value>>nbRemainingBits;
+        if(writer->index+8>writer->size)
+            emptyBitWriter(writer);
+        writeWord(writer->content+writer->index, writer->bits);
+        writer->index+=8;
+        writer->bits=(nbRemainingBits>0) ? value<<(64-nbRemainingBits) : 0;
+        writer->nbBits=nbRemainingBits;
+    }
+}
+
+/**
+ * \fn void encodeSymbols(BitWriter* writer, const unsigned char* input, size_t inputSize, HuffmanCode codeTable[N_VALUES_IN_BYTE])
+ * \brief Adds the code of each character of input to the writer. The codes are added to a 64 bits buffer that is written when it's full
+ * \param writer Bit writer where the codes are written
+ * \param input Characters that are encoded
+ * \param inputSize Number of characters in input
+ * \param codeTable Table linking all the characters to their Huffman code
+ */
+
+void encodeSymbols(BitWriter* writer, const unsigned char* input, size_t inputSize, HuffmanCode codeTable[N_VALUES_IN_BYTE])
+{
+    HuffmanCode code;
+    uint64_t bits=writer->bits;
+    int nbBits=writer->nbBits;
+    int nbRemainingBits=0; // number of bits of the current code that don't fit in "bits"
+
+    for(size_t i=0; i<inputSize; i++){
+        code=codeTable[input[i]];
+        if(code.length==0){
+            fprintf(stderr, "ERROR: in encodeSymbols the input and the code table are not compatible\n");
+            exit(EXIT_FAILURE);
         }
-        if(c==EOF) // we stop the loop
-            break;
-        buffer=(buffer<<1)|((huffmanArray[c][currentByteIndex]>>(7-currentBitIndex))&0b1);
-        indexTotalBitsInCode++;
-        bufferIndex++;
-        currentBitIndex++;
-    
-        if(bufferIndex>=8){ // buffer is full
-            if(fputc(buffer, fileOutput)==EOF){
-                fprintf(stderr, "ERROR: fputc can't write in the output file in huffmanCompression\n");
-                exit(EXIT_FAILURE);
-            }
-            bufferIndex=0;
-            buffer=0;
+        if(nbBits+code.length<64){ // the whole code fits in bits
+            bits|=code.code<<(64-nbBits-code.length);
+            nbBits+=code.length;
         }
-        if(currentBitIndex>=8){ // we read huffmanArray[c][currentByteIndex] so we will read the next cell (currentByteIndex+1)
-            currentByteIndex++;
-            currentBitIndex=0;
+        else{ // bits is full: its 64 bits are written and the end of the code starts the next word
+            nbRemainingBits=nbBits+code.length-64;
+            bits|=code.code>>nbRemainingBits;
+            if(writer->index+8>writer->size)
+                emptyBitWriter(writer);
+            writeWord(writer->content+writer->index, bits);
+            writer->index+=8;
+            bits=(nbRemainingBits>0) ? code.code<<(64-nbRemainingBits) : 0;
+            nbBits=nbRemainingBits;
         }
     }
-    if(bufferIndex>0){ // buffer is not empty, we have to add the last buffer to the file
-        if(fputc(buffer<<(8-bufferIndex), fileOutput)==EOF){
-            fprintf(stderr, "ERROR: fputc can't write in the output file in huffmanCompression\n");
-            exit(EXIT_FAILURE);
-        }
+    writer->bits=bits;
+    writer->nbBits=nbBits;
+}
+
+/**
+ * \fn void flushBitWriter(BitWriter* writer)
+ * \brief Writes the last bits of the writer. The last byte is completed with 0. If the writer has a file, all its bytes are written in it
+ * \param writer Bit writer that is flushed
+ */
+
+void flushBitWriter(BitWriter* writer)
+{
+    while(writer->nbBits>0){
+        if(writer->index>=writer->size)
+            emptyBitWriter(writer);
+        writer->content[writer->index]=(unsigned char) (writer->bits>>56);
+        writer->index++;
+        writer->bits<<=8;
+        writer->nbBits-=8;
+    }
+    writer->bits=0;
+    writer->nbBits=0;
+    if(writer->file!=NULL)
+        emptyBitWriter(writer);
+}
+
+/**
+ * \fn uint64_t getEncodedSize(uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE], HuffmanCode codeTable[N_VALUES_IN_BYTE])
+ * \brief Gives the number of bytes taken by the encoded characters
+ * \param arrayOfOccurrences Array containing the number of occurrences of each character
+ * \param codeTable Table linking all the characters to their Huffman code
+ * \return The size of the encoded characters, in bytes
+ */
+
+uint64_t getEncodedSize(uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE], HuffmanCode codeTable[N_VALUES_IN_BYTE])
+{
+    uint64_t nbBits=0;
+    for(int i=0; i<N_VALUES_IN_BYTE; i++)
+        nbBits+=((uint64_t) arrayOfOccurrences[i])*codeTable[i].length;
+    return (nbBits+7)/8;
+}
+
+/**
+ * \fn uint64_t getBitstreamLength(uint64_t nbChars, int bitstream, int nbBitstreams)
+ * \brief Gives the number of characters encoded in a bitstream. The characters are split in nbBitstreams consecutive parts of the same size, the last one being smaller
+ * \param nbChars Total number of characters
+ * \param bitstream Index of the bitstream
+ * \param nbBitstreams Number of bitstreams
+ * \return The number of characters of the part encoded in this bitstream
+ */
+
+uint64_t getBitstreamLength(uint64_t nbChars, int bitstream, int nbBitstreams)
+{
+    uint64_t partSize=(nbChars+nbBitstreams-1)/nbBitstreams;
+    uint64_t start=partSize*bitstream;
+
+    if(start>=nbChars)
+        return 0;
+    return (nbChars-start<partSize) ? nbChars-start : partSize;
+}
+
+/**
+ * \fn uint64_t getBitstreamSizes(uint64_t bitstreamOccurrences[][N_VALUES_IN_BYTE], int nbBitstreams, HuffmanCode codeTable[N_VALUES_IN_BYTE], uint64_t* bitstreamSizes)
+ * \brief Gives the number of bytes taken by each bitstream, each one ending on a whole byte
+ * \param bitstreamOccurrences Occurrences of the characters in each part, counted by countBitstreamOccurrences
+ * \param nbBitstreams Number of bitstreams
+ * \param codeTable Table linking all the characters to their Huffman code
+ * \param bitstreamSizes Array receiving the size of each bitstream
+ * \return The total size of the bitstreams, in bytes
+ */
+
+uint64_t getBitstreamSizes(uint64_t bitstreamOccurrences[][N_VALUES_IN_BYTE], int nbBitstreams, HuffmanCode codeTable[N_VALUES_IN_BYTE], uint64_t* bitstreamSizes)
+{
+    uint64_t totalSize=0;
+
+    for(int i=0; i<nbBitstreams; i++){
+        bitstreamSizes[i]=getEncodedSize(bitstreamOccurrences[i], codeTable);
+        totalSize+=bitstreamSizes[i];
+    }
+    return totalSize;
+}
+
+/**
+ * \fn void encodeBitstreams(BitWriter* writer, const unsigned char* input, size_t inputSize, int nbBitstreams, HuffmanCode codeTable[N_VALUES_IN_BYTE])
+ * \brief Encodes each part of input in its own bitstream, the bitstreams being written one after the other. Each one ends on a whole byte so that it can be decoded on its own
+ * \param writer Bit writer where the bitstreams are written
+ * \param input Characters that are encoded
+ * \param inputSize Number of characters in input
+ * \param nbBitstreams Number of bitstreams
+ * \param codeTable Table linking all the characters to their Huffman code
+ */
+
+void encodeBitstreams(BitWriter* writer, const unsigned char* input, size_t inputSize, int nbBitstreams, HuffmanCode codeTable[N_VALUES_IN_BYTE])
+{
+    uint64_t length=0;
+
+    for(int i=0; i<nbBitstreams; i++){
+        length=getBitstreamLength(inputSize, i, nbBitstreams);
+        encodeSymbols(writer, input, length, codeTable);
+        flushBitWriter(writer);
+        input+=length;
+    }
+}
+
+/**
+ * \fn uint64_t huffManCompression(const unsigned char* input, size_t inputSize, int nbBitstreams, HuffmanCode codeTable[N_VALUES_IN_BYTE], FILE* fileOutput)
+ * \brief Compresses the content of a file by using Huffman
+ * \param input Content of the file that is being compressed
+ * \param inputSize Size of input
+ * \param nbBitstreams Number of bitstreams in which input is split
+ * \param codeTable Table linking all the characters to their Huffman code
+ * \param fileOutput File where is written the compressed version of input
+ * \return The number of bytes written in fileOutput
+ */
+
+uint64_t huffManCompression(const unsigned char* input, size_t inputSize, int nbBitstreams, HuffmanCode codeTable[N_VALUES_IN_BYTE], FILE* fileOutput)
+{
+    unsigned char* outputBuffer=NULL;
+    BitWriter writer;
+
+    MALLOC(outputBuffer, unsigned char, IO_BUFFER_SIZE);
+    initializeBitWriter(&writer, fileOutput, outputBuffer, IO_BUFFER_SIZE);
+    encodeBitstreams(&writer, input, inputSize, nbBitstreams, codeTable);
+    free(outputBuffer);
+    return writer.nbWrittenBytes;
+}
+
+/**
+ * \fn uint64_t sampledCompression(const unsigned char* input, size_t inputSize, HuffmanCode codeTable[N_VALUES_IN_BYTE], FILE* fileOutput, uint64_t* arrayOfOccurrences, double* countingTime)
+ * \brief Compresses the content of a file in a single bitstream with codes created from a sample by countSampledOccurrences, so that input is read only once. When the exact occurrences are asked (by --stats), each part of SAMPLE_READ_SIZE characters is counted just after being encoded, while it's still in the cache, without reading input again
+ * \param input Content of the file that is being compressed
+ * \param inputSize Size of input
+ * \param codeTable Table linking all the characters to their Huffman code
+ * \param fileOutput File where is written the compressed version of input
+ * \param arrayOfOccurrences Array receiving the exact number of occurrences of each character of input, or NULL to only encode it
+ * \param countingTime Time spent counting the characters, in seconds (0 if arrayOfOccurrences is NULL)
+ * \return The number of bytes written in fileOutput
+ */
+
+uint64_t sampledCompression(const unsigned char* input, size_t inputSize, HuffmanCode codeTable[N_VALUES_IN_BYTE], FILE* fileOutput, uint64_t* arrayOfOccurrences, double* countingTime)
+{
+    uint64_t partOccurrences[N_VALUES_IN_BYTE];
+    unsigned char* outputBuffer=NULL;
+    BitWriter writer;
+    size_t partSize=0;
+    double startTime=0;
+
+    for(int c=0; arrayOfOccurrences!=NULL && c<N_VALUES_IN_BYTE; c++)
+        arrayOfOccurrences[c]=0;
+    *countingTime=0;
+    MALLOC(outputBuffer, unsigned char, IO_BUFFER_SIZE);
+    initializeBitWriter(&writer, fileOutput, outputBuffer, IO_BUFFER_SIZE);
+    for(size_t i=0; i<inputSize; i+=partSize){
+        partSize=(inputSize-i<SAMPLE_READ_SIZE) ? inputSize-i : SAMPLE_READ_SIZE;
+        encodeSymbols(&writer, input+i, partSize, codeTable);
+        if(arrayOfOccurrences==NULL)
+            continue;
+        startTime=getClockTime(CLOCK_MONOTONIC);
+        countOccurrences(input+i, partSize, partOccurrences);
+        for(int c=0; c<N_VALUES_IN_BYTE; c++)
+            arrayOfOccurrences[c]+=partOccurrences[c];
+        *countingTime+=getClockTime(CLOCK_MONOTONIC)-startTime;
     }
-}
\ No newline at end of file
+    flushBitWriter(&writer);
+    free(outputBuffer);
+    return writer.nbWrittenBytes;
+}
@@ -0,0 +1,429 @@
+/**
+ * \file context.c
+ * \brief Contains functions used to compress and decompress a file with order-1 Huffman codes: the code of each character is taken from a table chosen by the character before it
+ * \date 2021
+ */
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/file_functions.h"
+#include "../include/huffman_coding_table.h"
+#include "../include/compression.h"
+#include "../include/decompression.h"
+#include "../include/context.h"
+
+/**
+ * \fn uint64_t getCodingCost(uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE], unsigned char codeLengths[N_VALUES_IN_BYTE])
+ * \brief Gives the number of bits needed to encode characters with given codes
+ * \param arrayOfOccurrences Number of occurrences of each character
+ * \param codeLengths Length of the code of each character
+ * \return The number of bits, or UINT64_MAX if a character that occurs has no code
+ */
+
+uint64_t getCodingCost(uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE], unsigned char codeLengths[N_VALUES_IN_BYTE])
+{
+    uint64_t cost=0;
+
+    for(int i=0; i<N_VALUES_IN_BYTE; i++){
+        if(arrayOfOccurrences[i]>0){
+            if(codeLengths[i]==0)
+                return UINT64_MAX;
+            cost+=arrayOfOccurrences[i]*codeLengths[i];
+        }
+    }
+    return cost;
+}
+
+/**
+ * \fn int getCodeLengthsCost(unsigned char codeLengths[N_VALUES_IN_BYTE])
+ * \brief Gives the number of bits taken by the length of the codes of a table in the context section
+ * \param codeLengths Length of the code of each character
+ * \return The number of bits written by saveCodeLengthsInBuffer
+ */
+
+int getCodeLengthsCost(unsigned char codeLengths[N_VALUES_IN_BYTE])
+{
+    unsigned char buffer[N_VALUES_IN_BYTE+1];
+    return 8*saveCodeLengthsInBuffer(codeLengths, buffer);
+}
+
+/**
+ * \fn int addContextTable(ContextModel* model, unsigned char codeLengths[N_VALUES_IN_BYTE])
+ * \brief Adds a table to a context model
+ * \param model Context model
+ * \param codeLengths Length of the codes of the table
+ * \return The index of the new table
+ */
+
+int addContextTable(ContextModel* model, unsigned char codeLengths[N_VALUES_IN_BYTE])
+{
+    memcpy(model->codeLengths[model->nbTables], codeLengths, N_VALUES_IN_BYTE);
+    model->nbTables++;
+    return model->nbTables-1;
+}
+
+/**
+ * \fn uint64_t createContextModel(uint64_t contextOccurrences[][N_VALUES_IN_BYTE], int maxCodeLength, ContextModel* model)
+ * \brief Creates the code tables of the order-1 mode. The first table has the order-0 codes of the whole file. Then the contexts are taken from the most frequent one: each one gets its own table, unless its characters take fewer bits with a table that was already added (the order-0 one or the one of a similar context), the size of the new table in the context section being counted. The order-0 table is removed if no context uses it, and the contexts that are never followed by a character have no table
+ * \param contextOccurrences Occurrences of each character after each context, given by countContextOccurrences
+ * \param maxCodeLength Maximum length of the Huffman codes
+ * \param model Context model that is created
+ * \return The number of bits of the encoded characters, without the context section
+ */
+
+uint64_t createContextModel(uint64_t contextOccurrences[][N_VALUES_IN_BYTE], int maxCodeLength, ContextModel* model)
+{
+    uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE]; // Order-0 occurrences
+    unsigned char codeLengths[N_VALUES_IN_BYTE];
+    uint64_t sortedContexts[N_VALUES_IN_BYTE]; // Number of characters after the context, followed by the context on 8 bits
+    uint64_t nbContextChars=0;
+    uint64_t ownCost=0;
+    uint64_t bestCost=0;
+    uint64_t cost=0;
+    uint64_t encodedSize=0;
+    int isOrder0TableUsed=0;
+    int bestTable=0;
+    int nbContexts=0;
+    int context=0;
+
+    for(int i=0; i<N_VALUES_IN_BYTE; i++)
+        arrayOfOccurrences[i]=0;
+    for(int p=0; p<N_VALUES_IN_BYTE; p++){
+        nbContextChars=0;
+        for(int i=0; i<N_VALUES_IN_BYTE; i++){
+            arrayOfOccurrences[i]+=contextOccurrences[p][i];
+            nbContextChars+=contextOccurrences[p][i];
+        }
+        model->isUsedContext[p]=(nbContextChars>0);
+        model->tableOfContext[p]=0;
+        if(nbContextChars>0){
+            sortedContexts[nbContexts]=(nbContextChars<<8)|p;
+            nbContexts++;
+        }
+    }
+    sortKeys(sortedContexts, nbContexts);
+    model->nbTables=0;
+    createCodeLengths(arrayOfOccurrences, codeLengths, maxCodeLength);
+    addContextTable(model, codeLengths);
+
+    for(int i=nbContexts-1; i>=0; i--){ // The most frequent contexts first, so that the next ones can share their table
+        context=sortedContexts[i]&0xFF;
+        bestTable=0;
+        bestCost=getCodingCost(contextOccurrences[context], model->codeLengths[0]);
+        for(int t=1; t<model->nbTables; t++){
+            if((cost=getCodingCost(contextOccurrences[context], model->codeLengths[t]))<bestCost){
+                bestCost=cost;
+                bestTable=t;
+            }
+        }
+        createCodeLengths(contextOccurrences[context], codeLengths, maxCodeLength);
+        ownCost=getCodingCost(contextOccurrences[context], codeLengths);
+        if(model->nbTables<N_VALUES_IN_BYTE && ownCost+getCodeLengthsCost(codeLengths)<bestCost){
+            bestTable=addContextTable(model, codeLengths);
+            bestCost=ownCost;
+        }
+        model->tableOfContext[context]=bestTable;
+        isOrder0TableUsed|=(bestTable==0);
+        encodedSize+=bestCost;
+    }
+
+    if(!isOrder0TableUsed){ // Every context has its own table or shares the one of another context
+        model->nbTables--;
+        memmove(model->codeLengths[0], model->codeLengths[1], model->nbTables*N_VALUES_IN_BYTE);
+        for(int p=0; p<N_VALUES_IN_BYTE; p++){
+            if(model->isUsedContext[p])
+                model->tableOfContext[p]--;
+        }
+    }
+    return encodedSize;
+}
+
+/**
+ * \fn int saveContextModel(ContextModel* model, unsigned char* buffer)
+ * \brief Saves the context section: the number of tables minus 1, the bitmap of the used contexts, the index of the table of each used context and the length of the codes of each table, saved by saveCodeLengthsInBuffer
+ * \param model Context model that is saved
+ * \param buffer Buffer where the section is saved. It must contain at least CONTEXT_SECTION_MAX_SIZE bytes
+ * \return The number of bytes written in buffer
+ */
+
+int saveContextModel(ContextModel* model, unsigned char* buffer)
+{
+    int size=1+CONTEXT_MAP_SIZE;
+
+    buffer[0]=model->nbTables-1;
+    memset(buffer+1, 0, CONTEXT_MAP_SIZE);
+    for(int p=0; p<N_VALUES_IN_BYTE; p++){
+        if(model->isUsedContext[p]){
+            buffer[1+p/8]|=1<<(p%8);
+            buffer[size]=model->tableOfContext[p];
+            size++;
+        }
+    }
+    for(int t=0; t<model->nbTables; t++)
+        size+=saveCodeLengthsInBuffer(model->codeLengths[t], buffer+size);
+    return size;
+}
+
+/**
+ * \fn int readContextModel(const unsigned char* buffer, size_t size, ContextModel* model)
+ * \brief Reads and checks the context section saved by saveContextModel
+ * \param buffer Buffer from which the section is read
+ * \param size Number of bytes that can be read in buffer
+ * \param model Context model that is read
+ * \return The number of bytes read from buffer, or -1 if the section is incorrect
+ */
+
+int readContextModel(const unsigned char* buffer, size_t size, ContextModel* model)
+{
+    size_t position=1+CONTEXT_MAP_SIZE;
+    int sectionSize=0;
+    int nbChars=0;
+
+    if(size<position)
+        return -1;
+    model->nbTables=buffer[0]+1;
+    for(int p=0; p<N_VALUES_IN_BYTE; p++){
+        model->isUsedContext[p]=(buffer[1+p/8]>>(p%8))&1;
+        model->tableOfContext[p]=0;
+        if(model->isUsedContext[p]){
+            if(position>=size || buffer[position]>=model->nbTables)
+                return -1;
+            model->tableOfContext[p]=buffer[position];
+            position++;
+        }
+    }
+    for(int t=0; t<model->nbTables; t++){
+        sectionSize=getCodeLengthsFromBuffer(buffer+position, size-position, model->codeLengths[t], &nbChars);
+        if(sectionSize<0)
+            return -1;
+        position+=sectionSize;
+    }
+    return position;
+}
+
+/**
+ * \fn int readContextModelFromFile(FILE* fileInput, ContextModel* model)
+ * \brief Reads and checks the context section from a stream, without reading any byte after it
+ * \param fileInput Compressed file, whose position is at the start of the context section
+ * \param model Context model that is read
+ * \return The size of the section, or -1 if it's incorrect
+ */
+
+int readContextModelFromFile(FILE* fileInput, ContextModel* model)
+{
+    unsigned char* buffer=NULL;
+    int size=1+CONTEXT_MAP_SIZE;
+    int nbTables=0;
+    int sectionSize=0;
+
+    MALLOC(buffer, unsigned char, CONTEXT_SECTION_MAX_SIZE);
+    freadAndCheck(buffer, size, fileInput);
+    nbTables=buffer[0]+1;
+    for(int i=0; i<CONTEXT_MAP_SIZE; i++) // One byte per used context
+        size+=__builtin_popcount(buffer[1+i]);
+    freadAndCheck(buffer+1+CONTEXT_MAP_SIZE, size-1-CONTEXT_MAP_SIZE, fileInput);
+    for(int t=0; t<nbTables; t++){ // The first byte of each table gives its size
+        freadAndCheck(buffer+size, 1, fileInput);
+        sectionSize=getCodeLengthsSectionSize(buffer[size]);
+        freadAndCheck(buffer+size+1, sectionSize-1, fileInput);
+        size+=sectionSize;
+    }
+    size=(readContextModel(buffer, size, model)==size) ? size : -1;
+    free(buffer);
+    return size;
+}
+
+/**
+ * \fn void createContextCodeTables(ContextModel* model, HuffmanCode* codeTables, HuffmanCode* contextCodes[N_VALUES_IN_BYTE])
+ * \brief Creates the canonical codes of each table of a context model, and links each context to the codes of its table
+ * \param model Context model
+ * \param codeTables Array of model->nbTables code tables of N_VALUES_IN_BYTE codes that are created
+ * \param contextCodes Array receiving the code table of each context
+ */
+
+void createContextCodeTables(ContextModel* model, HuffmanCode* codeTables, HuffmanCode* contextCodes[N_VALUES_IN_BYTE])
+{
+    for(int t=0; t<model->nbTables; t++)
+        createCanonicalCodeTable(model->codeLengths[t], codeTables+t*N_VALUES_IN_BYTE);
+    for(int p=0; p<N_VALUES_IN_BYTE; p++)
+        contextCodes[p]=codeTables+model->tableOfContext[p]*N_VALUES_IN_BYTE;
+}
+
+/**
+ * \fn HuffmanDecoder* createContextDecoders(ContextModel* model, HuffmanDecoder* contextDecoders[N_VALUES_IN_BYTE])
+ * \brief Creates the decoder of each table of a context model, and links each context to the decoder of its table
+ * \param model Context model
+ * \param contextDecoders Array receiving the decoder of each context
+ * \return The array of decoders, which has to be freed
+ */
+
+HuffmanDecoder* createContextDecoders(ContextModel* model, HuffmanDecoder* contextDecoders[N_VALUES_IN_BYTE])
+{
+    HuffmanDecoder* decoders=NULL;
+
+    MALLOC(decoders, HuffmanDecoder, model->nbTables);
+    for(int t=0; t<model->nbTables; t++)
+        createHuffmanDecoder(model->codeLengths[t], 0, &decoders[t]); // The table changes after each character, so the multi-symbol table is never used
+    for(int p=0; p<N_VALUES_IN_BYTE; p++)
+        contextDecoders[p]=&decoders[model->tableOfContext[p]];
+    return decoders;
+}
+
+/**
+ * \fn void encodeContextSymbols(BitWriter* writer, const unsigned char* input, size_t inputSize, HuffmanCode* contextCodes[N_VALUES_IN_BYTE])
+ * \brief Adds the code of each character of input to the writer, taken from the table of the character before it (0 before the first one), like encodeSymbols does with a single table
+ * \param writer Bit writer where the codes are written
+ * \param input Characters that are encoded
+ * \param inputSize Number of characters in input
+ * \param contextCodes Code table of each context, given by createContextCodeTables
+ */
+
+void encodeContextSymbols(BitWriter* writer, const unsigned char* input, size_t inputSize, HuffmanCode* contextCodes[N_VALUES_IN_BYTE])
+{
+    HuffmanCode code;
+    const HuffmanCode* codeTable=contextCodes[0];
+    uint64_t bits=writer->bits;
+    int nbBits=writer->nbBits;
+    int nbRemainingBits=0; // number of bits of the current code that don't fit in "bits"
+
+    for(size_t i=0; i<inputSize; i++){
+        code=codeTable[input[i]];
+        codeTable=contextCodes[input[i]]; // Loaded before the code is written, so that the next lookup doesn't wait for it
+        if(code.length==0){
+            fprintf(stderr, "ERROR: in encodeContextSymbols the input and the code tables are not compatible\n");
+            exit(EXIT_FAILURE);
+        }
+        if(nbBits+code.length<64){ // the whole code fits in bits
+            bits|=code.code<<(64-nbBits-code.length);
+            nbBits+=code.length;
+        }
+        else{ // bits is full: its 64 bits are written and the end of the code starts the next word
+            nbRemainingBits=nbBits+code.length-64;
+            bits|=code.code>>nbRemainingBits;
+            if(writer->index+8>writer->size)
+                emptyBitWriter(writer);
+            writeWord(writer->content+writer->index, bits);
+            writer->index+=8;
+            bits=(nbRemainingBits>0) ? code.code<<(64-nbRemainingBits) : 0;
+            nbBits=nbRemainingBits;
+        }
+    }
+    writer->bits=bits;
+    writer->nbBits=nbBits;
+}
+
+/**
+ * \fn int decodeContextSymbols(HuffmanDecoder* contextDecoders[N_VALUES_IN_BYTE], BitReader* reader, unsigned char* output, size_t nbChars, unsigned char* previous)
+ * \brief Decodes characters encoded by encodeContextSymbols: each one is decoded with the decode table of the character before it
+ * \param contextDecoders Decoder of each context, given by createContextDecoders
+ * \param reader Bit reader from which the codes are read
+ * \param output Buffer where the decoded characters are written
+ * \param nbChars Number of characters that are decoded
+ * \param previous Character before the first one that is decoded (0 at the start of the file). It receives the last decoded character
+ * \return 0 if the characters were decoded, -1 if the compressed data contains an incorrect code or is too short
+ */
+
+int decodeContextSymbols(HuffmanDecoder* contextDecoders[N_VALUES_IN_BYTE], BitReader* reader, unsigned char* output, size_t nbChars, unsigned char* previous)
+{
+    DecodeTableEntry entry;
+    HuffmanDecoder* decoder=contextDecoders[*previous];
+    uint64_t bits=reader->bits;
+    int nbBits=reader->nbBits;
+    int length=0;
+    unsigned char c=0;
+
+    for(size_t i=0; i<nbChars; i++){
+        if(nbBits<=56){
+            reader->bits=bits;
+            reader->nbBits=nbBits;
+            fillBitReader(reader);
+            bits=reader->bits;
+            nbBits=reader->nbBits;
+        }
+        entry=decoder->table[bits>>(64-DECODE_TABLE_BITS)];
+        if(entry.length!=0){ // The whole code is in the index
+            c=entry.c;
+            length=entry.length;
+        }
+        else{ // Slow path
+            length=decodeLongCode(decoder, bits, &c);
+            if(length<0)
+                return -1;
+        }
+        bits<<=length;
+        nbBits-=length;
+        if(nbBits<0) // All the compressed data was read but some characters are missing
+            return -1;
+        output[i]=c;
+        decoder=contextDecoders[c];
+    }
+    reader->bits=bits;
+    reader->nbBits=nbBits;
+    *previous=c;
+    return 0;
+}
+
+/**
+ * \fn uint64_t contextCompression(const unsigned char* input, size_t inputSize, ContextModel* model, FILE* fileOutput)
+ * \brief Compresses the content of a file with order-1 codes. The header and the context section must already be written
+ * \param input Content of the file that is being compressed
+ * \param inputSize Size of input
+ * \param model Context model created from input
+ * \param fileOutput File where is written the compressed version of input
+ * \return The number of bytes written in fileOutput
+ */
+
+uint64_t contextCompression(const unsigned char* input, size_t inputSize, ContextModel* model, FILE* fileOutput)
+{
+    HuffmanCode* codeTables=NULL; // N_VALUES_IN_BYTE codes per table
+    HuffmanCode* contextCodes[N_VALUES_IN_BYTE];
+    unsigned char* outputBuffer=NULL;
+    BitWriter writer;
+
+    MALLOC(codeTables, HuffmanCode, model->nbTables*N_VALUES_IN_BYTE);
+    MALLOC(outputBuffer, unsigned char, IO_BUFFER_SIZE);
+    createContextCodeTables(model, codeTables, contextCodes);
+    initializeBitWriter(&writer, fileOutput, outputBuffer, IO_BUFFER_SIZE);
+    encodeContextSymbols(&writer, input, inputSize, contextCodes);
+    flushBitWriter(&writer);
+    free(outputBuffer);
+    free(codeTables);
+    return writer.nbWrittenBytes;
+}
+
+/**
+ * \fn void contextDecompression(FILE* fileInput, const unsigned char* input, size_t inputSize, uint64_t fileSize, ContextModel* model, FILE* fileOutput)
+ * \brief Decompresses data compressed by contextCompression
+ * \param fileInput Compressed file, read by blocks from its current position, just after the context section. If it's NULL then input is used instead
+ * \param input Compressed data, after the context section. It's only used if fileInput is NULL
+ * \param inputSize Size of input
+ * \param fileSize Number of characters that the decompressed file will contain
+ * \param model Context model read from the context section
+ * \param fileOutput File where is written the decompressed version of the source file
+ */
+
+void contextDecompression(FILE* fileInput, const unsigned char* input, size_t inputSize, uint64_t fileSize, ContextModel* model, FILE* fileOutput)
+{
+    HuffmanDecoder* decoders=NULL;
+    HuffmanDecoder* contextDecoders[N_VALUES_IN_BYTE];
+    BitReader reader;
+    unsigned char* outputBuffer=NULL;
+    unsigned char previous=0;
+    size_t nbChars=0;
+
+    decoders=createContextDecoders(model, contextDecoders);
+    initializeBitReader(&reader, fileInput, input, inputSize);
+    MALLOC(outputBuffer, unsigned char, IO_BUFFER_SIZE);
+    while(fileSize>0){
+        nbChars=(fileSize<IO_BUFFER_SIZE) ? fileSize : IO_BUFFER_SIZE;
+        if(decodeContextSymbols(contextDecoders, &reader, outputBuffer, nbChars, &previous)<0){
+            fprintf(stderr, "ERROR: the compressed data is incorrect or truncated\n");
+            exit(EXIT_FAILURE);
+        }
+        fwriteAndCheck(outputBuffer, nbChars, fileOutput);
+        fileSize-=nbChars;
+    }
+    free(outputBuffer);
+    freeBitReader(&reader);
+    free(decoders);
+}
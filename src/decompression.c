@@ -7,24 +7,602 @@
 #include "../include/types.h"
 #include "../include/macros_constants_headers.h"
 #include "../include/huffman_coding_table.h"
+#include "../include/compression.h"
+#include "../include/file_functions.h"
 #include "../include/decompression.h"
 
 /**
- * \fn void huffManDecompression(FILE* fileInput, int fileSize, TreeNode* treeHead, FILE* fileOutput)
- * \brief Decompresses a file compressed by using Huffman
+ * \fn void initializeBitReader(BitReader* reader, FILE* file, const unsigned char* content, size_t size)
+ * \brief Initializes a bit reader and fills its 64 bits buffer with the first bits
+ * \param reader Bit reader that is initialized
+ * \param file File from which the bits will be read. Its current position is the first byte read. If it's NULL, the bits are read from content
+ * \param content Bytes from which the bits are read when there is no file. It's not freed by the reader
+ * \param size Size of content
+ */
+
+void initializeBitReader(BitReader* reader, FILE* file, const unsigned char* content, size_t size)
+{
+    reader->file=file;
+    if(file!=NULL){
+        MALLOC(reader->content, unsigned char, IO_BUFFER_SIZE);
+        reader->size=0;
+    }
+    else{
+        reader->content=(unsigned char*) content;
+        reader->size=size;
+    }
+    reader->index=0;
+    reader->bits=0;
+    reader->nbBits=0;
+    fillBitReader(reader);
+}
+
+/**
+ * \fn void fillBitReader(BitReader* reader)
+ * \brief Adds bytes to the 64 bits buffer of the reader until it contains at least 57 bits or until the end of the file is reached
+ * \param reader Bit reader that is filled. When the file ends, the missing bits are 0
+ */
+
+void fillBitReader(BitReader* reader)
+{
+    uint64_t word=0;
+    int nbBytes=0;
+
+    if(reader->nbBits<0) // More bits than the file contains were read, there is nothing left to add
+        return;
+    if(reader->nbBits<=56 && reader->index+8<=reader->size){ // Fast path: 8 bytes are loaded at once. The bits after the new nbBits are added again by the next call, which doesn't change them
+#if defined(__GNUC__) && __BYTE_ORDER__==__ORDER_LITTLE_ENDIAN__
+        memcpy(&word, reader->content+reader->index, 8);
+        word=__builtin_bswap64(word); // The first byte read is the most significant one
+#else
+        for(int i=0; i<8; i++)
+            word=(word<<8)|reader->content[reader->index+i];
+#endif
+        nbBytes=(63-reader->nbBits)>>3;
+        reader->bits|=word>>reader->nbBits;
+        reader->index+=nbBytes;
+        reader->nbBits+=nbBytes*8;
+        return;
+    }
+    while(reader->nbBits<=56){
+        if(reader->index>=reader->size){
+            if(reader->file==NULL) // All the bytes of content were read
+                break;
+            reader->size=fread(reader->content, 1, IO_BUFFER_SIZE, reader->file);
+            reader->index=0;
+            if(reader->size==0)
+                break;
+        }
+        reader->bits|=((uint64_t) reader->content[reader->index])<<(56-reader->nbBits);
+        reader->index++;
+        reader->nbBits+=8;
+    }
+}
+
+/**
+ * \fn void freeBitReader(BitReader* reader)
+ * \brief Frees the buffer of the reader if it was allocated by the reader. The file is not closed
+ * \param reader Bit reader that is freed
+ */
+
+void freeBitReader(BitReader* reader)
+{
+    if(reader->file!=NULL)
+        free(reader->content);
+    reader->content=NULL;
+}
+
+/**
+ * \fn void alignBitReader(BitReader* reader)
+ * \brief Skips the bits left in the current byte, so that the next bit read is the first one of the next byte, where the next bitstream starts
+ * \param reader Bit reader that is aligned
+ */
+
+void alignBitReader(BitReader* reader)
+{
+    int nbPaddingBits=0;
+
+    if(reader->nbBits<=0)
+        return;
+    nbPaddingBits=reader->nbBits&7; // The bytes are added whole, so the bits read since the last byte boundary are the ones missing to make nbBits a multiple of 8
+    reader->bits<<=nbPaddingBits;
+    reader->nbBits-=nbPaddingBits;
+}
+
+/**
+ * \fn void createHuffmanDecoder(unsigned char codeLengths[N_VALUES_IN_BYTE], uint64_t nbChars, HuffmanDecoder* decoder)
+ * \brief Creates the tables used to decode the canonical codes directly from their lengths. The multi-symbol table is also created when the codes are short enough and there are enough characters for it to be faster
+ * \param codeLengths Array linking each character to the length of its code. They must have been checked with checkCodeLengths
+ * \param nbChars Number of characters that will be decoded with this decoder
+ * \param decoder Decoder that is filled
+ */
+
+void createHuffmanDecoder(unsigned char codeLengths[N_VALUES_IN_BYTE], uint64_t nbChars, HuffmanDecoder* decoder)
+{
+    HuffmanCode codeTable[N_VALUES_IN_BYTE];
+    int nextIndex[MAX_CODE_LENGTH+1];
+    unsigned int firstEntry=0;
+    unsigned int nbEntries=0;
+    double averageLength=0;
+
+    for(int length=0; length<=MAX_CODE_LENGTH; length++)
+        decoder->nbCodesOfLength[length]=0;
+    for(int i=0; i<N_VALUES_IN_BYTE; i++)
+        decoder->nbCodesOfLength[codeLengths[i]]++;
+    decoder->nbCodesOfLength[0]=0;
+
+    decoder->firstCode[0]=0;
+    decoder->firstIndex[0]=0;
+    decoder->lastCodeShifted[0]=0;
+    decoder->maxLength=0;
+    for(int length=1; length<=MAX_CODE_LENGTH; length++){
+        decoder->firstCode[length]=(decoder->firstCode[length-1]+decoder->nbCodesOfLength[length-1])<<1;
+        decoder->firstIndex[length]=decoder->firstIndex[length-1]+decoder->nbCodesOfLength[length-1];
+        nextIndex[length]=decoder->firstIndex[length];
+        decoder->lastCodeShifted[length]=((decoder->firstCode[length]+decoder->nbCodesOfLength[length])<<(64-length))-1;
+        if(decoder->nbCodesOfLength[length]>0)
+            decoder->maxLength=length;
+    }
+    for(int i=0; i<N_VALUES_IN_BYTE; i++){
+        if(codeLengths[i]>0){
+            decoder->sortedChars[nextIndex[codeLengths[i]]]=i;
+            nextIndex[codeLengths[i]]++;
+        }
+    }
+
+    for(int i=0; i<DECODE_TABLE_SIZE; i++){
+        decoder->table[i].c=0;
+        decoder->table[i].length=0; // Indexes that start a longer code are decoded by comparing the bits with lastCodeShifted
+    }
+    createCanonicalCodeTable(codeLengths, codeTable);
+    for(int i=0; i<N_VALUES_IN_BYTE; i++){
+        if(codeTable[i].length>0 && codeTable[i].length<=DECODE_TABLE_BITS){ // All the indexes starting with the code decode it
+            firstEntry=codeTable[i].code<<(DECODE_TABLE_BITS-codeTable[i].length);
+            nbEntries=1u<<(DECODE_TABLE_BITS-codeTable[i].length);
+            for(unsigned int j=firstEntry; j<firstEntry+nbEntries; j++){
+                decoder->table[j].c=i;
+                decoder->table[j].length=codeTable[i].length;
+            }
+        }
+    }
+
+    for(int length=1; length<=decoder->maxLength; length++) // Each code of length l is used with a probability close to 2^-l
+        averageLength+=decoder->nbCodesOfLength[length]*length/(double) (1ull<<length);
+    decoder->useMultiTable=(averageLength<=MULTI_DECODE_MAX_AVERAGE_LENGTH && nbChars>=MULTI_DECODE_MIN_CHARS);
+    if(decoder->useMultiTable)
+        createMultiDecodeTable(decoder);
+}
+
+/**
+ * \fn void createMultiDecodeTable(HuffmanDecoder* decoder)
+ * \brief Creates the table decoding up to MAX_SYMBOLS_PER_LOOKUP characters per lookup, from the single-symbol table. Each entry holds the codes that are entirely in its index, one after the other
+ * \param decoder Decoder whose table is already created and whose multiTable is filled
+ */
+
+void createMultiDecodeTable(HuffmanDecoder* decoder)
+{
+    DecodeTableEntry entry;
+    MultiDecodeTableEntry* multiEntry=NULL;
+
+    for(unsigned int i=0; i<DECODE_TABLE_SIZE; i++){
+        multiEntry=&decoder->multiTable[i];
+        multiEntry->nbSymbols=0;
+        multiEntry->length=0;
+        while(multiEntry->nbSymbols<MAX_SYMBOLS_PER_LOOKUP){
+            entry=decoder->table[(i<<multiEntry->length)&(DECODE_TABLE_SIZE-1)]; // The bits after the index are 0, so the code is only complete if it fits in the index
+            if(entry.length==0 || multiEntry->length+entry.length>DECODE_TABLE_BITS)
+                break;
+            multiEntry->symbols[multiEntry->nbSymbols]=entry.c;
+            multiEntry->nbSymbols++;
+            multiEntry->length+=entry.length;
+        }
+        for(int j=multiEntry->nbSymbols; j<MAX_SYMBOLS_PER_LOOKUP; j++)
+            multiEntry->symbols[j]=0;
+    }
+}
+
+/**
+ * \fn int decodeLongCode(HuffmanDecoder* decoder, uint64_t bits, unsigned char* c)
+ * \brief Decodes a code longer than DECODE_TABLE_BITS: its length is the first one whose last code is greater or equal to the bits read
+ * \param decoder Decoder created from the lengths of the codes
+ * \param bits Bits starting with the code
+ * \param c Receives the decoded character
+ * \return The length of the code, or -1 if the bits don't start with a code
+ */
+
+int decodeLongCode(HuffmanDecoder* decoder, uint64_t bits, unsigned char* c)
+{
+    int length=DECODE_TABLE_BITS+1;
+
+    while(length<=decoder->maxLength && (decoder->nbCodesOfLength[length]==0 || bits>decoder->lastCodeShifted[length]))
+        length++;
+    if(length>decoder->maxLength) // Incorrect code
+        return -1;
+    *c=decoder->sortedChars[decoder->firstIndex[length]+(bits>>(64-length))-decoder->firstCode[length]];
+    return length;
+}
+
+/**
+ * \fn int decodeSymbols(HuffmanDecoder* decoder, BitReader* reader, unsigned char* output, size_t nbChars)
+ * \brief Decodes characters by decoding DECODE_TABLE_BITS bits at once with the decode table. When the decoder has a multi-symbol table, each lookup decodes all the codes that fit in these bits
+ * \param decoder Decoder created from the lengths of the codes
+ * \param reader Bit reader from which the codes are read
+ * \param output Buffer where the decoded characters are written
+ * \param nbChars Number of characters that are decoded
+ * \return 0 if the characters were decoded, -1 if the compressed data contains an incorrect code or is too short
+ */
+
+int decodeSymbols(HuffmanDecoder* decoder, BitReader* reader, unsigned char* output, size_t nbChars)
+{
+    DecodeTableEntry entry;
+    uint64_t bits=reader->bits;
+    int nbBits=reader->nbBits;
+    const MultiDecodeTableEntry* multiEntry=NULL;
+    int length=0;
+    int nbLookups=0;
+    size_t i=0;
+
+    while(i<nbChars){
+        if(nbBits<=56){
+            reader->bits=bits;
+            reader->nbBits=nbBits;
+            fillBitReader(reader);
+            bits=reader->bits;
+            nbBits=reader->nbBits;
+        }
+        if(nbBits>=LOOKUPS_PER_REFILL*DECODE_TABLE_BITS){ // Fast path: several lookups can be done before filling the reader again, and the bits can't run out
+            nbLookups=0;
+            if(decoder->useMultiTable){
+                while(nbLookups<LOOKUPS_PER_REFILL && i+MAX_SYMBOLS_PER_LOOKUP<=nbChars){ // MAX_SYMBOLS_PER_LOOKUP characters are always written
+                    multiEntry=&decoder->multiTable[bits>>(64-DECODE_TABLE_BITS)];
+                    if(multiEntry->nbSymbols==0)
+                        break;
+                    memcpy(output+i, multiEntry->symbols, MAX_SYMBOLS_PER_LOOKUP);
+                    i+=multiEntry->nbSymbols;
+                    bits<<=multiEntry->length;
+                    nbBits-=multiEntry->length;
+                    nbLookups++;
+                }
+            }
+            else{
+                while(nbLookups<LOOKUPS_PER_REFILL && i<nbChars){
+                    entry=decoder->table[bits>>(64-DECODE_TABLE_BITS)];
+                    if(entry.length==0)
+                        break;
+                    output[i]=entry.c;
+                    i++;
+                    bits<<=entry.length;
+                    nbBits-=entry.length;
+                    nbLookups++;
+                }
+            }
+            if(nbLookups==LOOKUPS_PER_REFILL || i>=nbChars)
+                continue;
+            if(nbLookups>0) // The next code is long or is near the end of output, the reader is filled before decoding it
+                continue;
+        }
+        entry=decoder->table[bits>>(64-DECODE_TABLE_BITS)];
+        if(entry.length!=0){ // The whole code is in the index
+            output[i]=entry.c;
+            bits<<=entry.length;
+            nbBits-=entry.length;
+        }
+        else{ // Slow path
+            length=decodeLongCode(decoder, bits, output+i);
+            if(length<0)
+                return -1;
+            bits<<=length;
+            nbBits-=length;
+        }
+        if(nbBits<0) // That means that we have finished reading all the compressed data but we still haven't written all the characters, so it's an error
+            return -1;
+        i++;
+    }
+    reader->bits=bits;
+    reader->nbBits=nbBits;
+    return 0;
+}
+
+/**
+ * \fn int decodeLongCodeFromReader(HuffmanDecoder* decoder, BitReader* reader, unsigned char* c)
+ * \brief Decodes a code longer than DECODE_TABLE_BITS from a bit reader, which is filled before and after it so that the next lookups still have enough bits
+ * \param decoder Decoder created from the lengths of the codes
+ * \param reader Bit reader whose bits start with the code
+ * \param c Receives the decoded character
+ * \return 0 if the character was decoded, -1 if the bits don't start with a code
+ */
+
+int decodeLongCodeFromReader(HuffmanDecoder* decoder, BitReader* reader, unsigned char* c)
+{
+    int length=0;
+
+    fillBitReader(reader);
+    length=decodeLongCode(decoder, reader->bits, c);
+    if(length<0)
+        return -1;
+    reader->bits<<=length;
+    reader->nbBits-=length;
+    fillBitReader(reader);
+    return 0;
+}
+
+/**
+ * \fn int decodeInterleavedSymbols(HuffmanDecoder* decoder, BitReader readers[NB_INTERLEAVED_BITSTREAMS], unsigned char* outputs[NB_INTERLEAVED_BITSTREAMS], size_t nbChars[NB_INTERLEAVED_BITSTREAMS])
+ * \brief Decodes characters from NB_INTERLEAVED_BITSTREAMS bitstreams at once. Each iteration does a lookup in each bitstream, and these lookups don't depend on each other, so the processor runs them in parallel. The end of each bitstream is decoded by decodeSymbols
+ * \param decoder Decoder created from the lengths of the codes, shared by the bitstreams
+ * \param readers Bit reader of each bitstream
+ * \param outputs Buffer where the characters of each bitstream are written
+ * \param nbChars Number of characters decoded from each bitstream
+ * \return 0 if the characters were decoded, -1 if the compressed data contains an incorrect code or is too short
+ */
+
+int decodeInterleavedSymbols(HuffmanDecoder* decoder, BitReader readers[NB_INTERLEAVED_BITSTREAMS], unsigned char* outputs[NB_INTERLEAVED_BITSTREAMS], size_t nbChars[NB_INTERLEAVED_BITSTREAMS])
+{
+    uint64_t bits[NB_INTERLEAVED_BITSTREAMS]; // The state of the readers is kept in local variables during the lookups, so that it stays in registers
+    int nbBits[NB_INTERLEAVED_BITSTREAMS];
+    size_t positions[NB_INTERLEAVED_BITSTREAMS];
+    const MultiDecodeTableEntry* multiEntry=NULL;
+    DecodeTableEntry entry;
+    int canContinue=1;
+
+    for(int k=0; k<NB_INTERLEAVED_BITSTREAMS; k++)
+        positions[k]=0;
+    while(canContinue){
+        for(int k=0; k<NB_INTERLEAVED_BITSTREAMS; k++){
+            fillBitReader(&readers[k]);
+            if(nbChars[k]-positions[k]<LOOKUPS_PER_REFILL*MAX_SYMBOLS_PER_LOOKUP || readers[k].nbBits<LOOKUPS_PER_REFILL*DECODE_TABLE_BITS) // Near the end of a bitstream, the characters are decoded one by one
+                canContinue=0;
+        }
+        if(!canContinue)
+            break;
+        for(int k=0; k<NB_INTERLEAVED_BITSTREAMS; k++){
+            bits[k]=readers[k].bits;
+            nbBits[k]=readers[k].nbBits;
+        }
+        // The loops on the bitstreams are unrolled so that the lookups of the different bitstreams are next to each other
+        if(decoder->useMultiTable){
+            for(int n=0; n<LOOKUPS_PER_REFILL; n++){
+                #pragma GCC unroll 4
+                for(int k=0; k<NB_INTERLEAVED_BITSTREAMS; k++){
+                    multiEntry=&decoder->multiTable[bits[k]>>(64-DECODE_TABLE_BITS)];
+                    if(multiEntry->nbSymbols>0){
+                        memcpy(outputs[k]+positions[k], multiEntry->symbols, MAX_SYMBOLS_PER_LOOKUP);
+                        positions[k]+=multiEntry->nbSymbols;
+                        bits[k]<<=multiEntry->length;
+                        nbBits[k]-=multiEntry->length;
+                    }
+                    else{ // The code is longer than DECODE_TABLE_BITS
+                        readers[k].bits=bits[k];
+                        readers[k].nbBits=nbBits[k];
+                        if(decodeLongCodeFromReader(decoder, &readers[k], outputs[k]+positions[k])<0)
+                            return -1;
+                        positions[k]++;
+                        bits[k]=readers[k].bits;
+                        nbBits[k]=readers[k].nbBits;
+                    }
+                }
+            }
+        }
+        else{
+            for(int n=0; n<LOOKUPS_PER_REFILL; n++){
+                #pragma GCC unroll 4
+                for(int k=0; k<NB_INTERLEAVED_BITSTREAMS; k++){
+                    entry=decoder->table[bits[k]>>(64-DECODE_TABLE_BITS)];
+                    if(entry.length>0){
+                        outputs[k][positions[k]]=entry.c;
+                        positions[k]++;
+                        bits[k]<<=entry.length;
+                        nbBits[k]-=entry.length;
+                    }
+                    else{ // The code is longer than DECODE_TABLE_BITS
+                        readers[k].bits=bits[k];
+                        readers[k].nbBits=nbBits[k];
+                        if(decodeLongCodeFromReader(decoder, &readers[k], outputs[k]+positions[k])<0)
+                            return -1;
+                        positions[k]++;
+                        bits[k]=readers[k].bits;
+                        nbBits[k]=readers[k].nbBits;
+                    }
+                }
+            }
+        }
+        for(int k=0; k<NB_INTERLEAVED_BITSTREAMS; k++){
+            if(nbBits[k]<0)
+                return -1;
+            readers[k].bits=bits[k];
+            readers[k].nbBits=nbBits[k];
+        }
+    }
+    for(int k=0; k<NB_INTERLEAVED_BITSTREAMS; k++){
+        if(decodeSymbols(decoder, &readers[k], outputs[k]+positions[k], nbChars[k]-positions[k])<0)
+            return -1;
+    }
+    return 0;
+}
+
+/**
+ * \fn int initializeBitstreamReaders(const unsigned char* input, size_t inputSize, uint64_t* bitstreamSizes, BitReader readers[NB_INTERLEAVED_BITSTREAMS])
+ * \brief Initializes a bit reader on each bitstream of interleaved data, the bitstreams being one after the other
+ * \param input Compressed data, starting with the first bitstream
+ * \param inputSize Size of input. The last bitstream takes what the other ones leave
+ * \param bitstreamSizes Size of each bitstream but the last one
+ * \param readers Bit readers that are initialized
+ * \return 0 if the bitstreams are in input, -1 if their sizes are incorrect
+ */
+
+int initializeBitstreamReaders(const unsigned char* input, size_t inputSize, uint64_t* bitstreamSizes, BitReader readers[NB_INTERLEAVED_BITSTREAMS])
+{
+    uint64_t offset=0;
+
+    for(int k=0; k<NB_INTERLEAVED_BITSTREAMS-1; k++){
+        if(bitstreamSizes[k]>inputSize-offset)
+            return -1;
+        initializeBitReader(&readers[k], NULL, input+offset, bitstreamSizes[k]);
+        offset+=bitstreamSizes[k];
+    }
+    initializeBitReader(&readers[NB_INTERLEAVED_BITSTREAMS-1], NULL, input+offset, inputSize-offset);
+    return 0;
+}
+
+/**
+ * \fn int decodeBitstreams(HuffmanDecoder* decoder, const unsigned char* input, size_t inputSize, int nbBitstreams, uint64_t* bitstreamSizes, unsigned char* output, size_t nbChars)
+ * \brief Decodes compressed data in memory, made of one bitstream or of NB_INTERLEAVED_BITSTREAMS bitstreams decoded at once
+ * \param decoder Decoder created from the lengths of the codes
+ * \param input Compressed data
+ * \param inputSize Size of input
+ * \param nbBitstreams 1 or NB_INTERLEAVED_BITSTREAMS
+ * \param bitstreamSizes Size of each bitstream but the last one. It's not used if there is only one bitstream
+ * \param output Buffer where the decoded characters are written
+ * \param nbChars Number of characters that are decoded
+ * \return 0 if the characters were decoded, -1 if the compressed data is incorrect or too short
+ */
+
+int decodeBitstreams(HuffmanDecoder* decoder, const unsigned char* input, size_t inputSize, int nbBitstreams, uint64_t* bitstreamSizes, unsigned char* output, size_t nbChars)
+{
+    BitReader readers[NB_INTERLEAVED_BITSTREAMS];
+    unsigned char* outputs[NB_INTERLEAVED_BITSTREAMS];
+    size_t nbCharsOfBitstreams[NB_INTERLEAVED_BITSTREAMS];
+
+    if(nbBitstreams==1){
+        initializeBitReader(&readers[0], NULL, input, inputSize);
+        return decodeSymbols(decoder, &readers[0], output, nbChars);
+    }
+    if(initializeBitstreamReaders(input, inputSize, bitstreamSizes, readers)<0)
+        return -1;
+    for(int k=0; k<NB_INTERLEAVED_BITSTREAMS; k++){
+        outputs[k]=output;
+        nbCharsOfBitstreams[k]=getBitstreamLength(nbChars, k, NB_INTERLEAVED_BITSTREAMS);
+        output+=nbCharsOfBitstreams[k];
+    }
+    return decodeInterleavedSymbols(decoder, readers, outputs, nbCharsOfBitstreams);
+}
+
+/**
+ * \fn void huffManDecompression(FILE* fileInput, const unsigned char* input, size_t inputSize, uint64_t fileSize, int nbBitstreams, HuffmanDecoder* decoder, FILE* fileOutput)
+ * \brief Decompresses data compressed by using canonical Huffman codes. The bitstreams are decoded one after the other, so that they can be read from a stream and written in order
+ * \param fileInput Compressed file, read by blocks from its current position. If it's NULL then input is used instead
+ * \param input Compressed data, after the header of the compressed file. It's only used if fileInput is NULL
+ * \param inputSize Size of input
+ * \param fileSize Number of characters that the decompressed file will contain
+ * \param nbBitstreams Number of bitstreams in which the characters are encoded
+ * \param decoder Decoder created from the lengths of the codes
+ * \param fileOutput File where is written the decompressed version of the source file
+ */
+
+void huffManDecompression(FILE* fileInput, const unsigned char* input, size_t inputSize, uint64_t fileSize, int nbBitstreams, HuffmanDecoder* decoder, FILE* fileOutput)
+{
+    BitReader reader;
+    unsigned char* outputBuffer=NULL;
+    uint64_t nbRemainingChars=0;
+    size_t nbChars=0;
+
+    initializeBitReader(&reader, fileInput, input, inputSize);
+    MALLOC(outputBuffer, unsigned char, IO_BUFFER_SIZE);
+
+    for(int k=0; k<nbBitstreams; k++){
+        nbRemainingChars=getBitstreamLength(fileSize, k, nbBitstreams);
+        while(nbRemainingChars>0){
+            nbChars=(nbRemainingChars<IO_BUFFER_SIZE) ? nbRemainingChars : IO_BUFFER_SIZE;
+            if(decodeSymbols(decoder, &reader, outputBuffer, nbChars)<0){
+                fprintf(stderr, "ERROR: the compressed data is incorrect or truncated\n");
+                exit(EXIT_FAILURE);
+            }
+            if(fwrite(outputBuffer, 1, nbChars, fileOutput)<nbChars){
+                fprintf(stderr, "ERROR: fwrite can't write in the output file in huffManDecompression\n");
+                exit(EXIT_FAILURE);
+            }
+            nbRemainingChars-=nbChars;
+        }
+        alignBitReader(&reader);
+    }
+    free(outputBuffer);
+    freeBitReader(&reader);
+}
+
+/**
+ * \fn void huffManDecompressionInterleaved(const unsigned char* input, size_t inputSize, uint64_t fileSize, uint64_t* bitstreamSizes, HuffmanDecoder* decoder, FILE* fileOutput)
+ * \brief Decompresses data split in NB_INTERLEAVED_BITSTREAMS bitstreams by decoding them at once. Each round decodes a part of each bitstream, and these parts are written at their position in fileOutput
+ * \param input Compressed data, after the header of the compressed file
+ * \param inputSize Size of input
+ * \param fileSize Number of characters that the decompressed file will contain
+ * \param bitstreamSizes Size of each bitstream but the last one, read from the header
+ * \param decoder Decoder created from the lengths of the codes
+ * \param fileOutput Regular file where is written the decompressed version of the source file. Nothing must have been written in it
+ */
+
+void huffManDecompressionInterleaved(const unsigned char* input, size_t inputSize, uint64_t fileSize, uint64_t* bitstreamSizes, HuffmanDecoder* decoder, FILE* fileOutput)
+{
+    BitReader readers[NB_INTERLEAVED_BITSTREAMS];
+    unsigned char* outputBuffer=NULL;
+    unsigned char* outputs[NB_INTERLEAVED_BITSTREAMS];
+    size_t nbChars[NB_INTERLEAVED_BITSTREAMS];
+    uint64_t nbRemainingChars[NB_INTERLEAVED_BITSTREAMS];
+    uint64_t outputOffsets[NB_INTERLEAVED_BITSTREAMS];
+    uint64_t offset=0;
+    int isDone=0;
+
+    if(initializeBitstreamReaders(input, inputSize, bitstreamSizes, readers)<0){
+        fprintf(stderr, "ERROR: the data read from the file header is incorrect\n");
+        exit(EXIT_FAILURE);
+    }
+    MALLOC(outputBuffer, unsigned char, NB_INTERLEAVED_BITSTREAMS*IO_BUFFER_SIZE);
+    for(int k=0; k<NB_INTERLEAVED_BITSTREAMS; k++){
+        outputs[k]=outputBuffer+k*IO_BUFFER_SIZE;
+        nbRemainingChars[k]=getBitstreamLength(fileSize, k, NB_INTERLEAVED_BITSTREAMS);
+        outputOffsets[k]=offset;
+        offset+=nbRemainingChars[k];
+    }
+    fflush(fileOutput);
+
+    while(!isDone){
+        isDone=1;
+        for(int k=0; k<NB_INTERLEAVED_BITSTREAMS; k++){
+            nbChars[k]=(nbRemainingChars[k]<IO_BUFFER_SIZE) ? nbRemainingChars[k] : IO_BUFFER_SIZE;
+            if(nbChars[k]>0)
+                isDone=0;
+        }
+        if(decodeInterleavedSymbols(decoder, readers, outputs, nbChars)<0){
+            fprintf(stderr, "ERROR: the compressed data is incorrect or truncated\n");
+            exit(EXIT_FAILURE);
+        }
+        for(int k=0; k<NB_INTERLEAVED_BITSTREAMS; k++){
+            if(nbChars[k]>0)
+                pwriteAndCheck(fileno(fileOutput), outputs[k], nbChars[k], outputOffsets[k]);
+            outputOffsets[k]+=nbChars[k];
+            nbRemainingChars[k]-=nbChars[k];
+        }
+    }
+    free(outputBuffer);
+}
+
+/**
+ * \fn void huffManDecompressionTreeWalk(FILE* fileInput, uint64_t fileSize, int nbBitstreams, TreeNode* treeHead, FILE* fileOutput)
+ * \brief Decompresses a file compressed by using Huffman by walking in the tree bit by bit. It's slower than huffManDecompression but it's kept to check its results and to decompress the files of version 1
  * \param fileInput Compressed file that we want to decompress
  * \param fileSize Number of characters that the decompressed file will contain
+ * \param nbBitstreams Number of bitstreams in which the characters are encoded, 1 for the files of version 1
  * \param treeHead The head of the Huffman tree that is needed to decompress the file
  * \param fileOutput File where is written the decompressed version of the source file
  */
 
-void huffManDecompression(FILE* fileInput, int fileSize, TreeNode* treeHead, FILE* fileOutput){
+void huffManDecompressionTreeWalk(FILE* fileInput, uint64_t fileSize, int nbBitstreams, TreeNode* treeHead, FILE* fileOutput){
     int bit_Position = 7;
-    int nbr_insert_char = 0;
+    uint64_t nbr_insert_char = 0;
+    uint64_t end_Of_Bitstream = getBitstreamLength(fileSize, 0, nbBitstreams); // Number of characters decoded at the end of the current bitstream
+    int i_Bitstream = 0;
     unsigned char c = fgetc(fileInput); //It will get the first byte of fileInput    
     TreeNode* tree_travel = treeHead;
 
     while(fileSize > nbr_insert_char){
+        if(nbr_insert_char == end_Of_Bitstream){ // The next bitstream starts at the next byte
+            if(bit_Position != 7){
+                bit_Position = 7;
+                c = fgetc(fileInput);
+            }
+            i_Bitstream++;
+            end_Of_Bitstream += getBitstreamLength(fileSize, i_Bitstream, nbBitstreams);
+            continue;
+        }
         if((c >> bit_Position)&1){             
             tree_travel = tree_travel->right;
         } 
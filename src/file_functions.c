@@ -1,19 +1,22 @@
 /**
  * \file file_functions.c
- * \brief Contains functions used to open and close a file, and to get its name and its size
+ * \brief Contains functions used to open, read, write and close a file, and to get its name and its size
  * \date 2021
  */
 
+#include "../include/types.h"
 #include "../include/macros_constants_headers.h"
 #include "../include/file_functions.h"
+#include <unistd.h>  // Used for pwrite
+#include <sys/stat.h>  // Used for fstat
 
 /**
- * \fn void getFileName(unsigned char fileName[FILENAME_MAX])
+ * \fn void getFileName(char fileName[FILENAME_MAX])
  * \brief Gets the name of a file
  * \param fileName Array of characters that will contain the name of the file to open
  */
 
-void getFileName(unsigned char fileName[FILENAME_MAX])
+void getFileName(char fileName[FILENAME_MAX])
 {
     char *posEndOfInput=NULL;
     if(!fgets(fileName, FILENAME_MAX, stdin)){
@@ -26,21 +29,34 @@ void getFileName(unsigned char fileName[FILENAME_MAX])
 }
 
 /**
- * \fn int getSizeOfFile(FILE* file)
+ * \fn uint64_t getSizeOfFile(FILE* file)
  * \brief Gives the size of a file
  * \param file File whose size has to be determined
  * \return Size of the file: number of bytes that it contains
  */
 
-int getSizeOfFile(FILE* file)
+uint64_t getSizeOfFile(FILE* file)
 {
     rewind(file);
-    fseek(file, 0, SEEK_END);
-    int size = (int) ftell(file);
+    fseeko(file, 0, SEEK_END);
+    uint64_t size = (uint64_t) ftello(file);
     rewind(file);
     return size;
 }
 
+/**
+ * \fn int isRegularFile(FILE* file)
+ * \brief Tells if a file is a regular file, where the characters can be written at their position with pwrite. Pipes, FIFOs, terminals and the other character devices, e.g. /dev/stdout, are written one character after the other
+ * \param file File that is tested
+ * \return 1 if file is a regular file, 0 otherwise
+ */
+
+int isRegularFile(FILE* file)
+{
+    struct stat status;
+    return fileno(file)>=0 && fstat(fileno(file), &status)==0 && S_ISREG(status.st_mode);
+}
+
 /**
  * \fn void checkFopen(FILE* file)
  * \brief Checks if a file was opened correctly, if not then the program is stopped
@@ -69,3 +85,89 @@ void fcloseAndCheck(FILE* file)
     }
 }
 
+
+/**
+ * \fn void writeLittleEndian(unsigned char* buffer, uint64_t value, int nbBytes)
+ * \brief Writes an integer in a buffer, starting with its least significant byte
+ * \param buffer Buffer where the integer is written. It must contain at least nbBytes bytes
+ * \param value Integer that is written
+ * \param nbBytes Number of bytes used to write the integer
+ */
+
+void writeLittleEndian(unsigned char* buffer, uint64_t value, int nbBytes)
+{
+    for(int i=0; i<nbBytes; i++)
+        buffer[i]=(unsigned char) (value>>(8*i));
+}
+
+/**
+ * \fn uint64_t readLittleEndian(const unsigned char* buffer, int nbBytes)
+ * \brief Reads an integer written by writeLittleEndian
+ * \param buffer Buffer from which the integer is read
+ * \param nbBytes Number of bytes used to write the integer
+ * \return The integer read
+ */
+
+uint64_t readLittleEndian(const unsigned char* buffer, int nbBytes)
+{
+    uint64_t value=0;
+    for(int i=nbBytes-1; i>=0; i--)
+        value=(value<<8)|buffer[i];
+    return value;
+}
+
+/**
+ * \fn void fwriteAndCheck(const void* buffer, size_t size, FILE* file)
+ * \brief Writes a buffer in a file and checks if it was done properly, if not then the program is stopped
+ * \param buffer Buffer that is written
+ * \param size Number of bytes written
+ * \param file File where the buffer is written
+ */
+
+void fwriteAndCheck(const void* buffer, size_t size, FILE* file)
+{
+    if(size>0 && fwrite(buffer, 1, size, file)<size){
+        fprintf(stderr, "ERROR: fwrite can't write in the output file\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * \fn void freadAndCheck(void* buffer, size_t size, FILE* file)
+ * \brief Reads bytes from a file and checks that all of them were read, if not then the program is stopped
+ * \param buffer Buffer where the bytes are saved
+ * \param size Number of bytes read
+ * \param file File from which the bytes are read
+ */
+
+void freadAndCheck(void* buffer, size_t size, FILE* file)
+{
+    if(size>0 && fread(buffer, 1, size, file)<size){
+        fprintf(stderr, "ERROR: fread can't read the input file, it may be truncated\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * \fn void pwriteAndCheck(int fileDescriptor, const void* buffer, size_t size, off_t offset)
+ * \brief Writes bytes at a given position of a file without changing its position, so that several threads can write it at the same time. If all the bytes can't be written then the program is stopped
+ * \param fileDescriptor File descriptor of the file where the bytes are written
+ * \param buffer Buffer containing the bytes
+ * \param size Number of bytes written
+ * \param offset Position in the file where the first byte is written
+ */
+
+void pwriteAndCheck(int fileDescriptor, const void* buffer, size_t size, off_t offset)
+{
+    ssize_t nbWrittenBytes=0;
+    while(size>0){
+        nbWrittenBytes=pwrite(fileDescriptor, buffer, size, offset);
+        if(nbWrittenBytes<=0){
+            fprintf(stderr, "ERROR: pwrite can't write in the output file\n");
+            exit(EXIT_FAILURE);
+        }
+        buffer=((const unsigned char*) buffer)+nbWrittenBytes;
+        size-=nbWrittenBytes;
+        offset+=nbWrittenBytes;
+    }
+}
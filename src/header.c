@@ -0,0 +1,192 @@
+/**
+ * \file header.c
+ * \brief Contains the functions that save and read the binary header of the compressed files
+ * \date 2021
+ */
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/file_functions.h"
+#include "../include/huffman_coding_table.h"
+#include "../include/header.h"
+
+/**
+ * \fn int writeVarint(unsigned char* buffer, uint64_t value)
+ * \brief Saves an integer in a buffer as a little-endian varint: 7 bits per byte, starting with the lowest ones, the highest bit of each byte being 1 if another byte follows
+ * \param buffer Buffer where the integer is saved. It must contain at least MAX_VARINT_SIZE bytes
+ * \param value Integer that is saved
+ * \return The number of bytes written in buffer
+ */
+
+int writeVarint(unsigned char* buffer, uint64_t value)
+{
+    int i=0;
+    while(value>=0x80){
+        buffer[i]=(value&0x7F)|0x80;
+        value>>=7;
+        i++;
+    }
+    buffer[i]=value;
+    return i+1;
+}
+
+/**
+ * \fn int readVarint(const unsigned char* buffer, size_t size, uint64_t* value)
+ * \brief Reads an integer saved by writeVarint
+ * \param buffer Buffer from which the integer is read
+ * \param size Number of bytes that can be read in buffer
+ * \param value Integer that is read
+ * \return The number of bytes read, or -1 if the varint is incorrect or truncated
+ */
+
+int readVarint(const unsigned char* buffer, size_t size, uint64_t* value)
+{
+    *value=0;
+    for(int i=0; i<MAX_VARINT_SIZE && (size_t) i<size; i++){
+        *value|=((uint64_t) (buffer[i]&0x7F))<<(7*i);
+        if(!(buffer[i]&0x80))
+            return i+1;
+    }
+    return -1;
+}
+
+/**
+ * \fn int hasOriginalSize(int type)
+ * \brief Tells if the original size is saved in the header of a type of file. It's not for the files whose size isn't known before they are compressed (streams and adaptive codes, which end with an end marker) nor for the archives
+ * \param type Type of the compressed file
+ * \return 1 if the header contains the original size, 0 otherwise
+ */
+
+int hasOriginalSize(int type)
+{
+    return type!=FILE_TYPE_STREAM && type!=FILE_TYPE_ADAPTIVE && type!=FILE_TYPE_ARCHIVE;
+}
+
+/**
+ * \fn int createFileHeader(FileHeader* header, unsigned char* buffer)
+ * \brief Creates the binary header of a compressed file: the fixed part (magic, version, type and size of the header), then for the files made of a single stream the length of the codes, or the ID of the shared table for the files compressed with it, and then the sizes saved as varints (original size and/or size of the blocks, depending on the type, then the size of each bitstream but the last one for the interleaved files made of a single stream)
+ * \param header Content of the header. Its size is set by this function
+ * \param buffer Buffer where the header is created. It must contain at least FILE_HEADER_MAX_SIZE bytes
+ * \return The size of the header
+ */
+
+int createFileHeader(FileHeader* header, unsigned char* buffer)
+{
+    int size=FILE_HEADER_FIXED_SIZE;
+
+    memcpy(buffer, FILE_MAGIC, 4);
+    buffer[4]=FILE_FORMAT_VERSION;
+    buffer[5]=header->type|(header->nbBitstreams>1 ? FILE_FLAG_INTERLEAVED : 0);
+    if(header->type==FILE_TYPE_SINGLE)
+        size+=saveCodeLengthsInBuffer(header->codeLengths, buffer+size);
+    else if(header->type==FILE_TYPE_TABLE)
+        size+=writeVarint(buffer+size, header->tableId);
+    if(hasOriginalSize(header->type))
+        size+=writeVarint(buffer+size, header->originalSize);
+    if(header->type==FILE_TYPE_BLOCKS || header->type==FILE_TYPE_STREAM)
+        size+=writeVarint(buffer+size, header->blockSize);
+    else if(header->nbBitstreams>1){
+        for(int i=0; i<header->nbBitstreams-1; i++)
+            size+=writeVarint(buffer+size, header->bitstreamSizes[i]);
+    }
+    writeLittleEndian(buffer+6, size, 2);
+    header->size=size;
+    return size;
+}
+
+/**
+ * \fn void saveFileHeader(FileHeader* header, FILE* fileOutput)
+ * \brief Writes the binary header of a compressed file, created by createFileHeader
+ * \param header Content of the header. Its size is set by this function
+ * \param fileOutput Compressed file
+ */
+
+void saveFileHeader(FileHeader* header, FILE* fileOutput)
+{
+    unsigned char buffer[FILE_HEADER_MAX_SIZE];
+    fwriteAndCheck(buffer, createFileHeader(header, buffer), fileOutput);
+}
+
+/**
+ * \fn int readFileHeader(const unsigned char* input, size_t inputSize, FileHeader* header)
+ * \brief Reads and checks the binary header at the beginning of a compressed file, e.g. directly from its mapping. Files that don't start with FILE_MAGIC are rejected by reading 4 bytes
+ * \param input Beginning of the compressed file
+ * \param inputSize Number of bytes that can be read in input
+ * \param header Content of the header
+ * \return 1 if the file has a correct binary header, 0 if it doesn't start with FILE_MAGIC, -1 if it starts with FILE_MAGIC but the header is incorrect
+ */
+
+int readFileHeader(const unsigned char* input, size_t inputSize, FileHeader* header)
+{
+    int position=FILE_HEADER_FIXED_SIZE;
+    int nbReadBytes=0;
+
+    if(inputSize<4 || memcmp(input, FILE_MAGIC, 4))
+        return 0;
+    if(inputSize<FILE_HEADER_FIXED_SIZE || input[4]!=FILE_FORMAT_VERSION || (input[5]&FILE_TYPE_MASK)>FILE_TYPE_STORED || (input[5]&~(FILE_TYPE_MASK|FILE_FLAG_INTERLEAVED)))
+        return -1;
+    header->type=input[5]&FILE_TYPE_MASK;
+    header->nbBitstreams=(input[5]&FILE_FLAG_INTERLEAVED) ? NB_INTERLEAVED_BITSTREAMS : 1;
+    for(int i=0; i<NB_INTERLEAVED_BITSTREAMS; i++)
+        header->bitstreamSizes[i]=0;
+    header->size=readLittleEndian(input+6, 2);
+    header->originalSize=0;
+    header->blockSize=0;
+    header->nbChars=0;
+    header->tableId=0;
+    if(header->size<FILE_HEADER_FIXED_SIZE || header->size>FILE_HEADER_MAX_SIZE || header->size>inputSize)
+        return -1;
+    if(header->type==FILE_TYPE_SINGLE){
+        nbReadBytes=getCodeLengthsFromBuffer(input+position, header->size-position, header->codeLengths, &header->nbChars);
+        position+=nbReadBytes;
+    }
+    else if(header->type==FILE_TYPE_TABLE){ // The length of the codes are in the table file
+        nbReadBytes=readVarint(input+position, header->size-position, &header->tableId);
+        position+=nbReadBytes;
+    }
+    if(nbReadBytes>=0 && hasOriginalSize(header->type)){
+        nbReadBytes=readVarint(input+position, header->size-position, &header->originalSize);
+        position+=nbReadBytes;
+    }
+    if(nbReadBytes>=0 && (header->type==FILE_TYPE_BLOCKS || header->type==FILE_TYPE_STREAM)){
+        nbReadBytes=readVarint(input+position, header->size-position, &header->blockSize);
+        position+=nbReadBytes;
+    }
+    for(int i=0; (header->type==FILE_TYPE_SINGLE || header->type==FILE_TYPE_TABLE) && i<header->nbBitstreams-1 && nbReadBytes>=0; i++){
+        nbReadBytes=readVarint(input+position, header->size-position, &header->bitstreamSizes[i]);
+        position+=nbReadBytes;
+    }
+    if(nbReadBytes<0 || (size_t) position!=header->size || (hasOriginalSize(header->type) && header->originalSize<1) || ((header->type==FILE_TYPE_BLOCKS || header->type==FILE_TYPE_STREAM) && (header->blockSize<1 || header->blockSize>MAX_BLOCK_SIZE*1024*1024)))
+        return -1;
+    return 1;
+}
+
+/**
+ * \fn int getFileHeaderFromFile(FILE* fileInput, FileHeader* header)
+ * \brief Reads and checks the binary header at the current position of a file that can't be mapped (e.g. stdin), by using readFileHeader
+ * \param fileInput Compressed file. If it has a binary header, its position is just after it after this function, otherwise its position is not changed
+ * \param header Content of the header
+ * \return 1 if the file has a correct binary header, 0 if it doesn't start with FILE_MAGIC, -1 if its binary header is incorrect
+ */
+
+int getFileHeaderFromFile(FILE* fileInput, FileHeader* header)
+{
+    unsigned char buffer[FILE_HEADER_MAX_SIZE];
+    int c=fgetc(fileInput);
+    size_t size=0;
+
+    ungetc(c, fileInput);
+    if(c!=(unsigned char) FILE_MAGIC[0]) // Only one character can be put back in the file, it's enough to recognize the older formats
+        return 0;
+    if(fread(buffer, 1, 4, fileInput)<4 || memcmp(buffer, FILE_MAGIC, 4)){
+        fprintf(stderr, "ERROR: the format of the compressed file is unknown\n");
+        exit(EXIT_FAILURE);
+    }
+    freadAndCheck(buffer+4, FILE_HEADER_FIXED_SIZE-4, fileInput);
+    size=readLittleEndian(buffer+6, 2);
+    if(size>FILE_HEADER_FIXED_SIZE && size<=FILE_HEADER_MAX_SIZE)
+        freadAndCheck(buffer+FILE_HEADER_FIXED_SIZE, size-FILE_HEADER_FIXED_SIZE, fileInput);
+    else
+        size=FILE_HEADER_FIXED_SIZE;
+    return readFileHeader(buffer, size, header);
+}
@@ -0,0 +1,237 @@
+/**
+ * \file histogram.c
+ * \brief Contains the functions counting the occurrences of each character in a buffer, used by all the compression modes
+ * \date 2021
+ */
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/histogram.h"
+#include "../include/compression.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>  // Used for the SSE2 and AVX2 loads
+#define HISTOGRAM_X86_64
+#endif
+
+/**
+ * \fn void addWordToSubHistograms(uint64_t word, uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE])
+ * \brief Counts the 8 bytes of a word, spreading them over the sub-histograms so that consecutive identical bytes don't increment the same counter
+ * \param word 8 bytes read from the buffer
+ * \param subHistograms Sub-histograms that are incremented
+ */
+
+void addWordToSubHistograms(uint64_t word, uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE])
+{
+    subHistograms[0][(unsigned char) word]++;
+    subHistograms[1][(unsigned char) (word>>8)]++;
+    subHistograms[2][(unsigned char) (word>>16)]++;
+    subHistograms[3][(unsigned char) (word>>24)]++;
+    subHistograms[0][(unsigned char) (word>>32)]++;
+    subHistograms[1][(unsigned char) (word>>40)]++;
+    subHistograms[2][(unsigned char) (word>>48)]++;
+    subHistograms[3][(unsigned char) (word>>56)]++;
+}
+
+/**
+ * \fn size_t countOccurrencesScalar(const unsigned char* input, size_t inputSize, uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE])
+ * \brief Counts the characters of a buffer 8 bytes at a time in the sub-histograms
+ * \param input Buffer from which we get the number of occurrences of each characters
+ * \param inputSize Number of characters in input
+ * \param subHistograms Sub-histograms that are incremented
+ * \return The number of characters counted. The last ones (less than 8) are not counted
+ */
+
+size_t countOccurrencesScalar(const unsigned char* input, size_t inputSize, uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE])
+{
+    uint64_t word=0;
+    size_t i=0;
+    for(; i+8<=inputSize; i+=8){
+        memcpy(&word, input+i, 8);
+        addWordToSubHistograms(word, subHistograms);
+    }
+    return i;
+}
+
+#ifdef HISTOGRAM_X86_64
+
+/**
+ * \fn size_t countOccurrencesSSE2(const unsigned char* input, size_t inputSize, uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE])
+ * \brief Counts the characters of a buffer 16 bytes at a time in the sub-histograms. 16 identical bytes are counted at once
+ * \param input Buffer from which we get the number of occurrences of each characters
+ * \param inputSize Number of characters in input
+ * \param subHistograms Sub-histograms that are incremented
+ * \return The number of characters counted. The last ones (less than 16) are not counted
+ */
+
+size_t countOccurrencesSSE2(const unsigned char* input, size_t inputSize, uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE])
+{
+    __m128i bytes;
+    size_t i=0;
+    for(; i+16<=inputSize; i+=16){
+        bytes=_mm_loadu_si128((const __m128i*) (input+i));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(input[i])))==0xFFFF){ // Run of a single character
+            subHistograms[0][input[i]]+=16;
+        }
+        else{
+            addWordToSubHistograms(_mm_cvtsi128_si64(bytes), subHistograms);
+            addWordToSubHistograms(_mm_cvtsi128_si64(_mm_unpackhi_epi64(bytes, bytes)), subHistograms);
+        }
+    }
+    return i;
+}
+
+/**
+ * \fn size_t countOccurrencesAVX2(const unsigned char* input, size_t inputSize, uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE])
+ * \brief Counts the characters of a buffer 32 bytes at a time in the sub-histograms. 32 identical bytes are counted at once. It must only be called if the processor supports AVX2
+ * \param input Buffer from which we get the number of occurrences of each characters
+ * \param inputSize Number of characters in input
+ * \param subHistograms Sub-histograms that are incremented
+ * \return The number of characters counted. The last ones (less than 32) are not counted
+ */
+
+__attribute__((target("avx2")))
+size_t countOccurrencesAVX2(const unsigned char* input, size_t inputSize, uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE])
+{
+    __m256i bytes;
+    __m128i half;
+    size_t i=0;
+    for(; i+32<=inputSize; i+=32){
+        bytes=_mm256_loadu_si256((const __m256i*) (input+i));
+        if(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(input[i])))==-1){ // Run of a single character
+            subHistograms[0][input[i]]+=32;
+        }
+        else{
+            half=_mm256_castsi256_si128(bytes);
+            addWordToSubHistograms(_mm_cvtsi128_si64(half), subHistograms);
+            addWordToSubHistograms(_mm_extract_epi64(half, 1), subHistograms);
+            half=_mm256_extracti128_si256(bytes, 1);
+            addWordToSubHistograms(_mm_cvtsi128_si64(half), subHistograms);
+            addWordToSubHistograms(_mm_extract_epi64(half, 1), subHistograms);
+        }
+    }
+    return i;
+}
+
+#endif
+
+/**
+ * \fn void countOccurrences(const unsigned char* input, size_t inputSize, uint64_t *arrayOfOccurrences)
+ * \brief Creates an array that links each character to its number of occurrences in the given buffer. Several sub-histograms are incremented and merged at the end, with the fastest loads supported by the processor
+ * \param input Buffer from which we get the number of occurrences of each characters
+ * \param inputSize Number of characters in input
+ * \param arrayOfOccurrences Array containing the number of occurrences of the characters in input. To get the value the character is used as an index, i.e arrayOfOccurrences['a']=2 means that 'a' appears twice
+ */
+
+void countOccurrences(const unsigned char* input, size_t inputSize, uint64_t *arrayOfOccurrences)
+{
+    uint32_t subHistograms[NB_SUB_HISTOGRAMS][N_VALUES_IN_BYTE];
+    size_t chunkSize=0;
+    size_t i=0;
+
+    for(int c=0; c<N_VALUES_IN_BYTE; c++)
+        arrayOfOccurrences[c]=0;
+    while(inputSize>0){ // The sub-histograms are merged after each chunk so that they can't overflow
+        chunkSize=(inputSize<HISTOGRAM_CHUNK_SIZE) ? inputSize : HISTOGRAM_CHUNK_SIZE;
+        memset(subHistograms, 0, sizeof(subHistograms));
+#ifdef HISTOGRAM_X86_64
+        if(__builtin_cpu_supports("avx2"))
+            i=countOccurrencesAVX2(input, chunkSize, subHistograms);
+        else
+            i=countOccurrencesSSE2(input, chunkSize, subHistograms);
+#else
+        i=countOccurrencesScalar(input, chunkSize, subHistograms);
+#endif
+        for(; i<chunkSize; i++)
+            subHistograms[0][input[i]]++;
+        for(int c=0; c<N_VALUES_IN_BYTE; c++){
+            for(int j=0; j<NB_SUB_HISTOGRAMS; j++)
+                arrayOfOccurrences[c]+=subHistograms[j][c];
+        }
+        input+=chunkSize;
+        inputSize-=chunkSize;
+    }
+}
+
+/**
+ * \fn size_t countSampledOccurrences(const unsigned char* input, size_t inputSize, uint64_t* arrayOfOccurrences)
+ * \brief Counts the characters of a stratified sample of a buffer instead of all of them: the buffer is split in SAMPLE_NB_READS slices and SAMPLE_READ_SIZE bytes are counted at a pseudo-random position of each slice (the same for a given size), so that only these pages of a mapped file are read. The characters missing from the sample are counted once, so that every character has a code. Buffers that aren't bigger than the sample are counted entirely
+ * \param input Buffer from which the sample is taken
+ * \param inputSize Number of characters in input
+ * \param arrayOfOccurrences Array containing the number of occurrences of the characters in the sample
+ * \return The number of characters that were counted
+ */
+
+size_t countSampledOccurrences(const unsigned char* input, size_t inputSize, uint64_t* arrayOfOccurrences)
+{
+    uint64_t sampleOccurrences[N_VALUES_IN_BYTE];
+    uint64_t state=inputSize|1; // State of a xorshift generator, never 0
+    size_t sliceSize=inputSize/SAMPLE_NB_READS;
+    size_t offset=0;
+
+    if(inputSize<=((size_t) SAMPLE_NB_READS)*SAMPLE_READ_SIZE){
+        countOccurrences(input, inputSize, arrayOfOccurrences);
+        return inputSize;
+    }
+    for(int c=0; c<N_VALUES_IN_BYTE; c++)
+        arrayOfOccurrences[c]=0;
+    for(int i=0; i<SAMPLE_NB_READS; i++){
+        state^=state<<13;
+        state^=state>>7;
+        state^=state<<17;
+        offset=((size_t) i)*sliceSize+state%(sliceSize-SAMPLE_READ_SIZE+1);
+        offset-=offset%SAMPLE_ALIGNMENT; // The previous slice may end in the same page, it's counted twice
+        countOccurrences(input+offset, SAMPLE_READ_SIZE, sampleOccurrences);
+        for(int c=0; c<N_VALUES_IN_BYTE; c++)
+            arrayOfOccurrences[c]+=sampleOccurrences[c];
+    }
+    for(int c=0; c<N_VALUES_IN_BYTE; c++){
+        if(arrayOfOccurrences[c]==0)
+            arrayOfOccurrences[c]=1;
+    }
+    return ((size_t) SAMPLE_NB_READS)*SAMPLE_READ_SIZE;
+}
+
+/**
+ * \fn void countContextOccurrences(const unsigned char* input, size_t inputSize, uint64_t contextOccurrences[][N_VALUES_IN_BYTE])
+ * \brief Counts the occurrences of each character after each character (its context). The first character of input is counted after the character 0
+ * \param input Buffer from which we get the number of occurrences of each characters
+ * \param inputSize Number of characters in input
+ * \param contextOccurrences Array of N_VALUES_IN_BYTE histograms, contextOccurrences[p][c] receiving the number of times c follows p
+ */
+
+void countContextOccurrences(const unsigned char* input, size_t inputSize, uint64_t contextOccurrences[][N_VALUES_IN_BYTE])
+{
+    unsigned char previous=0;
+
+    memset(contextOccurrences, 0, N_VALUES_IN_BYTE*sizeof(contextOccurrences[0]));
+    for(size_t i=0; i<inputSize; i++){
+        contextOccurrences[previous][input[i]]++;
+        previous=input[i];
+    }
+}
+
+/**
+ * \fn void countBitstreamOccurrences(const unsigned char* input, size_t inputSize, int nbBitstreams, uint64_t bitstreamOccurrences[][N_VALUES_IN_BYTE], uint64_t* arrayOfOccurrences)
+ * \brief Counts the occurrences of each character in each part of input that is encoded in its own bitstream, and in the whole input
+ * \param input Buffer from which we get the number of occurrences of each characters
+ * \param inputSize Number of characters in input
+ * \param nbBitstreams Number of bitstreams, i.e. of parts of input, given by getBitstreamLength
+ * \param bitstreamOccurrences Array receiving the occurrences of the characters in each part
+ * \param arrayOfOccurrences Array receiving the occurrences of the characters in input
+ */
+
+void countBitstreamOccurrences(const unsigned char* input, size_t inputSize, int nbBitstreams, uint64_t bitstreamOccurrences[][N_VALUES_IN_BYTE], uint64_t* arrayOfOccurrences)
+{
+    uint64_t length=0;
+
+    for(int c=0; c<N_VALUES_IN_BYTE; c++)
+        arrayOfOccurrences[c]=0;
+    for(int i=0; i<nbBitstreams; i++){
+        length=getBitstreamLength(inputSize, i, nbBitstreams);
+        countOccurrences(input, length, bitstreamOccurrences[i]);
+        for(int c=0; c<N_VALUES_IN_BYTE; c++)
+            arrayOfOccurrences[c]+=bitstreamOccurrences[i][c];
+        input+=length;
+    }
+}
@@ -27,57 +27,7 @@ void freeTree(TreeNode** tree)
 
 
 /**
- * \fn void freeList(ListNode** head)
- * \brief Frees the list that is given
- * \param head Head of the list that has to be freed
- */
-
-void freeList(ListNode** head)
-{
-    ListNode* node=*head;
-    ListNode* temp=NULL;
-    while(node!=NULL){
-        temp=node;
-        node=node->next;
-        free(temp);
-    }
-    *head=NULL;
-}
-
-
-/**
- * \fn void copyArray(unsigned char* source, unsigned char* destination, int size)
- * \brief Copies the given array to the destination
- * \param source Copied array
- * \param destination Array where the source is copied
- * \param size Number of elements copied from source to destination. Both arrays must have a size greater or equal to this value
- */
-
-void copyArray(unsigned char* source, unsigned char* destination, int size)
-{
-    for(int i=0; i<size; i++){
-        destination[i]=source[i];
-    }
-}
-
-/**
- * \fn void freeArray(unsigned char * huffmanArray[N_VALUES_IN_BYTE])
- * \brief Frees the huffman array that is given
- * \param huffmanArray Array that is freed. Its size is fixed and it contains pointers to a dynamically allocated array
- */
-
-void freeArray(unsigned char * huffmanArray[N_VALUES_IN_BYTE])
-{
-    for(int i=0; i<N_VALUES_IN_BYTE; i++){
-        if(huffmanArray[i]!=NULL){
-            free(huffmanArray[i]);
-            huffmanArray[i]=NULL;
-        }
-    }
-}
-
-/**
- * \fn TreeNode* createTreeNode(int cInput, int occurrenceInput, TreeNode* leftNodeInput, TreeNode* rightNodeInput)
+ * \fn TreeNode* createTreeNode(int cInput, uint64_t occurrenceInput, TreeNode* leftNodeInput, TreeNode* rightNodeInput)
  * \brief Creates a node of a Huffman tree and initializes it by using the given parameters
  * \param cInput Character that the node will be containing
  * \param occurrenceInput Number of occurrences that the node will be containing
@@ -86,7 +36,7 @@ void freeArray(unsigned char * huffmanArray[N_VALUES_IN_BYTE])
  * \return The new tree node that was created
  */
 
-TreeNode* createTreeNode(int cInput, int occurrenceInput, TreeNode* leftNodeInput, TreeNode* rightNodeInput)
+TreeNode* createTreeNode(int cInput, uint64_t occurrenceInput, TreeNode* leftNodeInput, TreeNode* rightNodeInput)
 {
     TreeNode* node=NULL;
     MALLOC(node, TreeNode, 1);
@@ -98,370 +48,396 @@ TreeNode* createTreeNode(int cInput, int occurrenceInput, TreeNode* leftNodeInpu
 }
 
 /**
- * \fn ListNode* createListNode(TreeNode* x, ListNode* nextInput)
- * \brief Creates a list node and initializes it by using the given parameters
- * \param x Element contained by the newly created list node
- * \param nextInput Pointer to the next node of this new node
- * \return The new list node that was created
+ * \fn void siftDownKey(uint64_t* keys, int root, int nbKeys)
+ * \brief Moves a key down in a max-heap until it's greater than its children
+ * \param keys Array containing the heap
+ * \param root Index of the key that is moved down
+ * \param nbKeys Number of keys in the heap
  */
 
-ListNode* createListNode(TreeNode* x, ListNode* nextInput)
+void siftDownKey(uint64_t* keys, int root, int nbKeys)
 {
-    ListNode* node=NULL;
-    MALLOC(node, ListNode, 1);
-    node->element=x;
-    node->next=nextInput;
-
-    return node;
-}
-
-/**
- * \fn void push(ListNode** head, TreeNode* x)
- * \brief Adds an element at the beginning of the given list
- * \param head Pointer to the head of the list in which we add an element
- * \param x Pointer to the element that has to be inserted
- */
-
-void push(ListNode** head, TreeNode* x)
-{
-    ListNode* newListNode=createListNode(x, NULL);
-    newListNode->next=*head;
-    *head=newListNode;
+    uint64_t key=keys[root];
+    int child=2*root+1;
+    while(child<nbKeys){
+        if(child+1<nbKeys && keys[child+1]>keys[child])
+            child++;
+        if(keys[child]<=key)
+            break;
+        keys[root]=keys[child];
+        root=child;
+        child=2*root+1;
+    }
+    keys[root]=key;
 }
 
-
 /**
- * \fn TreeNode* popFirst(ListNode** head)
- * \brief Removes the head from the list and returns its content
- * \param head Pointer to the head of the list from which we get the first element
- * \return Pointer to the first node of the list
+ * \fn void sortKeys(uint64_t* keys, int nbKeys)
+ * \brief Sorts keys in ascending order with a heap sort, in place and without allocating memory (unlike qsort)
+ * \param keys Array of keys that is sorted
+ * \param nbKeys Number of keys
  */
 
-TreeNode* popFirst(ListNode** head)
+void sortKeys(uint64_t* keys, int nbKeys)
 {
-    TreeNode* returnedElement=NULL;
-    ListNode* newHead=NULL;
-    if(*head==NULL){
-        fprintf(stderr, "ERROR: the list given to popFirst() is empty\n");
-        return NULL;
-    }
-    else{
-        returnedElement=(*head)->element;
-        newHead=(*head)->next;
-        free(*head);
-        *head=newHead;
-        return returnedElement;
+    uint64_t temp=0;
+    for(int i=nbKeys/2-1; i>=0; i--)
+        siftDownKey(keys, i, nbKeys);
+    for(int i=nbKeys-1; i>0; i--){ // The greatest key of the heap is moved at the end
+        temp=keys[0];
+        keys[0]=keys[i];
+        keys[i]=temp;
+        siftDownKey(keys, 0, i);
     }
 }
-
 /**
- * \fn ListNode* createListOfNodes(int *arrayOfOccurrences)
- * \brief Creates a list of tree nodes by using the number of occurrences of each character
- * \param arrayOfOccurrences Array containing the number of each character given has an index, i.e arrayOfOccurrences['a']=2 means that 'a' appears twice
- * \return The list of tree nodes used to build the Huffman tree
+ * \fn int sortCharsByOccurrence(uint64_t *arrayOfOccurrences, uint64_t sortedKeys[N_VALUES_IN_BYTE])
+ * \brief Sorts the characters that appear at least once by their number of occurrences. Each key contains the number of occurrences in its high bits and the character in its 8 lowest bits, so that characters with the same number of occurrences are sorted by their value
+ * \param arrayOfOccurrences Array containing the number of occurrences of each character. They must be lower than 2^56
+ * \param sortedKeys Keys of the characters that appear, in ascending order
+ * \return The number of characters that appear
  */
 
-ListNode* createListOfNodes(int *arrayOfOccurrences)
+int sortCharsByOccurrence(uint64_t *arrayOfOccurrences, uint64_t sortedKeys[N_VALUES_IN_BYTE])
 {
-    ListNode* returnedList=NULL;
-    TreeNode* node=NULL;
-    for(int i=0; i<N_VALUES_IN_BYTE; i++)
-    {
+    int nbChars=0;
+    for(int i=0; i<N_VALUES_IN_BYTE; i++){
         if(arrayOfOccurrences[i]!=0){
-            node=createTreeNode(i, arrayOfOccurrences[i], NULL, NULL);
-            push(&returnedList, node);
+            sortedKeys[nbChars]=(((uint64_t) arrayOfOccurrences[i])<<8)|i;
+            nbChars++;
         }
     }
-    return returnedList;
+    sortKeys(sortedKeys, nbChars);
+    return nbChars;
 }
 
 /**
- * \fn void initializeBuffersPosChar(Buffer* bufferPos, Buffer* bufferChar)
- * \brief Initializes bufferPos and bufferChar
- * \param bufferPos Buffer containing all the movements made while saving the tree, to be able to rebuild it
- * \param bufferChar Buffer containing all the characters of the leaves of the tree, sorted in the same order as they are read by this function (following the movements recorded in bufferPos)
+ * \fn uint64_t limitCodeLengths(uint64_t sortedKeys[N_VALUES_IN_BYTE], int* depths, int nbChars, unsigned char codeLengths[N_VALUES_IN_BYTE], int maxCodeLength)
+ * \brief Gives lengths of at most maxCodeLength bits to the characters, as close as possible to their Huffman codes. The codes that are too long are shortened to maxCodeLength bits, then while there are too many short codes for a prefix code (Kraft inequality), a code of maxCodeLength bits is removed and a shorter code is split in two codes one bit longer. The lengths are given in ascending order to the characters from the most frequent to the least frequent. If the compressed data would be bigger than the original data, all the codes have 8 bits instead
+ * \param sortedKeys Keys of the characters that appear, sorted by sortCharsByOccurrence
+ * \param depths Length of the Huffman code of each character of sortedKeys
+ * \param nbChars Number of characters that appear. It must not be greater than 2^maxCodeLength
+ * \param codeLengths Array linking each character to the length of its code
+ * \param maxCodeLength Maximum length of the codes
+ * \return The number of bits added to the compressed data by these longer codes
  */
 
-void initializeBuffersPosChar(Buffer* bufferPos, Buffer* bufferChar)
+uint64_t limitCodeLengths(uint64_t sortedKeys[N_VALUES_IN_BYTE], int* depths, int nbChars, unsigned char codeLengths[N_VALUES_IN_BYTE], int maxCodeLength)
 {
-    bufferPos->size=1000; // it will be increased if it's too small (with a realloc)
-    bufferChar->size=N_VALUES_IN_BYTE; //N_VALUES_IN_BYTE is the maximum size here
-    MALLOC(bufferPos->content, unsigned char, bufferPos->size);
-    MALLOC(bufferChar->content, unsigned char, bufferChar->size);
+    int nbCodesOfLength[MAX_CODE_LENGTH+1];
+    uint64_t kraftSum=0; // Sum of 2^(maxCodeLength-length) for all the codes, that can't exceed 2^maxCodeLength
+    uint64_t addedBits=0;
+    uint64_t huffmanBits=0; // Size of the data compressed with the Huffman codes
+    uint64_t nbOccurrences=0;
+    int length=1;
+
+    for(int i=0; i<=maxCodeLength; i++)
+        nbCodesOfLength[i]=0;
+    for(int i=0; i<nbChars; i++)
+        nbCodesOfLength[(depths[i]<maxCodeLength) ? depths[i] : maxCodeLength]++;
+    for(int i=1; i<=maxCodeLength; i++)
+        kraftSum+=((uint64_t) nbCodesOfLength[i])<<(maxCodeLength-i);
+    while(kraftSum>(((uint64_t) 1)<<maxCodeLength)){
+        nbCodesOfLength[maxCodeLength]--;
+        for(int i=maxCodeLength-1; i>0; i--){
+            if(nbCodesOfLength[i]>0){
+                nbCodesOfLength[i]--;
+                nbCodesOfLength[i+1]+=2;
+                break;
+            }
+        }
+        kraftSum--;
+    }
+
+    for(int i=nbChars-1; i>=0; i--){ // The most frequent characters get the shortest codes
+        while(nbCodesOfLength[length]==0)
+            length++;
+        nbCodesOfLength[length]--;
+        codeLengths[sortedKeys[i]&0xFF]=length;
+        addedBits+=(sortedKeys[i]>>8)*length;
+        addedBits-=(sortedKeys[i]>>8)*depths[i];
+        huffmanBits+=(sortedKeys[i]>>8)*depths[i];
+        nbOccurrences+=sortedKeys[i]>>8;
+    }
+    if(huffmanBits+addedBits>8*nbOccurrences){ // Codes of 8 bits are used instead, so that the compressed data is never bigger than the original data
+        for(int i=0; i<N_VALUES_IN_BYTE; i++)
+            codeLengths[i]=8;
+        addedBits=8*nbOccurrences-huffmanBits;
+    }
+    return addedBits;
 }
 
 /**
- * \fn int createArrayOfOccurrences(int *arrayOfOccurrences, FILE* fileInput)
- * \brief Creates an array that links each character to its number of occurrences in the file given in parameters
- * \param arrayOfOccurrences Array containing the number of occurrences of the characters in fileInput. To get the value the character is used as an index, i.e arrayOfOccurrences['a']=2 means that 'a' appears twice
- * \param fileInput File from which we get the number of occurrences of each characters
- * \return The size of fileInput
+ * \fn uint64_t createCodeLengths(uint64_t *arrayOfOccurrences, unsigned char codeLengths[N_VALUES_IN_BYTE], int maxCodeLength)
+ * \brief Gets the length of the Huffman code of each character from their number of occurrences, without building a tree of pointers. The characters are sorted once, then the two nodes with the lowest number of occurrences are merged until there is only one node left, by using two queues: the leaves in ascending order and the merged nodes, which are created in ascending order too. The length of a code is the depth of its leaf
+ * \param arrayOfOccurrences Array containing the number of occurrences of each character. At least one of them must not be 0
+ * \param codeLengths Array linking each character to the length of its code. It's 0 for the characters that don't appear
+ * \param maxCodeLength Maximum length of the codes. If the Huffman codes are longer, they are limited by limitCodeLengths
+ * \return The number of bits added to the compressed data by the limit of the length of the codes
  */
 
-int createArrayOfOccurrences(int *arrayOfOccurrences, FILE* fileInput)
+uint64_t createCodeLengths(uint64_t *arrayOfOccurrences, unsigned char codeLengths[N_VALUES_IN_BYTE], int maxCodeLength)
 {
-    int c=0;
-    int fileSize=0;
+    uint64_t sortedKeys[N_VALUES_IN_BYTE];
+    uint64_t occurrences[2*N_VALUES_IN_BYTE-1]; // Leaves first, then the merged nodes
+    int parents[2*N_VALUES_IN_BYTE-1];
+    int depths[2*N_VALUES_IN_BYTE-1];
+    int nbChars=sortCharsByOccurrence(arrayOfOccurrences, sortedKeys);
+    int i_Leaf=0;
+    int i_Merged=nbChars; // First merged node that is not merged yet
+    int minNode=0;
+
     for(int i=0; i<N_VALUES_IN_BYTE; i++)
-        arrayOfOccurrences[i]=0;
+        codeLengths[i]=0;
+    if(nbChars==1){ // There is only one character, it still needs a code of 1 bit
+        codeLengths[sortedKeys[0]&0xFF]=1;
+        return 0;
+    }
 
-    while((c=fgetc(fileInput))!=EOF){
-        arrayOfOccurrences[c]++;
-        fileSize++;
+    for(int i=0; i<nbChars; i++)
+        occurrences[i]=sortedKeys[i]>>8;
+    for(int i_Node=nbChars; i_Node<2*nbChars-1; i_Node++){
+        occurrences[i_Node]=0;
+        for(int j=0; j<2; j++){ // The 2 nodes with the lowest number of occurrences are the first ones of the queues
+            if(i_Leaf<nbChars && (i_Merged==i_Node || occurrences[i_Leaf]<=occurrences[i_Merged]))
+                minNode=i_Leaf++;
+            else
+                minNode=i_Merged++;
+            parents[minNode]=i_Node;
+            occurrences[i_Node]+=occurrences[minNode];
+        }
     }
-    return fileSize;
-}
 
+    depths[2*nbChars-2]=0; // Root
+    for(int i_Node=2*nbChars-3; i_Node>=0; i_Node--) // Parents are always after their children
+        depths[i_Node]=depths[parents[i_Node]]+1;
+    for(int i=0; i<nbChars; i++){
+        if(depths[i]>maxCodeLength)
+            return limitCodeLengths(sortedKeys, depths, nbChars, codeLengths, maxCodeLength);
+    }
+    for(int i=0; i<nbChars; i++)
+        codeLengths[sortedKeys[i]&0xFF]=depths[i];
+    return 0;
+}
 /**
- * \fn ListNode* listMinOccurrence(ListNode* head, ListNode** nodeBeforeMinElement)
- * \brief Gets from the list the node that has the lowest occurrence value and the previous node
- * \param head Pointer to the head of the list from which we get the minimum element
- * \param nodeBeforeMinElement Pointer to the node that is just before the returned element
- * \return Pointer to the node with the lowest occurence value
+ * \fn int checkCodeLengths(unsigned char codeLengths[N_VALUES_IN_BYTE])
+ * \brief Checks that the given lengths can be the lengths of a prefix code (no code is too long and there are not too many short codes)
+ * \param codeLengths Array linking each character to the length of its code
+ * \return The number of characters that have a code, or -1 if the lengths are incorrect
  */
 
-ListNode* listMinOccurrence(ListNode* head, ListNode** nodeBeforeMinElement)
+int checkCodeLengths(unsigned char codeLengths[N_VALUES_IN_BYTE])
 {
-    ListNode* minNode=NULL;
-    ListNode* lastNode=NULL;
-    ListNode* currentNode=NULL;
-
-
-    if(head==NULL){
-        fprintf(stderr, "ERROR: listMinOccurrence() can't get a node, the list is empty\n");
-        return NULL;
-    }
-    else{
-        minNode=head;
-        *nodeBeforeMinElement=NULL;
-        currentNode=head->next;
-        lastNode=head;
-        while(currentNode!=NULL){
-            if(currentNode->element->occurrence<minNode->element->occurrence){
-                minNode=currentNode;
-                *nodeBeforeMinElement=lastNode;
-            }
-            lastNode=currentNode;
-            currentNode=currentNode->next;
+    uint64_t kraftSum=0; // sum of 2^(MAX_CODE_LENGTH-length), it can't be greater than 2^MAX_CODE_LENGTH
+    int nbChars=0;
+    for(int i=0; i<N_VALUES_IN_BYTE; i++){
+        if(codeLengths[i]>MAX_CODE_LENGTH)
+            return -1;
+        if(codeLengths[i]>0){
+            kraftSum+=((uint64_t) 1)<<(MAX_CODE_LENGTH-codeLengths[i]);
+            nbChars++;
         }
-        return minNode;
     }
+    if(kraftSum>((uint64_t) 1)<<MAX_CODE_LENGTH)
+        return -1;
+    return nbChars;
 }
 
-
 /**
- * \fn TreeNode* popMin(ListNode** head)
- * \brief Removes from the list the node that has the lowest occurrence value and returns its content
- * \param head Pointer to the head of the list from which we get the minimum element
- * \return Pointer to the tree node with the lowest occurence value in the list
+ * \fn void createCanonicalCodeTable(unsigned char codeLengths[N_VALUES_IN_BYTE], HuffmanCode codeTable[N_VALUES_IN_BYTE])
+ * \brief Gives the canonical Huffman code to each character: codes of the same length are consecutive numbers given in the order of the characters, and shorter codes come first
+ * \param codeLengths Array linking each character to the length of its code. They must have been checked with checkCodeLengths
+ * \param codeTable Table that is being filled in this function. It links all characters to their Huffman code
  */
 
-TreeNode* popMin(ListNode** head)
+void createCanonicalCodeTable(unsigned char codeLengths[N_VALUES_IN_BYTE], HuffmanCode codeTable[N_VALUES_IN_BYTE])
 {
-    ListNode* minNode=NULL;
-    ListNode* nodeBeforeMinNode=NULL;
-    ListNode* currentNode=NULL;
-    TreeNode* returnedElement;
-    if(*head==NULL){
-        return NULL;
-    }
-    else{
-        minNode=listMinOccurrence(*head, &nodeBeforeMinNode);
-        if(nodeBeforeMinNode==NULL){ // i.e minNode==*head
-            return popFirst(head);
-        }
-        else{
-            nodeBeforeMinNode->next=minNode->next;
-            returnedElement=minNode->element;
-            free(minNode);
-            return returnedElement;
+    int nbCodesOfLength[MAX_CODE_LENGTH+1];
+    uint64_t nextCode[MAX_CODE_LENGTH+1];
+    for(int length=0; length<=MAX_CODE_LENGTH; length++)
+        nbCodesOfLength[length]=0;
+    for(int i=0; i<N_VALUES_IN_BYTE; i++)
+        nbCodesOfLength[codeLengths[i]]++;
+    nbCodesOfLength[0]=0;
+    nextCode[0]=0;
+    for(int length=1; length<=MAX_CODE_LENGTH; length++)
+        nextCode[length]=(nextCode[length-1]+nbCodesOfLength[length-1])<<1;
+
+    for(int i=0; i<N_VALUES_IN_BYTE; i++){
+        codeTable[i].length=codeLengths[i];
+        codeTable[i].code=0;
+        if(codeLengths[i]>0){
+            codeTable[i].code=nextCode[codeLengths[i]];
+            nextCode[codeLengths[i]]++;
         }
     }
 }
 
 /**
- * \fn TreeNode* mergeNodes(TreeNode* nodeToMergeLeft, TreeNode* nodeToMergeRight)
- * \brief Merges 2 tree nodes into one by creating a new one that has them as a right and left node
- * \param nodeToMergeLeft Pointer to tree node that will become the left node of the new node
- * \param nodeToMergeRight Pointer to tree node that will become the right node of the new node
- * \return Tree created by merging the 2 given tree nodes
+ * \fn TreeNode* buildHuffmanTreeFromCodeTable(HuffmanCode codeTable[N_VALUES_IN_BYTE])
+ * \brief Builds the Huffman tree corresponding to the given codes. It's only used to decompress by walking in the tree
+ * \param codeTable Table linking all the characters to their Huffman code
+ * \return Tree built from the codes
  */
 
-TreeNode* mergeNodes(TreeNode* nodeToMergeLeft, TreeNode* nodeToMergeRight)
+TreeNode* buildHuffmanTreeFromCodeTable(HuffmanCode codeTable[N_VALUES_IN_BYTE])
 {
-    TreeNode* mergedNode=NULL;
-    mergedNode=createTreeNode(0, 0, nodeToMergeLeft, nodeToMergeRight);
-    if(nodeToMergeLeft!=NULL)
-        mergedNode->occurrence+=nodeToMergeLeft->occurrence;
-    if(nodeToMergeRight!=NULL)
-        mergedNode->occurrence+=nodeToMergeRight->occurrence;
-
-    return mergedNode;
+    TreeNode* treeHead=createTreeNode(0, 0, NULL, NULL);
+    TreeNode* node=NULL;
+    for(int i=0; i<N_VALUES_IN_BYTE; i++){
+        node=treeHead;
+        for(int bit=codeTable[i].length-1; bit>=0; bit--){ // We follow the code from its first bit, and create the missing nodes
+            if((codeTable[i].code>>bit)&1){
+                if(node->right==NULL)
+                    node->right=createTreeNode(0, 0, NULL, NULL);
+                node=node->right;
+            }
+            else{
+                if(node->left==NULL)
+                    node->left=createTreeNode(0, 0, NULL, NULL);
+                node=node->left;
+            }
+        }
+        if(codeTable[i].length>0)
+            node->c=i;
+    }
+    return treeHead;
 }
 
 /**
- * \fn TreeNode* createHuffmanTree(ListNode** head)
- * \brief Creates the Huffman tree from a list of tree nodes
- * \param head Pointer head of the list containing the leaves of the tree
- * \return Huffman tree created from this list
+ * \fn int saveCodeLengthsInBuffer(unsigned char codeLengths[N_VALUES_IN_BYTE], unsigned char* buffer)
+ * \brief Saves the length of the code of each character in a buffer: the number of characters minus 1 followed by each character with its length, or by the 256 lengths when it's shorter
+ * \param codeLengths Array linking each character to the length of its code. At least one of them must not be 0
+ * \param buffer Buffer where the lengths are saved. It must contain at least N_VALUES_IN_BYTE+1 bytes
+ * \return The number of bytes written in buffer
  */
 
-TreeNode* createHuffmanTree(ListNode** head)
+int saveCodeLengthsInBuffer(unsigned char codeLengths[N_VALUES_IN_BYTE], unsigned char* buffer)
 {
-    TreeNode* nodeToMergeLeft=NULL;
-    TreeNode* nodeToMergeRight=NULL;
-    TreeNode* mergedNode=NULL;
-
-    if(*head==NULL){
-        fprintf(stderr, "ERROR: the list given to createHuffmanTree() is empty\n");
-        return NULL;
+    int nbChars=0;
+    int i_Buffer=1;
+    for(int i=0; i<N_VALUES_IN_BYTE; i++){
+        if(codeLengths[i]>0)
+            nbChars++;
     }
-
-    if((*head)->next==NULL){ // There is only one node in the list and thus only one character (with one or more occurrences)
-        return popFirst(head);
+    buffer[0]=nbChars-1;
+    if(2*nbChars<N_VALUES_IN_BYTE){ // It's shorter to save the characters with their length
+        for(int i=0; i<N_VALUES_IN_BYTE; i++){
+            if(codeLengths[i]>0){
+                buffer[i_Buffer]=i;
+                buffer[i_Buffer+1]=codeLengths[i];
+                i_Buffer+=2;
+            }
+        }
     }
     else{
-        while(*head!=NULL){
-            nodeToMergeLeft=popMin(head);
-            nodeToMergeRight=popMin(head);
-            mergedNode=mergeNodes(nodeToMergeLeft, nodeToMergeRight);
-            if((*head)!=NULL) // because if there is no element remaining then all the nodes are merged
-                push(head, mergedNode);
-        }
+        memcpy(buffer+1, codeLengths, N_VALUES_IN_BYTE);
+        i_Buffer+=N_VALUES_IN_BYTE;
     }
-    return mergedNode;
+    return i_Buffer;
 }
 
 /**
- * \fn void insertInBufferPos(unsigned char *buffer, Buffer *bufferPos, int *i_BufferPos, int *filling)
- * \brief Inserts in bufferPos the filled buffer, reset the values and increase the size of bufferPos if needed
- * \param buffer Byte that will be inserted in bufferPos
- * \param bufferPos Buffer containing all the movements made while saving the tree, to be able to rebuild it
- * \param i_BufferPos Current index of the array contained in bufferPos
- * \param filling Integer that goes from 0 to 8. 0 means empty and 8 means full.
+ * \fn int getCodeLengthsSectionSize(unsigned char firstByte)
+ * \brief Gives the number of bytes written by saveCodeLengthsInBuffer from the first one
+ * \param firstByte First byte written by saveCodeLengthsInBuffer
+ * \return The number of bytes written by saveCodeLengthsInBuffer
  */
 
-void insertInBufferPos(unsigned char *buffer, Buffer *bufferPos, int *i_BufferPos, int *filling)
+int getCodeLengthsSectionSize(unsigned char firstByte)
 {
-    bufferPos->content[*i_BufferPos]=*buffer;
-    (*i_BufferPos)++;
-    *buffer=0;
-    *filling=0;
-    if(*i_BufferPos>bufferPos->size-3){
-        bufferPos->size+=1000;
-        REALLOC(bufferPos->content, unsigned char, bufferPos->size);
-    }
+    int nbChars=firstByte+1;
+    if(2*nbChars<N_VALUES_IN_BYTE)
+        return 1+2*nbChars;
+    else
+        return 1+N_VALUES_IN_BYTE;
 }
 
-
-
 /**
- * \fn void fillBuffers(TreeNode* tree, Buffer *bufferPos, Buffer *bufferChar, int *i_BufferPos, int *i_BufferChar, unsigned char *buffer, int* filling)
- * \brief Fills the buffers bufferPos and bufferChar from the given tree
- * \param tree Tree that is being used to fill the buffers. It needs to have 0 or 2 children, which is always the case with a Huffman tree.
- * \param bufferPos Buffer containing all the movements made while saving the tree, to be able to rebuild it
- * \param bufferChar Buffer containing all the characters of the leaves of the tree, sorted in the same order as they are read by this function (following the movements recorded in bufferPos)
- * \param i_BufferPos Current index of the array contained in bufferPos
- * \param i_BufferChar Current index of the array contained in bufferChar
- * \param buffer Byte that will be inserted in bufferPos
- * \param filling Integer that goes from 0 to 8. 0 means empty and 8 means full.
+ * \fn int getCodeLengthsFromBuffer(const unsigned char* buffer, size_t size, unsigned char codeLengths[N_VALUES_IN_BYTE], int* nbChars)
+ * \brief Gets the length of the code of each character saved by saveCodeLengthsInBuffer, and checks them
+ * \param buffer Buffer from which the lengths are read
+ * \param size Size of buffer
+ * \param codeLengths Array linking each character to the length of its code
+ * \param nbChars Number of characters that have a code
+ * \return The number of bytes read from buffer, or -1 if the buffer is incorrect
  */
 
-void fillBuffers(TreeNode* tree, Buffer *bufferPos, Buffer *bufferChar, int *i_BufferPos, int *i_BufferChar, unsigned char *buffer, int* filling)
+int getCodeLengthsFromBuffer(const unsigned char* buffer, size_t size, unsigned char codeLengths[N_VALUES_IN_BYTE], int* nbChars)
 {
-    if(tree->left==NULL && tree->right==NULL){
-        bufferChar->content[*i_BufferChar]=tree->c;
-        (*i_BufferChar)++;
+    int sectionSize=0;
+    if(size<1 || size<(size_t) (sectionSize=getCodeLengthsSectionSize(buffer[0])))
+        return -1;
+    *nbChars=buffer[0]+1;
+    if(2*(*nbChars)<N_VALUES_IN_BYTE){
+        for(int i=0; i<N_VALUES_IN_BYTE; i++)
+            codeLengths[i]=0;
+        for(int i=1; i<sectionSize; i+=2){
+            if(codeLengths[buffer[i]]!=0 || buffer[i+1]==0)
+                return -1;
+            codeLengths[buffer[i]]=buffer[i+1];
+        }
     }
     else{
-        (*buffer)<<=1;
-        (*buffer)|=0b1;
-        (*filling)++;
-        if(*filling>=8)
-            insertInBufferPos(buffer, bufferPos, i_BufferPos, filling);
-        fillBuffers(tree->left, bufferPos, bufferChar, i_BufferPos, i_BufferChar, buffer, filling);
-        (*buffer)<<=1;
-        (*buffer)|=0b1;
-        (*filling)++;
-        if(*filling>=8)
-            insertInBufferPos(buffer, bufferPos, i_BufferPos, filling);
-        fillBuffers(tree->right, bufferPos, bufferChar, i_BufferPos, i_BufferChar, buffer, filling);
+        memcpy(codeLengths, buffer+1, N_VALUES_IN_BYTE);
     }
-    (*buffer)<<=1;
-    (*filling)++;
-    if(*filling>=8)
-        insertInBufferPos(buffer, bufferPos, i_BufferPos, filling);
+    if(checkCodeLengths(codeLengths)!=*nbChars)
+        return -1;
+    return sectionSize;
 }
 
 /**
- * \fn int saveHuffmanTree(TreeNode* tree, Buffer *bufferPos, Buffer *bufferChar, FILE* fileOutput, int fileSize)
- * \brief Saves the given Huffman tree in the compressed file and in 2 buffers
- * \param tree Tree that is being saved. It needs to have 0 or 2 children, which is always the case with a Huffman tree.
- * \param bufferPos Buffer containing all the movements made while saving the tree, to be able to rebuild it
- * \param bufferChar Buffer containing all the characters of the leaves of the tree, sorted in the same order as they are read by this function (following the movements recorded in bufferPos)
- * \param fileOutput Compressed file
- * \param fileSize Size of the original file. It will be saved in the compressed file since it's used to decompress it
- * \return 0 if there is at least 2 different characters and 1 if there is only one
+ * \fn int isVersion1File(const unsigned char* input, size_t inputSize)
+ * \brief Checks strictly that a file without binary header is a compressed file of version 1, as written by saveHuffmanTree, before anything is decompressed from it: its 3 sizes are written in decimal on 32 bits, the movements saved for the tree are exactly those of its number of characters, and the file is big enough for the size of the original file
+ * \param input Content of the file
+ * \param inputSize Size of input
+ * \return 1 if the file can be decompressed as a file of version 1, 0 otherwise
  */
 
-int saveHuffmanTree(TreeNode* tree, Buffer *bufferPos, Buffer *bufferChar, FILE* fileOutput, int fileSize)
+int isVersion1File(const unsigned char* input, size_t inputSize)
 {
-    int i_BufferChar=0;
-    int i_BufferPos=0;
-    unsigned char buffer=0;
-    int filling=0;
-    if(!(tree->left||tree->right)){ // It's a leaf. It means there is only one character in the original file, so it will be a special case
-        if(fprintf(fileOutput, "%d\n%d\n%d\n%c", fileSize, 0, 1, tree->c)==EOF){
-            fprintf(stderr, "ERROR: fprintf can't write in the output file in saveHuffmanTree\n");
-            exit(EXIT_FAILURE);
+    uint64_t values[3]={0, 0, 0}; // Size of the original file, of bufferPos and of bufferChar
+    size_t position=0;
+
+    for(int i=0; i<3; i++){
+        if(position>=inputSize || input[position]<'0' || input[position]>'9')
+            return 0;
+        while(position<inputSize && input[position]>='0' && input[position]<='9' && values[i]<=INT32_MAX){
+            values[i]=values[i]*10+input[position]-'0';
+            position++;
         }
-        return 1;
+        if(position>=inputSize || input[position]!='\n' || values[i]>INT32_MAX)
+            return 0;
+        position++;
     }
-    else{
-        fillBuffers(tree, bufferPos, bufferChar, &i_BufferPos, &i_BufferChar , &buffer, &filling);
-        if(filling>0){
-            buffer<<=(8-filling);
-            bufferPos->content[i_BufferPos]=buffer;
-            i_BufferPos++;
-        }
-        bufferPos->size=i_BufferPos;
-        bufferChar->size=i_BufferChar;
-        if(fprintf(fileOutput, "%d\n%d\n%d\n", fileSize, bufferPos->size, bufferChar->size)==EOF){
-            fprintf(stderr, "ERROR: fprintf can't write in the output file in saveHuffmanTree\n");
-            exit(EXIT_FAILURE);
-        }
-        if(fwrite(bufferPos->content, 1, bufferPos->size, fileOutput)<bufferPos->size){
-            fprintf(stderr, "ERROR: fwrite can't write in the output file in saveHuffmanTree\n");
-            exit(EXIT_FAILURE);
-        }
-        if(fputc('\n', fileOutput) == EOF){
-            fprintf(stderr, "ERROR: fputc can't write in the output file in saveHuffmanTree\n");
-            exit(EXIT_FAILURE);
-        }
-        if(fwrite(bufferChar->content, 1, bufferChar->size, fileOutput)<bufferChar->size){
-            fprintf(stderr, "ERROR: fwrite can't write in the output file in saveHuffmanTree\n");
-            exit(EXIT_FAILURE);
-        }
-        if(fputc('\n', fileOutput) == EOF){
-            fprintf(stderr, "ERROR: fputc can't write in the output file in saveHuffmanTree\n");
-            exit(EXIT_FAILURE);
-        }
+    if(values[0]<1 || values[2]<1 || values[2]>N_VALUES_IN_BYTE)
         return 0;
-    }
+    if(values[2]==1) // The only character is the last byte of the file, there is no compressed data
+        return values[1]==0 && position+1==inputSize;
+    if(values[1]!=(4*values[2]-3+7)/8) // Each of the values[2]-1 nodes of the tree saved 2 bits and each node and leaf saved 1 bit
+        return 0;
+    position+=values[1];
+    if(position>=inputSize || input[position]!='\n')
+        return 0;
+    position+=1+values[2];
+    if(position>=inputSize || input[position]!='\n')
+        return 0;
+    position++;
+    return position<inputSize && values[0]<=8*(uint64_t) (inputSize-position); // Each character has a code of at least 1 bit
 }
 
 /**
- * \fn void getDataFromCompressedFile(FILE* fileInput, int* fileSize, Buffer* bufferChar, Buffer* bufferPos)
- * \brief Gets the header contained in the compressed file
+ * \fn void getDataFromCompressedFile(FILE* fileInput, uint64_t* fileSize, Buffer* bufferChar, Buffer* bufferPos)
+ * \brief Gets the header contained in a compressed file of version 1, where the Huffman tree is saved
  * \param fileInput compressed file from which data is extracted
  * \param fileSize Size of the original file.
  * \param bufferChar Buffer containing all the characters of the leaves of the tree, sorted in the same order as they are read by this function (following the movements recorded in bufferPos)
  * \param bufferPos Buffer containing all the movements made while saving the tree, to be able to rebuild it
  */
 
-void getDataFromCompressedFile(FILE* fileInput, int* fileSize, Buffer* bufferChar, Buffer* bufferPos)
+void getDataFromCompressedFile(FILE* fileInput, uint64_t* fileSize, Buffer* bufferChar, Buffer* bufferPos)
 {
-    fscanf(fileInput, "%d\n%d\n%d\n", fileSize, &(bufferPos->size), &(bufferChar->size));
+    fscanf(fileInput, "%" SCNu64 "\n%d\n%d\n", fileSize, &(bufferPos->size), &(bufferChar->size));
     if(bufferPos->size>0){
         MALLOC(bufferPos->content, unsigned char, bufferPos->size);
         if(fread(bufferPos->content, 1, bufferPos->size, fileInput)<bufferPos->size){
@@ -493,7 +469,7 @@ void fillAndCheckBufferFromBufferPos(Buffer *bufferPos, int *i_BufferPos, int *n
     *buffer=bufferPos->content[*i_BufferPos];
     (*i_BufferPos)++;
     *nbReadBits=0;
-    if(*i_BufferPos>bufferPos->size){
+    if((unsigned int) *i_BufferPos>bufferPos->size){
         fprintf(stderr, "ERROR: incorrect bufferPos given to buildHuffmanTreeFromBuffersRec()\n");
     }
 }
@@ -526,7 +502,7 @@ TreeNode* buildHuffmanTreeFromBuffersRec(Buffer *bufferPos, Buffer *bufferChar,
             treeNode->c=bufferChar->content[*i_BufferChar];
             (*i_BufferChar)++;
 
-            if(*i_BufferChar>bufferChar->size){
+            if((unsigned int) *i_BufferChar>bufferChar->size){
                 fprintf(stderr, "ERROR: incorrect bufferChar given to buildHuffmanTreeFromBuffersRec()\n");
             }
             *prevInstruction=0;
@@ -582,83 +558,3 @@ TreeNode* buildHuffmanTreeFromBuffers(Buffer *bufferPos, Buffer *bufferChar)
 
     return buildHuffmanTreeFromBuffersRec(bufferPos, bufferChar, &i_BufferPos, &i_BufferChar, &buffer, &nbReadBits, &prevInstruction);
 }
-
-
-
-/**
- * \fn void createHuffmanArray(TreeNode* huffmanTree, unsigned char * huffmanArray[N_VALUES_IN_BYTE])
- * \brief Initializes variables sent to createHuffmanArrayRec, and calls it to fill huffmanArray
- * \param huffmanTree Huffman tree used to get the Huffman code for each character
- * \param huffmanArray Array that is being filled in this function. It links all characters to its Huffman code
- */
-
-void createHuffmanArray(TreeNode* huffmanTree, unsigned char * huffmanArray[N_VALUES_IN_BYTE])
-{
-    unsigned char tempArray[33]; //Array that will be copied in huffmanArray[c] for each character c in the tree.
-    // The max length of the code is 33 because the 1st elemnt is used to save the length of the code and the 32 other contains 32 bytes = 256 bits
-
-    int currentByteIndex=1; // index of the current byte in tempArray that is being filled, it must be lesser than 33
-    int bitIndex=0;
-    for(int i=0; i<N_VALUES_IN_BYTE; i++)
-        huffmanArray[i]=NULL; // Initializes the code to NULL
-
-    for(int i=0; i<33; i++)
-        tempArray[i]=0; // Initializes buffers in tempArray
-    
-    createHuffmanArrayRec(huffmanTree, huffmanArray, tempArray, &currentByteIndex, &bitIndex);
-}
-
-/**
- * \fn void createHuffmanArrayRec(TreeNode* huffmanTree, unsigned char * huffmanArray[N_VALUES_IN_BYTE], unsigned char tempArray[33], int *currentByteIndex, int *bitIndex)
- * \brief Fills huffmanArray, that will contain all the characters with their Huffman code
- * \param huffmanTree Huffman tree used to get the Huffman code for each character
- * \param huffmanArray Array that is being filled in this function. It links all characters to its Huffman code
- * \param tempArray Array that is being filled by reading the tree and that is (partially) copied in the cell of huffmanArray corresponding to the character in the leaf when we do this copy
- * \param currentByteIndex Index of the current byte in tempArray that is being filled or emptied.
- * \param bitIndex Integer that goes from 0 to 8. 0 means empty and 8 means full. It's the index of the bit edited in the current byte
- */
-
-void createHuffmanArrayRec(TreeNode* huffmanTree, unsigned char * huffmanArray[N_VALUES_IN_BYTE], unsigned char tempArray[33], int *currentByteIndex, int *bitIndex)
-{
-    unsigned char mask=0; // uses to change a bit
-    if(!huffmanTree){
-        fprintf(stderr, "ERROR: createHuffmanArrayRec() can't get the Huffman tree\n");
-        exit(EXIT_FAILURE);
-    }
-    if(*bitIndex>=8){
-        (*currentByteIndex)++;
-        *bitIndex=0;
-    }
-    if(huffmanTree->left!=NULL){
-        mask=0b1;
-        mask<<=7-*bitIndex;
-        mask=~mask;
-        tempArray[*currentByteIndex]&=mask;
-        (tempArray[0])++;
-        (*bitIndex)++;
-        createHuffmanArrayRec(huffmanTree->left, huffmanArray, tempArray, currentByteIndex, bitIndex);
-    }
-    if(huffmanTree->right!=NULL){
-        mask=0b1;
-        mask<<=7-*bitIndex;
-        tempArray[*currentByteIndex]|=mask;
-        (tempArray[0])++;
-        (*bitIndex)++;
-        createHuffmanArrayRec(huffmanTree->right, huffmanArray, tempArray, currentByteIndex, bitIndex);
-    }
-    if(huffmanTree->left==NULL && huffmanTree->right==NULL){
-        if(huffmanArray[huffmanTree->c]!=NULL){
-            fprintf(stderr, "ERROR: Incorrect tree given to createHuffmanArrayRec(). A character appears more than once\n");
-            exit(EXIT_FAILURE);
-        }
-        MALLOC(huffmanArray[huffmanTree->c], unsigned char, ((*currentByteIndex)+1));
-        copyArray(tempArray, huffmanArray[huffmanTree->c], (*currentByteIndex)+1);
-    }
-    //Go to the parent
-    (tempArray[0])--;
-    (*bitIndex)--;
-    if(*bitIndex==-1){
-        (*currentByteIndex)--;
-        *bitIndex=7;
-    }
-}
\ No newline at end of file
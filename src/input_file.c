@@ -0,0 +1,149 @@
+/**
+ * \file input_file.c
+ * \brief Contains functions used to get the whole content of an input file in memory, by mapping it when it's possible
+ * \date 2021
+ */
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/input_file.h"
+#include <fcntl.h>  // Used for open
+#include <unistd.h>  // Used for read and close
+#include <sys/mman.h>  // Used for mmap and madvise
+#include <sys/stat.h>  // Used for fstat
+
+/**
+ * \fn int isStreamName(const char* fileName)
+ * \brief Tells if a file must be read as a stream, one character after the other: stdin (-), pipes and FIFOs, terminals and the other character devices such as /dev/stdin. They can't be mapped nor seeked, and their size is unknown until they are read
+ * \param fileName Name of the file
+ * \return 1 if the file is a stream, 0 if it's a regular file, a directory or if it doesn't exist
+ */
+
+int isStreamName(const char* fileName)
+{
+    struct stat fileStat;
+    return !strcmp(fileName, "-") || (stat(fileName, &fileStat)==0 && !S_ISREG(fileStat.st_mode) && !S_ISDIR(fileStat.st_mode));
+}
+
+/**
+ * \fn void openInputStream(const char* fileName, InputFile* inputFile)
+ * \brief Opens a stream given by isStreamName without reading it, so that its content can then be read with readInputFile or readInputFileWithinBudget
+ * \param fileName Name of the stream, - for stdin
+ * \param inputFile Input file that is initialized, with an empty content. If the stream can't be opened then the program is stopped
+ */
+
+void openInputStream(const char* fileName, InputFile* inputFile)
+{
+    if(!strcmp(fileName, "-"))
+        inputFile->fileDescriptor=fileno(stdin);
+    else
+        inputFile->fileDescriptor=open(fileName, O_RDONLY);
+    if(inputFile->fileDescriptor<0){
+        fprintf(stderr, "ERROR: the file can't be opened\n");
+        exit(EXIT_FAILURE);
+    }
+    inputFile->content=NULL;
+    inputFile->size=0;
+    inputFile->isMapped=0;
+}
+
+/**
+ * \fn void openInputFile(const char* fileName, InputFile* inputFile)
+ * \brief Opens a file and gets its whole content. Regular files are mapped in memory, the other ones are read by blocks with read() without limit, so they must be small (tables, samples...): the files compressed or decompressed by main are read with openInputStream when isStreamName gives 1
+ * \param fileName Name of the file that is opened
+ * \param inputFile Input file that is initialized. If the file can't be opened then the program is stopped
+ */
+
+void openInputFile(const char* fileName, InputFile* inputFile)
+{
+    struct stat fileStat;
+    void* mapping=MAP_FAILED;
+
+    inputFile->fileDescriptor=open(fileName, O_RDONLY);
+    if(inputFile->fileDescriptor<0){
+        fprintf(stderr, "ERROR: the file can't be opened\n");
+        exit(EXIT_FAILURE);
+    }
+    inputFile->content=NULL;
+    inputFile->size=0;
+    inputFile->isMapped=0;
+    if(fstat(inputFile->fileDescriptor, &fileStat)==0 && S_ISREG(fileStat.st_mode)){
+        if(fileStat.st_size==0) // An empty file can't be mapped but there is nothing to read
+            return;
+        mapping=mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, inputFile->fileDescriptor, 0);
+    }
+    if(mapping!=MAP_FAILED){
+        inputFile->content=(const unsigned char*) mapping;
+        inputFile->size=fileStat.st_size;
+        inputFile->isMapped=1;
+        madvise(mapping, inputFile->size, MADV_SEQUENTIAL); // The pages are read in order, so the kernel can read ahead
+#ifdef MADV_HUGEPAGE
+        madvise(mapping, inputFile->size, MADV_HUGEPAGE); // Fewer TLB misses when the file system supports it
+#endif
+    }
+    else{
+        readInputFile(inputFile);
+    }
+}
+
+/**
+ * \fn void readInputFile(InputFile* inputFile)
+ * \brief Reads the whole content of a file that can't be mapped, by blocks with read()
+ * \param inputFile Input file whose content is read. Its file descriptor must be opened
+ */
+
+void readInputFile(InputFile* inputFile)
+{
+    readInputFileWithinBudget(inputFile, SIZE_MAX);
+}
+
+/**
+ * \fn int readInputFileWithinBudget(InputFile* inputFile, size_t budget)
+ * \brief Reads the content of a file that can't be mapped, by blocks with read(), until its end or until it's bigger than budget. Its characters are then in memory and can be counted and encoded without being read again
+ * \param inputFile Input file whose content is read. Its file descriptor must be opened. If the file is bigger than budget, its content is only the first budget+1 characters and the next ones can still be read from the file descriptor
+ * \param budget Maximum size of the content, in bytes
+ * \return 1 if the whole file was read, 0 if it's bigger than budget
+ */
+
+int readInputFileWithinBudget(InputFile* inputFile, size_t budget)
+{
+    unsigned char* content=NULL;
+    size_t maxSize=(budget<SIZE_MAX) ? budget+1 : budget; // One more character tells if the file is bigger than the budget
+    size_t allocatedSize=(maxSize<IO_BUFFER_SIZE) ? maxSize : IO_BUFFER_SIZE;
+    ssize_t nbReadBytes=0;
+
+    MALLOC(content, unsigned char, allocatedSize);
+    while(inputFile->size<maxSize && (nbReadBytes=read(inputFile->fileDescriptor, content+inputFile->size, allocatedSize-inputFile->size))!=0){
+        if(nbReadBytes<0){
+            fprintf(stderr, "ERROR: read can't read the input file\n");
+            exit(EXIT_FAILURE);
+        }
+        inputFile->size+=nbReadBytes;
+        if(inputFile->size==allocatedSize && allocatedSize<maxSize){
+            allocatedSize=(allocatedSize<=maxSize/2) ? allocatedSize*2 : maxSize;
+            REALLOC(content, unsigned char, allocatedSize);
+        }
+    }
+    inputFile->content=content;
+    return inputFile->size<=budget;
+}
+
+/**
+ * \fn void closeInputFile(InputFile* inputFile)
+ * \brief Unmaps or frees the content of an input file and closes it
+ * \param inputFile Input file that is closed
+ */
+
+void closeInputFile(InputFile* inputFile)
+{
+    if(inputFile->isMapped)
+        munmap((void*) inputFile->content, inputFile->size);
+    else
+        free((void*) inputFile->content);
+    inputFile->content=NULL;
+    inputFile->size=0;
+    if(close(inputFile->fileDescriptor)!=0){
+        fprintf(stderr, "ERROR: the file can't be closed\n");
+        exit(EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,179 @@
+/**
+ * \file library.c
+ * \brief Contains the functions of the library libhuffman, which compress and decompress buffers in memory
+ * \date 2021
+ */
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/histogram.h"
+#include "../include/huffman_coding_table.h"
+#include "../include/header.h"
+#include "../include/compression.h"
+#include "../include/decompression.h"
+#include "../include/stored.h"
+#include "../include/library.h"
+
+/**
+ * \fn HuffmanContext* createHuffmanContext()
+ * \brief Creates a context that keeps the tables used by huffmanCompressWithContext and huffmanDecompressWithContext between their calls. It's the only allocation of the library
+ * \return The new context, using codes of at most DEFAULT_MAX_CODE_LENGTH bits
+ */
+
+HuffmanContext* createHuffmanContext()
+{
+    HuffmanContext* context=NULL;
+    MALLOC(context, HuffmanContext, 1);
+    context->maxCodeLength=DEFAULT_MAX_CODE_LENGTH;
+    context->hasDecoder=0;
+    return context;
+}
+
+/**
+ * \fn void freeHuffmanContext(HuffmanContext** context)
+ * \brief Frees a context created by createHuffmanContext
+ * \param context The context that has to be freed
+ */
+
+void freeHuffmanContext(HuffmanContext** context)
+{
+    free(*context);
+    *context=NULL;
+}
+
+/**
+ * \fn size_t huffmanCompressBound(size_t srcSize)
+ * \brief Gives the maximum size of a compressed buffer, so that the destination given to huffmanCompress is always big enough
+ * \param srcSize Size of the buffer that will be compressed
+ * \return The maximum size of the compressed buffer: the codes are never longer than 8 bits in average, so it's the size of the largest header and of the last byte of each bitstream added to srcSize
+ */
+
+size_t huffmanCompressBound(size_t srcSize)
+{
+    return FILE_HEADER_MAX_SIZE+NB_INTERLEAVED_BITSTREAMS+srcSize;
+}
+
+/**
+ * \fn size_t huffmanCompressWithContext(HuffmanContext* context, const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstCapacity)
+ * \brief Compresses a buffer in another one, by using the tables of a context. The compressed buffer has the same format as a compressed file of a single stream, so "huffman -d" can decompress it. Buffers of at least INTERLEAVED_MIN_SIZE bytes are split in NB_INTERLEAVED_BITSTREAMS bitstreams. Buffers that the codes wouldn't compress enough are stored like the files of type FILE_TYPE_STORED
+ * \param context Context created by createHuffmanContext
+ * \param src Buffer that is compressed
+ * \param srcSize Size of src. It must not be 0
+ * \param dst Buffer where the compressed data is written
+ * \param dstCapacity Size of dst. huffmanCompressBound(srcSize) is always enough
+ * \return The size of the compressed data written in dst, or 0 if srcSize is 0 or if dst is too small
+ */
+
+size_t huffmanCompressWithContext(HuffmanContext* context, const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstCapacity)
+{
+    BitWriter writer;
+    uint64_t payloadSize=0;
+    int headerSize=0;
+
+    if(srcSize==0)
+        return 0;
+    context->header.type=FILE_TYPE_SINGLE;
+    context->header.originalSize=srcSize;
+    context->header.nbBitstreams=(srcSize>=INTERLEAVED_MIN_SIZE) ? NB_INTERLEAVED_BITSTREAMS : 1;
+    for(int i=0; i<NB_INTERLEAVED_BITSTREAMS; i++)
+        context->header.bitstreamSizes[i]=0;
+    countBitstreamOccurrences(src, srcSize, context->header.nbBitstreams, context->bitstreamOccurrences, context->arrayOfOccurrences);
+    createCodeLengths(context->arrayOfOccurrences, context->header.codeLengths, context->maxCodeLength);
+    if(checkCodeLengths(context->header.codeLengths)>1){ // If there is only one character, the header is enough
+        createCanonicalCodeTable(context->header.codeLengths, context->codeTable);
+        payloadSize=getBitstreamSizes(context->bitstreamOccurrences, context->header.nbBitstreams, context->codeTable, context->header.bitstreamSizes);
+    }
+    headerSize=createFileHeader(&context->header, context->headerBuffer);
+    if(!isCompressible(srcSize, headerSize+payloadSize)){ // The characters are copied after the header
+        context->header.type=FILE_TYPE_STORED;
+        context->header.nbBitstreams=1;
+        headerSize=createFileHeader(&context->header, context->headerBuffer);
+        if(headerSize+srcSize>dstCapacity)
+            return 0;
+        memcpy(dst, context->headerBuffer, headerSize);
+        memcpy(dst+headerSize, src, srcSize);
+        return headerSize+srcSize;
+    }
+    if(headerSize+payloadSize>dstCapacity)
+        return 0;
+
+    memcpy(dst, context->headerBuffer, headerSize);
+    if(payloadSize>0){
+        initializeBitWriter(&writer, NULL, dst+headerSize, payloadSize);
+        encodeBitstreams(&writer, src, srcSize, context->header.nbBitstreams, context->codeTable);
+    }
+    return headerSize+payloadSize;
+}
+
+/**
+ * \fn size_t huffmanDecompressWithContext(HuffmanContext* context, const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstCapacity)
+ * \brief Decompresses a buffer compressed by huffmanCompress (or a file of a single stream or a stored file compressed by "huffman -c") in another one, by using the tables of a context. The decoder is only created again if the length of the codes changed since the last call
+ * \param context Context created by createHuffmanContext
+ * \param src Compressed buffer
+ * \param srcSize Size of src
+ * \param dst Buffer where the decompressed data is written
+ * \param dstCapacity Size of dst
+ * \return The size of the decompressed data written in dst, or 0 if src is incorrect or if dst is too small
+ */
+
+size_t huffmanDecompressWithContext(HuffmanContext* context, const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstCapacity)
+{
+    if(readFileHeader(src, srcSize, &context->header)!=1 || (context->header.type!=FILE_TYPE_SINGLE && context->header.type!=FILE_TYPE_STORED) || context->header.originalSize>dstCapacity)
+        return 0;
+    if(context->header.type==FILE_TYPE_STORED){ // The characters are only copied
+        if(srcSize-context->header.size!=context->header.originalSize)
+            return 0;
+        memcpy(dst, src+context->header.size, context->header.originalSize);
+        return context->header.originalSize;
+    }
+    if(context->header.nbChars==1){ // The buffer contains only one character
+        for(int i=0; i<N_VALUES_IN_BYTE; i++){
+            if(context->header.codeLengths[i]>0)
+                memset(dst, i, context->header.originalSize);
+        }
+        return context->header.originalSize;
+    }
+    if(!context->hasDecoder || memcmp(context->decoderCodeLengths, context->header.codeLengths, N_VALUES_IN_BYTE) || (!context->decoder.useMultiTable && context->header.originalSize>=MULTI_DECODE_MIN_CHARS)){ // A decoder created for a small buffer may lack the multi-symbol table
+        createHuffmanDecoder(context->header.codeLengths, context->header.originalSize, &context->decoder);
+        memcpy(context->decoderCodeLengths, context->header.codeLengths, N_VALUES_IN_BYTE);
+        context->hasDecoder=1;
+    }
+    if(decodeBitstreams(&context->decoder, src+context->header.size, srcSize-context->header.size, context->header.nbBitstreams, context->header.bitstreamSizes, dst, context->header.originalSize)<0)
+        return 0;
+    return context->header.originalSize;
+}
+
+/**
+ * \fn size_t huffmanCompress(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstCapacity)
+ * \brief Compresses a buffer in another one, without keeping a context. Its tables are on the stack, so nothing is allocated either
+ * \param src Buffer that is compressed
+ * \param srcSize Size of src. It must not be 0
+ * \param dst Buffer where the compressed data is written
+ * \param dstCapacity Size of dst. huffmanCompressBound(srcSize) is always enough
+ * \return The size of the compressed data written in dst, or 0 if srcSize is 0 or if dst is too small
+ */
+
+size_t huffmanCompress(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstCapacity)
+{
+    HuffmanContext context;
+    context.maxCodeLength=DEFAULT_MAX_CODE_LENGTH;
+    context.hasDecoder=0;
+    return huffmanCompressWithContext(&context, src, srcSize, dst, dstCapacity);
+}
+
+/**
+ * \fn size_t huffmanDecompress(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstCapacity)
+ * \brief Decompresses a buffer compressed by huffmanCompress in another one, without keeping a context
+ * \param src Compressed buffer
+ * \param srcSize Size of src
+ * \param dst Buffer where the decompressed data is written
+ * \param dstCapacity Size of dst
+ * \return The size of the decompressed data written in dst, or 0 if src is incorrect or if dst is too small
+ */
+
+size_t huffmanDecompress(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstCapacity)
+{
+    HuffmanContext context;
+    context.hasDecoder=0;
+    return huffmanDecompressWithContext(&context, src, srcSize, dst, dstCapacity);
+}
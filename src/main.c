@@ -8,8 +8,20 @@
 #include "../include/macros_constants_headers.h"
 #include "../include/file_functions.h"
 #include "../include/huffman_coding_table.h"
+#include "../include/header.h"
+#include "../include/histogram.h"
 #include "../include/compression.h"
 #include "../include/decompression.h"
+#include "../include/threads.h"
+#include "../include/blocks.h"
+#include "../include/input_file.h"
+#include "../include/stats.h"
+#include "../include/shared_table.h"
+#include "../include/adaptive.h"
+#include "../include/archive.h"
+#include "../include/context.h"
+#include "../include/stored.h"
+#include "../include/pipeline.h"
 #include <time.h>  // Used to get how much time the compression and the decompression take
 
 
@@ -24,26 +36,75 @@
 int main(int argc, char** argv)
 {
     TreeNode* huffmanTree = NULL;
-    unsigned char * huffmanArray[N_VALUES_IN_BYTE];
-    int originalFileSize=0;
-    int outputFileSize=0;
-    ListNode* listOfNodes=NULL;
-    int arrayOfOccurrences[N_VALUES_IN_BYTE];
+    HuffmanCode codeTable[N_VALUES_IN_BYTE];
+    unsigned char codeLengths[N_VALUES_IN_BYTE];
+    FileHeader fileHeader; // Header of the compressed file
+    unsigned char headerBuffer[FILE_HEADER_MAX_SIZE]; // Header created to know its size before writing it
+    uint64_t encodedSize=0; // Size of the compressed data, estimated from the occurrences and the length of the codes before encoding it
+    SharedTable sharedTable; // Codes read from the table file given by --table
+    unsigned char* tableFileName=NULL; // Name of the table file, NULL if the codes of each file are saved in its header
+    int nbSampleFiles=0; // Number of files read by --train
+    HuffmanDecoder decoder;
+    uint64_t originalFileSize=0;
+    uint64_t outputFileSize=0;
+    uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE];
+    uint64_t bitstreamOccurrences[NB_INTERLEAVED_BITSTREAMS][N_VALUES_IN_BYTE]; // Occurrences of the characters in each bitstream
     FILE* fileInput = NULL;
+    InputFile inputFile; // Content of the input file, mapped in memory when it's possible
+    uint64_t streamOriginalSize=0;
+    uint64_t streamCompressedSize=0;
     FILE* fileOutput = NULL;
     Buffer bufferPos;
     Buffer bufferChar;
     int c_flush=0; // Used to flush stdin
     bufferPos.content=NULL;
     bufferChar.content=NULL;
-    unsigned char fileNameInput[FILENAME_MAX];
-    unsigned char fileNameOutput[FILENAME_MAX];
-    int option=-1; //0: compress, 1: decompress
+    inputFile.fileDescriptor=-1;
+    inputFile.content=NULL;
+    char fileNameInput[FILENAME_MAX];
+    char fileNameOutput[FILENAME_MAX];
+    int option=-1; //0: compress, 1: decompress, 2: train a shared table
+    int formatVersion=0; //version of the format of the file that is decompressed
+    int isBinaryHeader=0; //1 if the file that is decompressed has a binary header, 0 if it has a text header, -1 if its binary header is incorrect
+    int useTreeWalk=0; //1: decompress by walking in the tree bit by bit instead of using the decode table
+    int useAdaptive=0; //1: compress in one pass with adaptive Huffman codes
+    int useContext=0; //1: compress with the codes of the character before each one
+    int useSampling=0; //1: create the codes from a sample of the file, so that it's read only once
+    size_t sampledSize=0; // Number of characters counted to create the codes, 0 if the whole file was counted
+    uint64_t exactOccurrences[N_VALUES_IN_BYTE]; // Occurrences counted while encoding with the codes of the sample
+    unsigned char exactCodeLengths[N_VALUES_IN_BYTE];
+    HuffmanCode exactCodeTable[N_VALUES_IN_BYTE];
+    double sampleTime=0; // Wall time of the sampling, in seconds
+    double countingTime=0; // Time spent counting the characters while encoding them, in seconds
+    double encodingTime=0; // Wall time of the encoding pass, in seconds
+    double encodingCpuTime=0; // Processor time of the encoding pass, in seconds
+    uint64_t* contextOccurrences=NULL; // Occurrences of each character after each character (N_VALUES_IN_BYTE per character), used by --context
+    ContextModel contextModel; // Code tables of the order-1 mode
+    unsigned char* contextSection=NULL; // Context section saved after the header by --context
+    int contextSectionSize=0;
+    int isRecursive=0; //1: compress a directory in an archive, or extract all the files of an archive
+    char* memberName=NULL; //name of the file extracted from an archive, NULL if it's not extracted alone
+    ArchiveMember* archiveMembers=NULL; //files of the directory that is archived
+    int nbArchiveMembers=0;
+    int blockSize=0; //size of the blocks in MiB, 0 if the file is not split in blocks
+    long memoryBudget=DEFAULT_MEMORY_BUDGET; //maximum size in MiB of a stream read in memory to be compressed in a single pass
+    int isInMemory=0; //1 if the stream that is compressed was entirely read in memory
+    int isInputStream=0; //1 if SOURCE is stdin, a pipe or a device, which is read as a stream instead of being mapped
+    int pipelineDepth=0; //number of buffers between the coding and the threads reading and writing the files, 0 if the coding reads and writes them itself
+    size_t pipelineBufferSize=((size_t) DEFAULT_PIPELINE_BUFFER_SIZE)*1024; //size of these buffers in bytes
+    int isWrittenByPosition=0; //1 if the decompressed file is written at the position of each part, so it can't be written by a pipeline
+    int nbThreads=1; //number of threads compressing the blocks
+    int maxCodeLength=DEFAULT_MAX_CODE_LENGTH; //maximum length of the Huffman codes
+    int nbBitstreams=NB_INTERLEAVED_BITSTREAMS; //number of bitstreams in which the compressed data is split
+    uint64_t addedBits=0; //number of bits added to the compressed file by the limit of the length of the codes
+    char* endOfNumber=NULL; // Used to check the numbers given as parameters
     clock_t t_start, t_end;
+    FILE* fileMessages=stdout; // Where the progress is displayed, stderr when the result is written in stdout
+    Stats* stats=NULL; // Statistics displayed by --stats, NULL when the option isn't given so that nothing is measured
 
     //DISPLAY THE HELP
     if(argc>1 && !strncmp(argv[1], "-h", 2)){
-        printf("\nNAME\n\thuffman\n\nSYNOPSIS\n\thuffman\n\thuffman [OPTION] SOURCE DEST\n\nDESCRIPTION\n\tCompresses or decompresses the file SOURCE by using Huffman coding and saves it in the file DEST.\n\n\t-h\n\t\tdisplay this help and exit.\n\n\t-c\n\t\tcompress SOURCE to DEST.\n\n\t-d\n\t\tdecompress SOURCE to DEST.\n\n");
+        printf("\nNAME\n\thuffman\n\nSYNOPSIS\n\thuffman\n\thuffman [OPTION]... SOURCE DEST\n\nDESCRIPTION\n\tCompresses or decompresses the file SOURCE by using Huffman coding and saves it in the file DEST. SOURCE or DEST can be - to read stdin or write stdout: a stream smaller than the memory budget (--memory) is read once in memory and compressed like a file, bigger ones are compressed by chunks (of the size given by -b) one after the other, without seeking. Pipes and devices given by their name (a FIFO, /dev/stdin...) are read the same way.\n\n\t-h\n\t\tdisplay this help and exit.\n\n\t-c\n\t\tcompress SOURCE to DEST.\n\n\t-d\n\t\tdecompress SOURCE to DEST.\n\n\t--train\n\t\tcreate in DEST a table of Huffman codes trained on SOURCE, a sample file or a directory whose files, and those of its sub-directories, are all read. Every character has a code, even the ones missing from the sample.\n\n\t--table FILE\n\t\twith -c, compress SOURCE with the codes of the table FILE created by --train, without saving its codes: the header only contains the ID of the table. Its characters are only counted to give the size of the bitstreams and to store it without encoding it when the codes of the table don't compress it. With -d, decompress a file compressed with this table. It can't be used with -j or -b.\n\n\t-j N\n\t\twith -c, split SOURCE in blocks compressed in parallel by N threads (0: one thread per core). With -d, decompress the blocks in parallel.\n\n\t-b N\n\t\twith -c, split SOURCE in blocks of N MiB (default: %d MiB, maximum: %d MiB) compressed separately.\n\n\t--memory N\n\t\twith -c, read a stream (SOURCE -) of at most N MiB in memory to compress it like a file, with a single header, in a single read (default: %d MiB). A bigger stream, or any stream when N is 0, is compressed by chunks.\n\n\t--pipeline N\n\t\tread and write the files in two other threads through N buffers (0: disabled, the default, or 2 to %d), so that the coding doesn't wait for the I/O: useful for pipes and slow or network file systems. The parts written at their position (blocks, 4 bitstreams and stored files decompressed in a regular file) are not written through the buffers.\n\n\t--pipeline-buffer N\n\t\tsize of the buffers of --pipeline, in KiB (default: %d KiB, maximum: %d KiB).\n\n\t--max-code-len N\n\t\twith -c, limit the length of the Huffman codes to N bits (default: %d, minimum: %d, maximum: %d). The compressed file can be a bit bigger, the difference is displayed.\n\n\t--bitstreams N\n\t\twith -c, split the compressed data (of SOURCE, or of each block) in N bitstreams decoded at the same time by -d, N being 1 or %d (default: %d). SOURCE is not split if it's smaller than %d bytes.\n\n\t--adaptive\n\t\twith -c, compress SOURCE in one pass with adaptive Huffman codes, updated after each character, so that SOURCE is read only once and no codes are saved: useful for streams and small files. It can't be used with --table, -j or -b. -d detects these files by itself.\n\n\t--context\n\t\twith -c, compress SOURCE with order-1 codes: the code of each character is taken from a table chosen by the character before it. Up to 256 tables are saved after the header, the similar characters sharing the same one, so text is compressed better than with a single table. It can't be used with --table, --adaptive, -r, -j or -b. -d detects these files by itself.\n\n\t--sample\n\t\twith -c, create the codes from %d parts of %d MiB spread across SOURCE instead of counting all its characters, so that a big file is read only once, by the encoding. The characters missing from the parts still get a code. With --stats, the characters are also counted while encoding, to display the ratio lost compared with exact counting and the time saved. The compressed data isn't split in bitstreams. It can't be used with --table, --adaptive, --context, -r, -j, -b or when SOURCE is - or a pipe.\n\n\t-r\n\t\twith -c, compress all the files of the directory SOURCE and of its sub-directories in the archive DEST, in parallel with the threads given by -j. Each file is compressed separately, with its own codes. With -d, extract all the files of the archive SOURCE in the directory DEST.\n\n\t--member NAME\n\t\twith -d, extract only the file NAME (its path in the archived directory) of the archive SOURCE in DEST, by reading only its compressed content.\n\n\t--tree-walk\n\t\twith -d, decode bit by bit by walking in the Huffman tree instead of using the decode table (slower, used to check the results).\n\n\t--stats[=json]\n\t\tdisplay on stderr the wall and CPU time, page faults and hardware counters (cycles, instructions, branch misses, L1 and LLC misses, when perf_event_open is allowed) of each phase, the sizes read and written, the size of the header and the number and length of the codes.\n\n", DEFAULT_BLOCK_SIZE, MAX_BLOCK_SIZE, DEFAULT_MEMORY_BUDGET, MAX_PIPELINE_DEPTH, DEFAULT_PIPELINE_BUFFER_SIZE, MAX_PIPELINE_BUFFER_SIZE, DEFAULT_MAX_CODE_LENGTH, MIN_MAX_CODE_LENGTH, MAX_CODE_LENGTH, NB_INTERLEAVED_BITSTREAMS, NB_INTERLEAVED_BITSTREAMS, INTERLEAVED_MIN_SIZE, SAMPLE_NB_READS, SAMPLE_READ_SIZE/(1024*1024));
         return 0;
     }
 
@@ -73,122 +134,722 @@ int main(int argc, char** argv)
         printf("\nEnter the name of the file in which you want to save the result: ");
         getFileName(fileNameOutput);
     }
-    else if(argc==4){ //3 parameters
-        if(strlen(argv[1])!=2){
-            //Display an error message and recommend to use -h
+    else if(argc>=4){ //[OPTION]... SOURCE DEST
+        for(int i=1; i<argc-2; i++){
+            if(!strcmp(argv[i], "-c")){
+                option=0;
+            }
+            else if(!strcmp(argv[i], "-d")){
+                option=1;
+            }
+            else if(!strcmp(argv[i], "--train")){
+                option=2;
+            }
+            else if(!strcmp(argv[i], "--table") && i+1<argc-2){
+                i++;
+                tableFileName=(unsigned char*) argv[i];
+            }
+            else if(!strcmp(argv[i], "--tree-walk")){
+                useTreeWalk=1;
+            }
+            else if(!strcmp(argv[i], "--adaptive")){
+                useAdaptive=1;
+            }
+            else if(!strcmp(argv[i], "--context")){
+                useContext=1;
+            }
+            else if(!strcmp(argv[i], "--sample")){
+                useSampling=1;
+            }
+            else if(!strcmp(argv[i], "-r")){
+                isRecursive=1;
+            }
+            else if(!strcmp(argv[i], "--member") && i+1<argc-2){
+                i++;
+                memberName=argv[i];
+            }
+            else if(!strcmp(argv[i], "--stats") || !strcmp(argv[i], "--stats=json")){
+                freeStats(&stats);
+                stats=createStats(strcmp(argv[i], "--stats") ? STATS_JSON : STATS_TEXT);
+            }
+            else if(!strcmp(argv[i], "-j") && i+1<argc-2){
+                i++;
+                nbThreads=strtol(argv[i], &endOfNumber, 10);
+                if(*endOfNumber!='\0' || nbThreads<0){
+                    fprintf(stderr, "ERROR: bad number of threads. Please use the huffman -h for more information\n");
+                    exit(EXIT_FAILURE);
+                }
+                if(nbThreads==0)
+                    nbThreads=getNumberOfCores();
+                if(blockSize==0)
+                    blockSize=DEFAULT_BLOCK_SIZE;
+            }
+            else if(!strcmp(argv[i], "--max-code-len") && i+1<argc-2){
+                i++;
+                maxCodeLength=strtol(argv[i], &endOfNumber, 10);
+                if(*endOfNumber!='\0' || maxCodeLength<MIN_MAX_CODE_LENGTH || maxCodeLength>MAX_CODE_LENGTH){
+                    fprintf(stderr, "ERROR: bad maximum length of the codes. Please use the huffman -h for more information\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            else if(!strcmp(argv[i], "--bitstreams") && i+1<argc-2){
+                i++;
+                nbBitstreams=strtol(argv[i], &endOfNumber, 10);
+                if(*endOfNumber!='\0' || (nbBitstreams!=1 && nbBitstreams!=NB_INTERLEAVED_BITSTREAMS)){
+                    fprintf(stderr, "ERROR: bad number of bitstreams. Please use the huffman -h for more information\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            else if(!strcmp(argv[i], "--memory") && i+1<argc-2){
+                i++;
+                memoryBudget=strtol(argv[i], &endOfNumber, 10);
+                if(*endOfNumber!='\0' || memoryBudget<0 || (uint64_t) memoryBudget>SIZE_MAX/(1024*1024)-1){
+                    fprintf(stderr, "ERROR: bad memory budget. Please use the huffman -h for more information\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            else if(!strcmp(argv[i], "--pipeline") && i+1<argc-2){
+                i++;
+                pipelineDepth=strtol(argv[i], &endOfNumber, 10);
+                if(*endOfNumber!='\0' || pipelineDepth<0 || pipelineDepth==1 || pipelineDepth>MAX_PIPELINE_DEPTH){
+                    fprintf(stderr, "ERROR: bad number of buffers. Please use the huffman -h for more information\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            else if(!strcmp(argv[i], "--pipeline-buffer") && i+1<argc-2){
+                i++;
+                pipelineBufferSize=strtol(argv[i], &endOfNumber, 10);
+                if(*endOfNumber!='\0' || pipelineBufferSize<1 || pipelineBufferSize>MAX_PIPELINE_BUFFER_SIZE){
+                    fprintf(stderr, "ERROR: bad size of the buffers. Please use the huffman -h for more information\n");
+                    exit(EXIT_FAILURE);
+                }
+                pipelineBufferSize*=1024;
+            }
+            else if(!strcmp(argv[i], "-b") && i+1<argc-2){
+                i++;
+                blockSize=strtol(argv[i], &endOfNumber, 10);
+                if(*endOfNumber!='\0' || blockSize<1 || blockSize>MAX_BLOCK_SIZE){
+                    fprintf(stderr, "ERROR: bad block size. Please use the huffman -h for more information\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            else{
+                //Display an error message and recommend to use -h
+                fprintf(stderr, "ERROR: bad parameters. Please use the huffman -h for more information\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        if(option==-1){
             fprintf(stderr, "ERROR: bad parameters. Please use the huffman -h for more information\n");
             exit(EXIT_FAILURE);
         }
-        else if(!strncmp(argv[1], "-c", 2)){
-            strncpy(fileNameInput, argv[2], FILENAME_MAX);
-            strncpy(fileNameOutput, argv[3], FILENAME_MAX);
-            option=0;
+        if(tableFileName!=NULL && (option==2 || blockSize>0)){
+            fprintf(stderr, "ERROR: --table can't be used with --train, -j or -b. Please use the huffman -h for more information\n");
+            exit(EXIT_FAILURE);
         }
-        else if(!strncmp(argv[1], "-d", 2)){
-            strncpy(fileNameInput, argv[2], FILENAME_MAX);
-            strncpy(fileNameOutput, argv[3], FILENAME_MAX);
-            option=1;
+        if(useAdaptive && option==0 && (tableFileName!=NULL || blockSize>0)){
+            fprintf(stderr, "ERROR: --adaptive can't be used with --table, -j or -b. Please use the huffman -h for more information\n");
+            exit(EXIT_FAILURE);
         }
-        else{
-            fprintf(stderr, "ERROR: bad parameters. Please use the huffman -h for more information\n");
+        if(useContext && option==0 && (tableFileName!=NULL || useAdaptive || isRecursive || blockSize>0)){
+            fprintf(stderr, "ERROR: --context can't be used with --table, --adaptive, -r, -j or -b. Please use the huffman -h for more information\n");
+            exit(EXIT_FAILURE);
+        }
+        if(useSampling && option==0 && (tableFileName!=NULL || useAdaptive || useContext || isRecursive || blockSize>0 || isStreamName(argv[argc-2]))){
+            fprintf(stderr, "ERROR: --sample can't be used with --table, --adaptive, --context, -r, -j, -b or when SOURCE is - or a pipe. Please use the huffman -h for more information\n");
+            exit(EXIT_FAILURE);
+        }
+        if((isRecursive || memberName!=NULL) && (tableFileName!=NULL || useAdaptive || option==2 || (memberName!=NULL && (option!=1 || isRecursive)))){
+            fprintf(stderr, "ERROR: -r can't be used with --table, --adaptive or --train, and --member only with -d. Please use the huffman -h for more information\n");
             exit(EXIT_FAILURE);
         }
+        strncpy(fileNameInput, argv[argc-2], FILENAME_MAX-1);
+        fileNameInput[FILENAME_MAX-1]='\0';
+        strncpy(fileNameOutput, argv[argc-1], FILENAME_MAX-1);
+        fileNameOutput[FILENAME_MAX-1]='\0';
+        if(!strcmp(fileNameOutput, "-"))
+            fileMessages=stderr;
     }
     else{ 
         fprintf(stderr, "ERROR: bad parameters. Please use the huffman -h for more information\n");
         exit(EXIT_FAILURE);
     }
 
+    if(tableFileName!=NULL)
+        loadSharedTable((char*) tableFileName, &sharedTable);
+    if(!isRecursive && memberName==NULL)
+        isInputStream=isStreamName(fileNameInput);
+
     //COMPRESS
-    if(option==0){
-        fileInput=fopen(fileNameInput, "rb");
+    if(option==0 && blockSize==0 && tableFileName==NULL && !useAdaptive && !useContext && !isRecursive && isInputStream){ // A stream that fits in the memory budget is compressed like a file, from the characters read once
+        startPhase(stats, PHASE_OPEN);
+        openInputStream(fileNameInput, &inputFile);
+        isInMemory=readInputFileWithinBudget(&inputFile, ((size_t) memoryBudget)*1024*1024);
+        endPhase(stats);
+    }
+    if(option==0 && isRecursive){ // Each file of the directory is compressed separately by a pool of threads
+        startPhase(stats, PHASE_OPEN);
+        archiveMembers=listArchiveMembers(fileNameInput, &nbArchiveMembers, &streamOriginalSize);
+        endPhase(stats);
+        fileOutput=openOutputFile(fileNameOutput, 0, 0, NULL);
+        t_start=clock();
+        fprintf(fileMessages, "Compressing the %d files of %s with %d threads...\n", nbArchiveMembers, fileNameInput, nbThreads);
+        startPhase(stats, PHASE_BLOCKS);
+        outputFileSize=archiveCompression(fileNameInput, archiveMembers, nbArchiveMembers, fileOutput, nbThreads, maxCodeLength);
+        endPhase(stats);
+        streamOriginalSize=0;
+        for(int i=0; i<nbArchiveMembers; i++) // The files may have changed since they were listed
+            streamOriginalSize+=archiveMembers[i].originalSize;
+        freeArchiveMembers(&archiveMembers, nbArchiveMembers);
+        fileHeader.size=FILE_HEADER_FIXED_SIZE; // Nothing but the fixed part is saved in the header of the archives
+        t_end=clock();
+        fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+        if(streamOriginalSize>0)
+            fprintf(fileMessages, "%.2f kB compressed to %.2f kB (%.2f %%)",  ((float)streamOriginalSize)/1000, ((float)outputFileSize)/1000, (((float) outputFileSize)/streamOriginalSize)*100);
+    }
+    else if(option==0 && useAdaptive){ // Each character is read once and encoded with the codes of the characters read before it, so the file is never read twice
+        if(!strcmp(fileNameInput, "-"))
+            fileInput=stdin;
+        else
+            fileInput=fopen(fileNameInput, "rb");
         checkFopen(fileInput);
+        if(pipelineDepth>0)
+            fileInput=openPipelinedFile(fileInput, 0, pipelineDepth, pipelineBufferSize);
+        fileOutput=openOutputFile(fileNameOutput, pipelineDepth, pipelineBufferSize, NULL);
+        t_start=clock();
+        fprintf(fileMessages, "Compressing %s with adaptive codes...\n", fileNameInput);
+        startPhase(stats, PHASE_ENCODE);
+        outputFileSize=adaptiveCompression(fileInput, fileOutput, &streamOriginalSize);
+        endPhase(stats);
+        fileHeader.size=FILE_HEADER_FIXED_SIZE; // Nothing but the fixed part is saved in the header of the adaptive files
+        t_end=clock();
+        fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+        if(streamOriginalSize>0)
+            fprintf(fileMessages, "%.2f kB compressed to %.2f kB (%.2f %%)",  ((float)streamOriginalSize)/1000, ((float)outputFileSize)/1000, (((float) outputFileSize)/streamOriginalSize)*100);
+    }
+    else if(option==0 && useContext){ // The characters are counted after each character, so the whole file is read first
+        startPhase(stats, PHASE_OPEN);
+        if(isInputStream){
+            openInputStream(fileNameInput, &inputFile);
+            readInputFile(&inputFile);
+        }
+        else
+            openInputFile(fileNameInput, &inputFile);
+        endPhase(stats);
         t_start=clock();
-        printf("Counting the characters...\n");
-        originalFileSize=createArrayOfOccurrences(arrayOfOccurrences, fileInput);
+        originalFileSize=inputFile.size;
         if(originalFileSize==0){
-            printf("This file is empty. Please give a file with at least one character\n");
+            fprintf(fileMessages, "This file is empty. Please give a file with at least one character\n");
             return 0;
         }
-        else if(originalFileSize<0){
-            fprintf(stderr, "ERROR: the size of the file wasn't correctly calculated\n");
-            exit(EXIT_FAILURE);
+        fileOutput=openOutputFile(fileNameOutput, pipelineDepth, pipelineBufferSize, NULL);
+        fprintf(fileMessages, "Counting the characters after each character...\n");
+        startPhase(stats, PHASE_HISTOGRAM);
+        MALLOC(contextOccurrences, uint64_t, N_VALUES_IN_BYTE*N_VALUES_IN_BYTE);
+        countContextOccurrences(inputFile.content, inputFile.size, (uint64_t (*)[N_VALUES_IN_BYTE]) contextOccurrences);
+        fprintf(fileMessages, "Creating the code tables of the contexts...\n");
+        startPhase(stats, PHASE_CODE_LENGTHS);
+        encodedSize=(createContextModel((uint64_t (*)[N_VALUES_IN_BYTE]) contextOccurrences, maxCodeLength, &contextModel)+7)/8;
+        free(contextOccurrences);
+        startPhase(stats, PHASE_HEADER);
+        fileHeader.type=FILE_TYPE_CONTEXT;
+        fileHeader.originalSize=originalFileSize;
+        fileHeader.nbBitstreams=1;
+        MALLOC(contextSection, unsigned char, CONTEXT_SECTION_MAX_SIZE);
+        contextSectionSize=saveContextModel(&contextModel, contextSection);
+        if(!isCompressible(originalFileSize, createFileHeader(&fileHeader, headerBuffer)+contextSectionSize+encodedSize)){ // The characters are spread too evenly, even after each character
+            fprintf(fileMessages, "Storing %s without encoding it, since it can't be compressed...\n", fileNameInput);
+            startPhase(stats, PHASE_ENCODE);
+            outputFileSize=storedCompression(inputFile.content, inputFile.size, &fileHeader, fileOutput);
+        }
+        else{
+            fwriteAndCheck(headerBuffer, fileHeader.size, fileOutput);
+            fwriteAndCheck(contextSection, contextSectionSize, fileOutput);
+            fileHeader.size+=contextSectionSize; // The tables are counted in the header
+            fprintf(fileMessages, "Compressing %s with %d code tables...\n", fileNameInput, contextModel.nbTables);
+            startPhase(stats, PHASE_ENCODE);
+            outputFileSize=fileHeader.size+contextCompression(inputFile.content, inputFile.size, &contextModel, fileOutput);
+        }
+        free(contextSection);
+        endPhase(stats);
+        t_end=clock();
+        fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+        fprintf(fileMessages, "%.2f kB compressed to %.2f kB (%.2f %%)",  ((float)originalFileSize)/1000, ((float)outputFileSize)/1000, (((float) outputFileSize)/originalFileSize)*100);
+    }
+    else if(option==0 && tableFileName!=NULL){ // The codes are given by the table, so the characters are only counted to save the size of the bitstreams and to know if the codes compress the file
+        startPhase(stats, PHASE_OPEN);
+        if(isInputStream){ // The size of the file is saved in the header, so the whole stream is read first
+            openInputStream(fileNameInput, &inputFile);
+            readInputFile(&inputFile);
+        }
+        else
+            openInputFile(fileNameInput, &inputFile);
+        endPhase(stats);
+        t_start=clock();
+        originalFileSize=inputFile.size;
+        if(originalFileSize==0){
+            fprintf(fileMessages, "This file is empty. Please give a file with at least one character\n");
+            return 0;
+        }
+        fileOutput=openOutputFile(fileNameOutput, pipelineDepth, pipelineBufferSize, NULL);
+        if(originalFileSize<INTERLEAVED_MIN_SIZE)
+            nbBitstreams=1;
+        fileHeader.type=FILE_TYPE_TABLE;
+        fileHeader.originalSize=originalFileSize;
+        fileHeader.tableId=sharedTable.id;
+        fileHeader.nbBitstreams=nbBitstreams;
+        startPhase(stats, PHASE_HISTOGRAM);
+        countBitstreamOccurrences(inputFile.content, inputFile.size, nbBitstreams, bitstreamOccurrences, arrayOfOccurrences);
+        encodedSize=getBitstreamSizes(bitstreamOccurrences, nbBitstreams, sharedTable.codeTable, fileHeader.bitstreamSizes);
+        startPhase(stats, PHASE_HEADER);
+        if(!isCompressible(originalFileSize, createFileHeader(&fileHeader, headerBuffer)+encodedSize)){ // The file doesn't look like the sample of the table
+            fprintf(fileMessages, "Storing %s without encoding it, since the table %08x can't compress it...\n", fileNameInput, sharedTable.id);
+            startPhase(stats, PHASE_ENCODE);
+            outputFileSize=storedCompression(inputFile.content, inputFile.size, &fileHeader, fileOutput);
+        }
+        else{
+            fwriteAndCheck(headerBuffer, fileHeader.size, fileOutput);
+            fprintf(fileMessages, "Compressing %s with the table %08x...\n", fileNameInput, sharedTable.id);
+            startPhase(stats, PHASE_ENCODE);
+            outputFileSize=fileHeader.size+huffManCompression(inputFile.content, inputFile.size, nbBitstreams, sharedTable.codeTable, fileOutput);
+        }
+        endPhase(stats);
+        t_end=clock();
+        fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+        setCodeStats(stats, sharedTable.codeLengths, ((double) (outputFileSize-fileHeader.size))*8/originalFileSize);
+        fprintf(fileMessages, "%.2f kB %s %.2f kB (%.2f %%)",  ((float)originalFileSize)/1000, (fileHeader.type==FILE_TYPE_STORED) ? "stored in" : "compressed to", ((float)outputFileSize)/1000, (((float) outputFileSize)/originalFileSize)*100);
+    }
+    else if(option==0 && ((isInputStream && (!isInMemory || inputFile.size==0)) || (!strcmp(fileNameOutput, "-") && blockSize>0))){ // Streams bigger than the memory budget can't be read twice nor seeked, so they are compressed by chunks
+        if(!strcmp(fileNameInput, "-"))
+            fileInput=stdin;
+        else if(inputFile.fileDescriptor>=0) // The beginning of the stream was read from this file descriptor
+            fileInput=fdopen(inputFile.fileDescriptor, "rb");
+        else
+            fileInput=fopen(fileNameInput, "rb");
+        checkFopen(fileInput);
+        if(pipelineDepth>0)
+            fileInput=openPipelinedFile(fileInput, 0, pipelineDepth, pipelineBufferSize);
+        fileOutput=openOutputFile(fileNameOutput, pipelineDepth, pipelineBufferSize, NULL);
+        if(blockSize==0)
+            blockSize=DEFAULT_BLOCK_SIZE;
+        t_start=clock();
+        if(inputFile.size>0)
+            fprintf(fileMessages, "The stream is bigger than the memory budget (%ld MiB)\n", memoryBudget);
+        fprintf(fileMessages, "Compressing %s by chunks of %d MiB...\n", fileNameInput, blockSize);
+        startPhase(stats, PHASE_BLOCKS);
+        addedBits=streamCompression(inputFile.content, inputFile.size, fileInput, fileOutput, blockSize*1024*1024, nbBitstreams, maxCodeLength, &streamOriginalSize, &streamCompressedSize);
+        outputFileSize=streamCompressedSize;
+        endPhase(stats);
+        if(inputFile.fileDescriptor>=0){ // The beginning of the stream was read before knowing that it's bigger than the budget. Its file descriptor is closed with fileInput
+            free((void*) inputFile.content);
+            inputFile.content=NULL;
+            inputFile.fileDescriptor=-1;
+        }
+        t_end=clock();
+        fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+        if(streamOriginalSize>0)
+            fprintf(fileMessages, "%.2f kB compressed to %.2f kB (%.2f %%)",  ((float)streamOriginalSize)/1000, ((float)streamCompressedSize)/1000, (((float) streamCompressedSize)/streamOriginalSize)*100);
+    }
+    else if(option==0 && blockSize>0){ // The file is split in blocks compressed in parallel
+        startPhase(stats, PHASE_OPEN);
+        openInputFile(fileNameInput, &inputFile);
+        endPhase(stats);
+        t_start=clock();
+        originalFileSize=inputFile.size;
+        if(originalFileSize==0){
+            fprintf(fileMessages, "This file is empty. Please give a file with at least one character\n");
+            return 0;
+        }
+        fileOutput=openOutputFile(fileNameOutput, 0, 0, NULL); // Not pipelined, its size is read once it's written
+        fprintf(fileMessages, "Compressing %s in blocks of %d MiB with %d threads...\n", fileNameInput, blockSize, nbThreads);
+        startPhase(stats, PHASE_BLOCKS);
+        addedBits=blockCompression(inputFile.content, originalFileSize, fileOutput, blockSize*1024*1024, nbBitstreams, nbThreads, maxCodeLength);
+        endPhase(stats);
+        t_end=clock();
+        fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+        outputFileSize=getSizeOfFile(fileOutput);
+        fprintf(fileMessages, "%.2f kB compressed to %.2f kB (%.2f %%)",  ((float)originalFileSize)/1000, ((float)outputFileSize)/1000, (((float) outputFileSize)/originalFileSize)*100);
+    }
+    else if(option==0){
+        startPhase(stats, PHASE_OPEN);
+        if(!isInMemory) // A stream is already in memory
+            openInputFile(fileNameInput, &inputFile);
+        t_start=clock();
+        originalFileSize=inputFile.size;
+        if(originalFileSize<INTERLEAVED_MIN_SIZE)
+            nbBitstreams=1;
+        startPhase(stats, PHASE_HISTOGRAM);
+        if(useSampling && originalFileSize>((uint64_t) SAMPLE_NB_READS)*SAMPLE_READ_SIZE){ // The sizes of the bitstreams can't be known before encoding them
+            fprintf(fileMessages, "Counting the characters of %d parts of %d MiB...\n", SAMPLE_NB_READS, SAMPLE_READ_SIZE/(1024*1024));
+            nbBitstreams=1;
+            sampleTime=getClockTime(CLOCK_MONOTONIC);
+            sampledSize=countSampledOccurrences(inputFile.content, inputFile.size, arrayOfOccurrences);
+            sampleTime=getClockTime(CLOCK_MONOTONIC)-sampleTime;
+        }
+        else{
+            fprintf(fileMessages, "Counting the characters...\n");
+            countBitstreamOccurrences(inputFile.content, inputFile.size, nbBitstreams, bitstreamOccurrences, arrayOfOccurrences);
+        }
+        endPhase(stats);
+        if(originalFileSize==0){
+            fprintf(fileMessages, "This file is empty. Please give a file with at least one character\n");
+            return 0;
         }
         
-        printf("Creating the Huffman tree...\n");
-        listOfNodes=createListOfNodes(arrayOfOccurrences);
-        huffmanTree=createHuffmanTree(&listOfNodes);
-        freeList(&listOfNodes);
-    
-        fileOutput=fopen(fileNameOutput, "wb");
-        checkFopen(fileOutput);
-        initializeBuffersPosChar(&bufferPos, &bufferChar);
-        printf("Saving the tree...\n");
-        if(saveHuffmanTree(huffmanTree, &bufferPos, &bufferChar, fileOutput, originalFileSize)){ // There is only one type of characters
-            printf("Compressing %s...\n", fileNameInput); 
-            freeTree(&huffmanTree);
+        fprintf(fileMessages, "Creating the Huffman tree and computing the length of the codes...\n");
+        startPhase(stats, PHASE_CODE_LENGTHS);
+        addedBits=createCodeLengths(arrayOfOccurrences, codeLengths, maxCodeLength);
+
+        fprintf(fileMessages, "Preparing the compression...\n");
+        startPhase(stats, PHASE_CODE_TABLE);
+        createCanonicalCodeTable(codeLengths, codeTable);
+        fileHeader.nbBitstreams=nbBitstreams;
+        for(int i=0; i<NB_INTERLEAVED_BITSTREAMS; i++)
+            fileHeader.bitstreamSizes[i]=0;
+        if(sampledSize>0) // The size is estimated from the sample
+            encodedSize=((double) getEncodedSize(arrayOfOccurrences, codeTable))*originalFileSize/sampledSize;
+        else if(checkCodeLengths(codeLengths)>1) // The size of the bitstreams is saved in the header
+            encodedSize=getBitstreamSizes(bitstreamOccurrences, nbBitstreams, codeTable, fileHeader.bitstreamSizes);
+
+        startPhase(stats, PHASE_HEADER);
+        fileOutput=openOutputFile(fileNameOutput, pipelineDepth, pipelineBufferSize, NULL);
+        fileHeader.type=FILE_TYPE_SINGLE;
+        fileHeader.originalSize=originalFileSize;
+        memcpy(fileHeader.codeLengths, codeLengths, N_VALUES_IN_BYTE);
+        if(isCompressible(originalFileSize, createFileHeader(&fileHeader, headerBuffer)+encodedSize)){
+            fprintf(fileMessages, "Saving the length of the codes...\n");
+            fwriteAndCheck(headerBuffer, fileHeader.size, fileOutput);
+        }
+        else // The characters are spread too evenly to save enough bytes, so they are copied after the header
+            fileHeader.type=FILE_TYPE_STORED;
+        endPhase(stats);
+        if(fileHeader.type==FILE_TYPE_STORED){
+            fprintf(fileMessages, "Storing %s without encoding it, since it can't be compressed...\n", fileNameInput);
+            startPhase(stats, PHASE_ENCODE);
+            outputFileSize=storedCompression(inputFile.content, inputFile.size, &fileHeader, fileOutput);
+            endPhase(stats);
+            t_end=clock();
+            fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+            fprintf(fileMessages, "%.2f kB stored in %.2f kB (%.2f %%)",  ((float)originalFileSize)/1000, ((float)outputFileSize)/1000, (((float) outputFileSize)/originalFileSize)*100);
+            addedBits=0; // The codes are not used
+        }
+        else if(checkCodeLengths(codeLengths)==1){ // There is only one type of characters
+            fprintf(fileMessages, "Compressing %s...\n", fileNameInput); 
+            setCodeStats(stats, codeLengths, 0);
             t_end=clock();
-            printf("Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
-            outputFileSize=getSizeOfFile(fileOutput);
-            printf("%.2f kB compressed to %.2f kB (%.2f %%)",  ((float)originalFileSize)/1000, ((float)outputFileSize)/1000, (((float) outputFileSize)/originalFileSize)*100);
+            fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+            outputFileSize=fileHeader.size;
+            fprintf(fileMessages, "%.2f kB compressed to %.2f kB (%.2f %%)",  ((float)originalFileSize)/1000, ((float)outputFileSize)/1000, (((float) outputFileSize)/originalFileSize)*100);
+        }
+        else if(sampledSize>0){ // The file is read only once, by the encoding, which also counts its characters with --stats to compare the codes with the exact ones
+            fprintf(fileMessages, "Compressing %s with the codes of the sample...\n", fileNameInput);
+            startPhase(stats, PHASE_ENCODE);
+            encodingTime=getClockTime(CLOCK_MONOTONIC);
+            encodingCpuTime=getClockTime(CLOCK_PROCESS_CPUTIME_ID);
+            outputFileSize=fileHeader.size+sampledCompression(inputFile.content, inputFile.size, codeTable, fileOutput, (stats!=NULL) ? exactOccurrences : NULL, &countingTime);
+            encodingTime=getClockTime(CLOCK_MONOTONIC)-encodingTime;
+            encodingCpuTime=getClockTime(CLOCK_PROCESS_CPUTIME_ID)-encodingCpuTime;
+            endPhase(stats);
+            t_end=clock();
+            setCodeStats(stats, codeLengths, ((double) (outputFileSize-fileHeader.size))*8/originalFileSize);
+            fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+            fprintf(fileMessages, "%.2f kB compressed to %.2f kB (%.2f %%)",  ((float)originalFileSize)/1000, ((float)outputFileSize)/1000, (((float) outputFileSize)/originalFileSize)*100);
+            if(stats!=NULL){ // The codes of the sample are compared with the exact ones
+                createCodeLengths(exactOccurrences, exactCodeLengths, maxCodeLength);
+                createCanonicalCodeTable(exactCodeLengths, exactCodeTable);
+                encodedSize=fileHeader.size+getEncodedSize(exactOccurrences, exactCodeTable); // The header of the exact codes may be a bit smaller
+                encodingTime=(encodingTime>encodingCpuTime) ? encodingTime-encodingCpuTime : 0; // Time spent waiting for the pages of the file
+                fprintf(fileMessages, "\nThe codes were created from %.2f MB (%.2f %%) in %.3f s. Exact counting would have given %.2f kB, so the codes of the sample made the file %.3f %% bigger, but reading the whole file before encoding it would have taken about %.3f s more (%.3f s waiting for the file and %.3f s counting, minus the sampling)", ((float)sampledSize)/1000000, ((float)sampledSize)/originalFileSize*100, sampleTime, ((float)encodedSize)/1000, (((float) outputFileSize)/encodedSize-1)*100, encodingTime+countingTime-sampleTime, encodingTime, countingTime);
+            }
+            else
+                fprintf(fileMessages, "\nThe codes were created from %.2f MB (%.2f %%) in %.3f s", ((float)sampledSize)/1000000, ((float)sampledSize)/originalFileSize*100, sampleTime);
         }
         else{ // There are at least two types of characters
-            printf("Preparing the compression...\n");
-            createHuffmanArray(huffmanTree, huffmanArray);
+            if(stats!=NULL)
+                setCodeStats(stats, codeLengths, ((double) getEncodedSize(arrayOfOccurrences, codeTable))*8/originalFileSize);
             
-            freeTree(&huffmanTree);
-            printf("Compressing %s...\n", fileNameInput);
-            huffManCompression(fileInput, huffmanArray, fileOutput);
+            fprintf(fileMessages, "Compressing %s...\n", fileNameInput);
+            startPhase(stats, PHASE_ENCODE);
+            outputFileSize=fileHeader.size+huffManCompression(inputFile.content, inputFile.size, nbBitstreams, codeTable, fileOutput);
+            endPhase(stats);
             t_end=clock();
-            freeArray(huffmanArray);
-            printf("Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
-            outputFileSize=getSizeOfFile(fileOutput);
-            printf("%.2f kB compressed to %.2f kB (%.2f %%)",  ((float)originalFileSize)/1000, ((float)outputFileSize)/1000, (((float) outputFileSize)/originalFileSize)*100);
+            fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+            fprintf(fileMessages, "%.2f kB compressed to %.2f kB (%.2f %%)",  ((float)originalFileSize)/1000, ((float)outputFileSize)/1000, (((float) outputFileSize)/originalFileSize)*100);
+        }
+    }
+    else if(option==1 && (isRecursive || memberName!=NULL)){
+        //EXTRACT FROM AN ARCHIVE
+        startPhase(stats, PHASE_OPEN);
+        openInputFile(fileNameInput, &inputFile);
+        endPhase(stats);
+        t_start=clock();
+        startPhase(stats, PHASE_BLOCKS);
+        if(isRecursive){ // All the files are extracted in parallel in the directory DEST
+            fprintf(fileMessages, "Extracting %s in %s with %d threads...\n", fileNameInput, fileNameOutput, nbThreads);
+            originalFileSize=archiveExtraction(inputFile.content, inputFile.size, fileNameOutput, nbThreads, &nbArchiveMembers);
         }
+        else{ // Only the compressed content of this file is read, found with the central directory
+            fileOutput=openOutputFile(fileNameOutput, 0, 0, NULL);
+            fprintf(fileMessages, "Extracting %s from %s...\n", memberName, fileNameInput);
+            originalFileSize=archiveMemberExtraction(inputFile.content, inputFile.size, memberName, fileOutput);
+            nbArchiveMembers=1;
+        }
+        endPhase(stats);
+        t_end=clock();
+        fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+        fprintf(fileMessages, "%d file(s) extracted (%.2f kB)", nbArchiveMembers, ((float)originalFileSize)/1000);
+        fileHeader.size=FILE_HEADER_FIXED_SIZE;
+        if(stats!=NULL)
+            stats->bytesWritten=originalFileSize;
     }
     else if(option==1){
         //DECOMPRESS
         
 
-        fileInput=fopen(fileNameInput, "rb");
+        if(isInputStream){ // The stream is read by blocks without seeking
+            if(!strcmp(fileNameInput, "-"))
+                fileInput=stdin;
+            else
+                fileInput=fopen(fileNameInput, "rb");
+            checkFopen(fileInput);
+            if(pipelineDepth>0)
+                fileInput=openPipelinedFile(fileInput, 0, pipelineDepth, pipelineBufferSize);
+        }
+        else{
+            startPhase(stats, PHASE_OPEN);
+            openInputFile(fileNameInput, &inputFile);
+            endPhase(stats);
+            if(inputFile.size==0){
+                fprintf(stderr, "ERROR: the compressed file is empty\n");
+                exit(EXIT_FAILURE);
+            }
+            fileInput=fmemopen((void*) inputFile.content, inputFile.size, "rb"); // Used to read the header
+        }
         checkFopen(fileInput);
-        fileOutput=fopen(fileNameOutput, "wb");
-        checkFopen(fileOutput);
         t_start=clock();
-        printf("Getting data from the file...\n");
-        getDataFromCompressedFile(fileInput, &originalFileSize, &bufferChar, &bufferPos);
-
-        if(originalFileSize<1 || bufferChar.size<1){
+        fprintf(fileMessages, "Getting data from the file...\n");
+        startPhase(stats, PHASE_HEADER);
+        if(inputFile.content!=NULL) // The header is checked directly in the mapping
+            isBinaryHeader=readFileHeader(inputFile.content, inputFile.size, &fileHeader);
+        else
+            isBinaryHeader=getFileHeaderFromFile(fileInput, &fileHeader);
+        if(isBinaryHeader<0){
             fprintf(stderr, "ERROR: the data read from the file header is incorrect\n");
             exit(EXIT_FAILURE);
         }
+        formatVersion=isBinaryHeader ? FILE_FORMAT_VERSION : 1; // The files without binary header were compressed by the first version, where the tree is saved
+        if(formatVersion==1 && (inputFile.content==NULL || !isVersion1File(inputFile.content, inputFile.size))){ // The files of version 1 are never streams
+            fprintf(stderr, "ERROR: %s was not compressed by this program\n", fileNameInput);
+            exit(EXIT_FAILURE);
+        }
+        if(formatVersion==FILE_FORMAT_VERSION && inputFile.content!=NULL)
+            fseek(fileInput, fileHeader.size, SEEK_SET);
+        if(formatVersion==FILE_FORMAT_VERSION && fileHeader.type==FILE_TYPE_TABLE){ // The length of the codes are read from the table file
+            if(tableFileName==NULL){
+                fprintf(stderr, "ERROR: this file was compressed with the table %08x. Please give it with --table\n", (uint32_t) fileHeader.tableId);
+                exit(EXIT_FAILURE);
+            }
+            if(fileHeader.tableId!=sharedTable.id){
+                fprintf(stderr, "ERROR: this file was compressed with the table %08x, not with %08x\n", (uint32_t) fileHeader.tableId, sharedTable.id);
+                exit(EXIT_FAILURE);
+            }
+            memcpy(fileHeader.codeLengths, sharedTable.codeLengths, N_VALUES_IN_BYTE);
+            fileHeader.nbChars=sharedTable.nbChars;
+        }
+        if(formatVersion==FILE_FORMAT_VERSION && fileHeader.type==FILE_TYPE_ARCHIVE){
+            fprintf(stderr, "ERROR: this file is an archive. Please use -r to extract all its files, or --member to extract one of them\n");
+            exit(EXIT_FAILURE);
+        }
 
-        if(bufferPos.size<=0){
-            printf("Decompressing %s...\n", fileNameInput);
-            for(int i=0; i<originalFileSize; i++)
-                fputc(bufferChar.content[0], fileOutput);
-            t_end=clock();
-            printf("Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+        // DEST is only created or truncated once the header is checked
+        isWrittenByPosition=inputFile.content!=NULL && formatVersion==FILE_FORMAT_VERSION && (fileHeader.type==FILE_TYPE_BLOCKS || fileHeader.type==FILE_TYPE_STORED || fileHeader.nbBitstreams>1);
+        fileOutput=openOutputFile(fileNameOutput, pipelineDepth, pipelineBufferSize, &isWrittenByPosition);
+        if(formatVersion==FILE_FORMAT_VERSION && fileHeader.type==FILE_TYPE_BLOCKS && isWrittenByPosition){ // The file is split in blocks, that can be written at their position in the regular file
+            fprintf(fileMessages, "Decompressing %s with %d threads...\n", fileNameInput, nbThreads);
+            startPhase(stats, PHASE_BLOCKS);
+            parallelBlockDecompression(inputFile.content, inputFile.size, fileHeader.size, fileHeader.blockSize, fileHeader.nbBitstreams, fileHeader.originalSize, fileOutput, nbThreads);
         }
-        else{
-            printf("Building the Huffman tree from data...\n");
-            huffmanTree=buildHuffmanTreeFromBuffers(&bufferPos, &bufferChar);
+        else if(formatVersion==FILE_FORMAT_VERSION && (fileHeader.type==FILE_TYPE_BLOCKS || fileHeader.type==FILE_TYPE_STREAM)){ // The blocks are read and written one after the other
+            fprintf(fileMessages, "Decompressing %s...\n", fileNameInput);
+            startPhase(stats, PHASE_BLOCKS);
+            originalFileSize=blockDecompression(fileInput, fileHeader.blockSize, fileHeader.nbBitstreams, fileOutput);
+            if(fileHeader.type==FILE_TYPE_BLOCKS && originalFileSize!=fileHeader.originalSize){
+                fprintf(stderr, "ERROR: the blocks don't match the size of the original file\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if(formatVersion==FILE_FORMAT_VERSION && fileHeader.type==FILE_TYPE_ADAPTIVE){ // The tree is rebuilt while decoding, until the end marker
+            fprintf(fileMessages, "Decompressing %s with adaptive codes...\n", fileNameInput);
+            startPhase(stats, PHASE_DECODE);
+            if(inputFile.content==NULL)
+                originalFileSize=adaptiveDecompression(fileInput, NULL, 0, fileOutput);
+            else
+                originalFileSize=adaptiveDecompression(NULL, inputFile.content+fileHeader.size, inputFile.size-fileHeader.size, fileOutput);
+            if(stats!=NULL)
+                stats->bytesWritten=originalFileSize;
+        }
+        else if(formatVersion==FILE_FORMAT_VERSION && fileHeader.type==FILE_TYPE_STORED){ // The characters are copied without decoding them
+            fprintf(fileMessages, "Copying the stored content of %s...\n", fileNameInput);
+            startPhase(stats, PHASE_DECODE);
+            originalFileSize=fileHeader.originalSize;
+            storedDecompression(fileInput, (inputFile.content!=NULL) ? &inputFile : NULL, fileHeader.size, originalFileSize, fileOutput);
+            if(stats!=NULL)
+                stats->bytesWritten=originalFileSize;
+        }
+        else if(formatVersion==FILE_FORMAT_VERSION && fileHeader.type==FILE_TYPE_CONTEXT){ // The code tables of the contexts follow the header
+            fprintf(fileMessages, "Decompressing %s with the codes of the contexts...\n", fileNameInput);
+            startPhase(stats, PHASE_DECODE_TABLE);
+            if(inputFile.content==NULL)
+                contextSectionSize=readContextModelFromFile(fileInput, &contextModel);
+            else
+                contextSectionSize=readContextModel(inputFile.content+fileHeader.size, inputFile.size-fileHeader.size, &contextModel);
+            if(contextSectionSize<0){
+                fprintf(stderr, "ERROR: the code tables of the contexts are incorrect\n");
+                exit(EXIT_FAILURE);
+            }
+            startPhase(stats, PHASE_DECODE);
+            originalFileSize=fileHeader.originalSize;
+            if(inputFile.content==NULL)
+                contextDecompression(fileInput, NULL, 0, originalFileSize, &contextModel, fileOutput);
+            else
+                contextDecompression(NULL, inputFile.content+fileHeader.size+contextSectionSize, inputFile.size-fileHeader.size-contextSectionSize, originalFileSize, &contextModel, fileOutput);
+            fileHeader.size+=contextSectionSize;
+            if(stats!=NULL)
+                stats->bytesWritten=originalFileSize;
+        }
+        else if(formatVersion==1){ // The tree is saved in the file
+            getDataFromCompressedFile(fileInput, &originalFileSize, &bufferChar, &bufferPos);
 
-            printf("Decompressing %s...\n", fileNameInput);
-            huffManDecompression(fileInput, originalFileSize, huffmanTree, fileOutput);
-            t_end=clock();
-            printf("Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
-            freeTree(&huffmanTree);
+            if(originalFileSize<1 || bufferChar.size<1){
+                fprintf(stderr, "ERROR: the data read from the file header is incorrect\n");
+                exit(EXIT_FAILURE);
+            }
+
+            if(bufferPos.size<=0){
+                fprintf(fileMessages, "Decompressing %s...\n", fileNameInput);
+                for(uint64_t i=0; i<originalFileSize; i++)
+                    fputc(bufferChar.content[0], fileOutput);
+            }
+            else{
+                fprintf(fileMessages, "Building the Huffman tree from data...\n");
+                startPhase(stats, PHASE_CODE_TABLE);
+                huffmanTree=buildHuffmanTreeFromBuffers(&bufferPos, &bufferChar);
+
+                fprintf(fileMessages, "Decompressing %s...\n", fileNameInput);
+                startPhase(stats, PHASE_DECODE);
+                huffManDecompressionTreeWalk(fileInput, originalFileSize, 1, huffmanTree, fileOutput);
+                freeTree(&huffmanTree);
+            }
+        }
+        else{ // Only the length of the canonical codes are saved in the file
+            originalFileSize=fileHeader.originalSize;
+            memcpy(codeLengths, fileHeader.codeLengths, N_VALUES_IN_BYTE);
+            if(stats!=NULL){
+                setCodeStats(stats, codeLengths, (inputFile.content!=NULL && originalFileSize>0) ? ((double) (inputFile.size-fileHeader.size))*8/originalFileSize : -1);
+                stats->bytesWritten=originalFileSize;
+            }
+            if(fileHeader.nbChars==1){ // There is only one type of characters
+                if(originalFileSize<1){
+                    fprintf(stderr, "ERROR: the data read from the file header is incorrect\n");
+                    exit(EXIT_FAILURE);
+                }
+                fprintf(fileMessages, "Decompressing %s...\n", fileNameInput);
+                startPhase(stats, PHASE_DECODE);
+                for(int i=0; i<N_VALUES_IN_BYTE; i++){
+                    if(codeLengths[i]>0){
+                        for(uint64_t j=0; j<originalFileSize; j++)
+                            fputc(i, fileOutput);
+                    }
+                }
+            }
+            else if(useTreeWalk){
+                fprintf(fileMessages, "Building the Huffman tree from data...\n");
+                startPhase(stats, PHASE_CODE_TABLE);
+                createCanonicalCodeTable(codeLengths, codeTable);
+                huffmanTree=buildHuffmanTreeFromCodeTable(codeTable);
+
+                fprintf(fileMessages, "Decompressing %s...\n", fileNameInput);
+                startPhase(stats, PHASE_DECODE);
+                huffManDecompressionTreeWalk(fileInput, originalFileSize, fileHeader.nbBitstreams, huffmanTree, fileOutput);
+                freeTree(&huffmanTree);
+            }
+            else{
+                fprintf(fileMessages, "Building the decode table from data...\n");
+                startPhase(stats, PHASE_DECODE_TABLE);
+                createHuffmanDecoder(codeLengths, originalFileSize, &decoder);
+
+                fprintf(fileMessages, "Decompressing %s...\n", fileNameInput);
+                startPhase(stats, PHASE_DECODE);
+                if(inputFile.content==NULL) // The compressed data is read from the stream
+                    huffManDecompression(fileInput, NULL, 0, originalFileSize, fileHeader.nbBitstreams, &decoder, fileOutput);
+                else if(isWrittenByPosition) // The bitstreams are decoded at the same time and written at their position in the regular file
+                    huffManDecompressionInterleaved(inputFile.content+fileHeader.size, inputFile.size-fileHeader.size, originalFileSize, fileHeader.bitstreamSizes, &decoder, fileOutput);
+                else
+                    huffManDecompression(NULL, inputFile.content+fileHeader.size, inputFile.size-fileHeader.size, originalFileSize, fileHeader.nbBitstreams, &decoder, fileOutput);
+            }
+        }
+        endPhase(stats);
+        t_end=clock();
+        fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+    }
+    else if(option==2){
+        //TRAIN A SHARED TABLE
+        t_start=clock();
+        fprintf(fileMessages, "Counting the characters of the sample...\n");
+        startPhase(stats, PHASE_HISTOGRAM);
+        originalFileSize=countSampleOccurrences(fileNameInput, arrayOfOccurrences, &nbSampleFiles);
+        if(originalFileSize==0){
+            fprintf(fileMessages, "The sample is empty. Please give a file or a directory with at least one character\n");
+            return 0;
+        }
+        fprintf(fileMessages, "Creating the codes...\n");
+        startPhase(stats, PHASE_CODE_LENGTHS);
+        createSharedTable(arrayOfOccurrences, maxCodeLength, &sharedTable);
+        startPhase(stats, PHASE_HEADER);
+        saveSharedTable(&sharedTable, fileNameOutput);
+        endPhase(stats);
+        t_end=clock();
+        fprintf(fileMessages, "Done (%.2f s)\n", ((float)(t_end-t_start))/CLOCKS_PER_SEC);
+        fprintf(fileMessages, "Table %08x trained on %d file(s) (%.2f kB): %.3f bits per character on the sample",  sharedTable.id, nbSampleFiles, ((float)originalFileSize)/1000, ((double) getEncodedSize(arrayOfOccurrences, sharedTable.codeTable))*8/originalFileSize);
+        if(stats!=NULL){
+            stats->bytesRead=originalFileSize;
+            setCodeStats(stats, sharedTable.codeLengths, ((double) getEncodedSize(arrayOfOccurrences, sharedTable.codeTable))*8/originalFileSize);
         }
     }
     else{
         fprintf(stderr, "ERROR: incorrect option value\n");
         exit(EXIT_FAILURE);
     }
-    fcloseAndCheck(fileInput);
-    fcloseAndCheck(fileOutput);
+    if(option==0 && addedBits>0) // The Huffman codes were longer than maxCodeLength
+        fprintf(fileMessages, "\nLimiting the codes to %d bits added %.2f kB (+%.3f %%)", maxCodeLength, ((float)addedBits)/8000, (((float) addedBits)/8/(outputFileSize-addedBits/8))*100);
+    if(stats!=NULL){
+        if(inputFile.content!=NULL)
+            stats->bytesRead=inputFile.size;
+        else if(option==0)
+            stats->bytesRead=streamOriginalSize;
+        if(option==0)
+            stats->bytesWritten=outputFileSize;
+        else if(option==1 && fileOutput!=NULL && pipelineDepth>0 && !isWrittenByPosition)
+            stats->bytesWritten=ftello(fileOutput);
+        else if(option==1 && fileOutput!=NULL && isRegularFile(fileOutput))
+            stats->bytesWritten=getSizeOfFile(fileOutput);
+        if((option==0 && blockSize==0) || (option==1 && formatVersion!=1)) // The blocks and the streams have their own header, written by blockCompression and streamCompression
+            stats->headerSize=fileHeader.size;
+    }
+    startPhase(stats, PHASE_CLOSE);
+    if(fileInput!=NULL)
+        fcloseAndCheck(fileInput);
+    if(inputFile.fileDescriptor>=0)
+        closeInputFile(&inputFile);
+    if(fileOutput!=NULL)
+        fcloseAndCheck(fileOutput);
+    if(stats!=NULL){
+        fprintf(fileMessages, "\n");
+        printStats(stats, stderr);
+        freeStats(&stats);
+    }
     free(bufferChar.content);
     free(bufferPos.content);
     
     return 0;
-}
\ No newline at end of file
+}
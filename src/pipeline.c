@@ -0,0 +1,308 @@
+/**
+ * \file pipeline.c
+ * \brief Contains functions used to read or write a stream in another thread, through a ring of buffers, so that the coding doesn't wait for the I/O and the I/O doesn't wait for the coding
+ * \date 2021
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE  // Used for fopencookie
+#endif
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/file_functions.h"
+#include "../include/pipeline.h"
+
+/**
+ * \fn void* pipelineReader(void* argument)
+ * \brief Function run by the thread of a pipeline reading a file. It fills the free buffers one after the other with fread, until the end of the file or until the coding stops reading
+ * \param argument Pointer to the Pipeline
+ * \return NULL
+ */
+
+void* pipelineReader(void* argument)
+{
+    Pipeline* pipeline=(Pipeline*) argument;
+    size_t size=0;
+    int i_Buffer=0;
+
+    while(1){
+        pthread_mutex_lock(&pipeline->mutex);
+        while(pipeline->nbFullBuffers==pipeline->depth && !pipeline->isEnded)
+            pthread_cond_wait(&pipeline->changed, &pipeline->mutex);
+        if(pipeline->isEnded){ // The coding doesn't read anymore
+            pthread_mutex_unlock(&pipeline->mutex);
+            break;
+        }
+        i_Buffer=(pipeline->first+pipeline->nbFullBuffers)%pipeline->depth;
+        pthread_mutex_unlock(&pipeline->mutex);
+
+        size=fread(pipeline->content+i_Buffer*pipeline->bufferSize, 1, pipeline->bufferSize, pipeline->file);
+        if(size<pipeline->bufferSize && ferror(pipeline->file)){
+            fprintf(stderr, "ERROR: fread can't read the input file in pipelineReader\n");
+            exit(EXIT_FAILURE);
+        }
+        pthread_mutex_lock(&pipeline->mutex);
+        pipeline->sizes[i_Buffer]=size;
+        pipeline->nbFullBuffers++;
+        if(size<pipeline->bufferSize) // End of the file
+            pipeline->isEnded=1;
+        pthread_cond_broadcast(&pipeline->changed);
+        pthread_mutex_unlock(&pipeline->mutex);
+        if(size<pipeline->bufferSize)
+            break;
+    }
+    return NULL;
+}
+
+/**
+ * \fn void* pipelineWriter(void* argument)
+ * \brief Function run by the thread of a pipeline writing a file. It writes the full buffers in order with fwrite, until the coding has nothing left to write
+ * \param argument Pointer to the Pipeline
+ * \return NULL
+ */
+
+void* pipelineWriter(void* argument)
+{
+    Pipeline* pipeline=(Pipeline*) argument;
+    size_t size=0;
+    int i_Buffer=0;
+
+    while(1){
+        pthread_mutex_lock(&pipeline->mutex);
+        while(pipeline->nbFullBuffers==0 && !pipeline->isEnded)
+            pthread_cond_wait(&pipeline->changed, &pipeline->mutex);
+        if(pipeline->nbFullBuffers==0){ // All the buffers are written
+            pthread_mutex_unlock(&pipeline->mutex);
+            break;
+        }
+        i_Buffer=pipeline->first;
+        size=pipeline->sizes[i_Buffer];
+        pthread_mutex_unlock(&pipeline->mutex);
+
+        fwriteAndCheck(pipeline->content+i_Buffer*pipeline->bufferSize, size, pipeline->file);
+        pthread_mutex_lock(&pipeline->mutex);
+        pipeline->first=(pipeline->first+1)%pipeline->depth;
+        pipeline->nbFullBuffers--;
+        pthread_cond_broadcast(&pipeline->changed);
+        pthread_mutex_unlock(&pipeline->mutex);
+    }
+    return NULL;
+}
+
+/**
+ * \fn void submitPipelineBuffer(Pipeline* pipeline)
+ * \brief Gives the buffer filled by the coding to the thread writing the file, and waits until the next buffer is free
+ * \param pipeline Pipeline writing a file
+ */
+
+void submitPipelineBuffer(Pipeline* pipeline)
+{
+    pthread_mutex_lock(&pipeline->mutex);
+    pipeline->sizes[pipeline->current]=pipeline->position;
+    pipeline->nbFullBuffers++;
+    pthread_cond_broadcast(&pipeline->changed);
+    while(pipeline->nbFullBuffers==pipeline->depth)
+        pthread_cond_wait(&pipeline->changed, &pipeline->mutex);
+    pthread_mutex_unlock(&pipeline->mutex);
+    pipeline->current=(pipeline->current+1)%pipeline->depth;
+    pipeline->position=0;
+}
+
+/**
+ * \fn ssize_t readPipeline(void* cookie, char* buffer, size_t size)
+ * \brief Gives to the coding the bytes read by the thread of the pipeline. It's called by fread, fgetc... on the stream returned by openPipelinedFile
+ * \param cookie Pointer to the Pipeline
+ * \param buffer Buffer where the bytes are copied
+ * \param size Maximum number of bytes copied
+ * \return The number of bytes copied: less than size if the next buffer isn't full yet, 0 at the end of the file
+ */
+
+ssize_t readPipeline(void* cookie, char* buffer, size_t size)
+{
+    Pipeline* pipeline=(Pipeline*) cookie;
+    size_t nbCopiedBytes=0;
+    size_t nbBytes=0;
+    const unsigned char* content=NULL;
+
+    while(nbCopiedBytes<size){
+        pthread_mutex_lock(&pipeline->mutex);
+        if(pipeline->nbFullBuffers==0 && nbCopiedBytes>0){ // The bytes already copied are given without waiting
+            pthread_mutex_unlock(&pipeline->mutex);
+            break;
+        }
+        while(pipeline->nbFullBuffers==0 && !pipeline->isEnded)
+            pthread_cond_wait(&pipeline->changed, &pipeline->mutex);
+        if(pipeline->nbFullBuffers==0){ // All the file was read
+            pthread_mutex_unlock(&pipeline->mutex);
+            break;
+        }
+        nbBytes=pipeline->sizes[pipeline->first]-pipeline->position;
+        content=pipeline->content+pipeline->first*pipeline->bufferSize+pipeline->position;
+        pthread_mutex_unlock(&pipeline->mutex);
+
+        if(nbBytes>size-nbCopiedBytes)
+            nbBytes=size-nbCopiedBytes;
+        memcpy(buffer+nbCopiedBytes, content, nbBytes);
+        nbCopiedBytes+=nbBytes;
+        pipeline->position+=nbBytes;
+        if(pipeline->position==pipeline->sizes[pipeline->first]){ // The buffer can be filled again
+            pthread_mutex_lock(&pipeline->mutex);
+            pipeline->first=(pipeline->first+1)%pipeline->depth;
+            pipeline->nbFullBuffers--;
+            pthread_cond_broadcast(&pipeline->changed);
+            pthread_mutex_unlock(&pipeline->mutex);
+            pipeline->position=0;
+        }
+    }
+    pipeline->nbBytes+=nbCopiedBytes;
+    return nbCopiedBytes;
+}
+
+/**
+ * \fn ssize_t writePipeline(void* cookie, const char* buffer, size_t size)
+ * \brief Copies the bytes written by the coding in the buffers of the pipeline. It's called by fwrite, fputc... on the stream returned by openPipelinedFile
+ * \param cookie Pointer to the Pipeline
+ * \param buffer Bytes that are written
+ * \param size Number of bytes
+ * \return size, since all the bytes are copied
+ */
+
+ssize_t writePipeline(void* cookie, const char* buffer, size_t size)
+{
+    Pipeline* pipeline=(Pipeline*) cookie;
+    size_t nbCopiedBytes=0;
+    size_t nbBytes=0;
+
+    while(nbCopiedBytes<size){
+        nbBytes=pipeline->bufferSize-pipeline->position;
+        if(nbBytes>size-nbCopiedBytes)
+            nbBytes=size-nbCopiedBytes;
+        memcpy(pipeline->content+pipeline->current*pipeline->bufferSize+pipeline->position, buffer+nbCopiedBytes, nbBytes);
+        nbCopiedBytes+=nbBytes;
+        pipeline->position+=nbBytes;
+        if(pipeline->position==pipeline->bufferSize)
+            submitPipelineBuffer(pipeline);
+    }
+    pipeline->nbBytes+=size;
+    return size;
+}
+
+/**
+ * \fn int seekPipeline(void* cookie, int64_t* offset, int whence)
+ * \brief Gives the position of the coding in the stream, so that ftell can be used on it. The stream can't be seeked
+ * \param cookie Pointer to the Pipeline
+ * \param offset Offset that must be 0. It receives the number of bytes read or written by the coding
+ * \param whence Must be SEEK_CUR
+ * \return 0 if the position is given, -1 otherwise
+ */
+
+int seekPipeline(void* cookie, int64_t* offset, int whence)
+{
+    Pipeline* pipeline=(Pipeline*) cookie;
+
+    if(whence!=SEEK_CUR || *offset!=0)
+        return -1;
+    *offset=pipeline->nbBytes;
+    return 0;
+}
+
+/**
+ * \fn int closePipeline(void* cookie)
+ * \brief Ends a pipeline when its stream is closed: the last buffer is written, or the thread reading the file is stopped, then the thread is joined and the file is closed
+ * \param cookie Pointer to the Pipeline, freed by this function
+ * \return 0
+ */
+
+int closePipeline(void* cookie)
+{
+    Pipeline* pipeline=(Pipeline*) cookie;
+
+    if(pipeline->isWriter && pipeline->position>0)
+        submitPipelineBuffer(pipeline);
+    pthread_mutex_lock(&pipeline->mutex);
+    pipeline->isEnded=1;
+    pthread_cond_broadcast(&pipeline->changed);
+    pthread_mutex_unlock(&pipeline->mutex);
+    if(pthread_join(pipeline->thread, NULL)!=0){
+        fprintf(stderr, "ERROR: can't wait for the end of a thread\n");
+        exit(EXIT_FAILURE);
+    }
+    fcloseAndCheck(pipeline->file);
+    pthread_mutex_destroy(&pipeline->mutex);
+    pthread_cond_destroy(&pipeline->changed);
+    free(pipeline->content);
+    free(pipeline->sizes);
+    free(pipeline);
+    return 0;
+}
+
+/**
+ * \fn FILE* openPipelinedFile(FILE* file, int isWriter, int depth, size_t bufferSize)
+ * \brief Starts a thread that reads or writes a file through a ring of buffers, and returns a stream used like the file by the coding. While the coding works on a buffer, the thread reads the next ones in advance, or writes the previous ones. It's useful for the pipes and the slow or network file systems, where the I/O takes as much time as the coding. When the stream is closed, the file is closed too
+ * \param file File opened for reading or writing, from its current position. It must not be seeked
+ * \param isWriter 1 if the file is written, 0 if it's read
+ * \param depth Number of buffers, at least 2 so that one is used by the coding while the other one is used by the thread
+ * \param bufferSize Size of each buffer, in bytes
+ * \return The stream used instead of file, or file itself when the streams can't be created by this system
+ */
+
+FILE* openPipelinedFile(FILE* file, int isWriter, int depth, size_t bufferSize)
+{
+#ifdef __linux__
+    Pipeline* pipeline=NULL;
+    FILE* pipelinedFile=NULL;
+    cookie_io_functions_t functions={.read=readPipeline, .write=writePipeline, .seek=(cookie_seek_function_t*) seekPipeline, .close=closePipeline};
+
+    MALLOC(pipeline, Pipeline, 1);
+    MALLOC(pipeline->content, unsigned char, depth*bufferSize);
+    MALLOC(pipeline->sizes, size_t, depth);
+    pipeline->file=file;
+    pipeline->isWriter=isWriter;
+    pipeline->depth=depth;
+    pipeline->bufferSize=bufferSize;
+    pipeline->first=0;
+    pipeline->nbFullBuffers=0;
+    pipeline->current=0;
+    pipeline->position=0;
+    pipeline->nbBytes=0;
+    pipeline->isEnded=0;
+    pthread_mutex_init(&pipeline->mutex, NULL);
+    pthread_cond_init(&pipeline->changed, NULL);
+    if(pthread_create(&pipeline->thread, NULL, isWriter ? pipelineWriter : pipelineReader, pipeline)!=0){
+        fprintf(stderr, "ERROR: can't create a thread\n");
+        exit(EXIT_FAILURE);
+    }
+    pipelinedFile=fopencookie(pipeline, isWriter ? "wb" : "rb", functions);
+    checkFopen(pipelinedFile);
+    return pipelinedFile;
+#else
+    return file; // The file is read or written by the coding itself
+#endif
+}
+
+/**
+ * \fn FILE* openOutputFile(const char* fileName, int pipelineDepth, size_t pipelineBufferSize, int* isWrittenByPosition)
+ * \brief Opens the file where the result is written and, when pipelineDepth isn't 0, writes it through a pipeline (see openPipelinedFile), unless its parts are written at their position
+ * \param fileName Name of the file, - for stdout
+ * \param pipelineDepth Number of buffers of the pipeline, 0 if the file is written by the coding itself
+ * \param pipelineBufferSize Size of each buffer of the pipeline, in bytes
+ * \param isWrittenByPosition 1 if the format lets the parts be written at their position, 0 otherwise. It receives 1 only if the file is also a regular file, so that the parts are written in order in the pipes, the devices and the pipeline. NULL if the file is always written in order
+ * \return The opened file. If it can't be opened then the program is stopped
+ */
+
+FILE* openOutputFile(const char* fileName, int pipelineDepth, size_t pipelineBufferSize, int* isWrittenByPosition)
+{
+    FILE* file=NULL;
+
+    if(!strcmp(fileName, "-"))
+        file=stdout;
+    else
+        file=fopen(fileName, "wb");
+    checkFopen(file);
+    if(isWrittenByPosition!=NULL)
+        *isWrittenByPosition=*isWrittenByPosition && isRegularFile(file);
+    if(pipelineDepth>0 && (isWrittenByPosition==NULL || !*isWrittenByPosition)) // The parts that are coded are written by another thread while the next ones are coded
+        file=openPipelinedFile(file, 1, pipelineDepth, pipelineBufferSize);
+    return file;
+}
@@ -0,0 +1,164 @@
+/**
+ * \file shared_table.c
+ * \brief Contains functions used to train Huffman codes on a sample corpus and to save them in a table file shared by many small files
+ * \date 2021
+ */
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/file_functions.h"
+#include "../include/input_file.h"
+#include "../include/histogram.h"
+#include "../include/huffman_coding_table.h"
+#include "../include/archive.h"
+#include "../include/shared_table.h"
+#include <sys/stat.h>  // Used for stat
+
+/**
+ * \fn uint32_t getTableId(unsigned char codeLengths[N_VALUES_IN_BYTE])
+ * \brief Gives the ID of a table, computed from the length of its codes (FNV-1a hash), so that the same codes always have the same ID
+ * \param codeLengths Length of the code of each character
+ * \return The ID of the table
+ */
+
+uint32_t getTableId(unsigned char codeLengths[N_VALUES_IN_BYTE])
+{
+    uint32_t hash=2166136261u;
+
+    for(int i=0; i<N_VALUES_IN_BYTE; i++){
+        hash^=codeLengths[i];
+        hash*=16777619u;
+    }
+    return hash;
+}
+
+/**
+ * \fn uint64_t countFileOccurrences(const char* fileName, uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE])
+ * \brief Adds the occurrences of each character of a file to arrayOfOccurrences
+ * \param fileName Name of the file
+ * \param arrayOfOccurrences Array to which the occurrences are added
+ * \return The size of the file
+ */
+
+uint64_t countFileOccurrences(const char* fileName, uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE])
+{
+    InputFile inputFile;
+    uint64_t fileOccurrences[N_VALUES_IN_BYTE];
+    uint64_t size=0;
+
+    openInputFile(fileName, &inputFile);
+    if(inputFile.size>0){
+        countOccurrences(inputFile.content, inputFile.size, fileOccurrences);
+        for(int i=0; i<N_VALUES_IN_BYTE; i++)
+            arrayOfOccurrences[i]+=fileOccurrences[i];
+    }
+    size=inputFile.size;
+    closeInputFile(&inputFile);
+    return size;
+}
+
+/**
+ * \fn uint64_t countSampleOccurrences(const char* path, uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE], int* nbFiles)
+ * \brief Counts the occurrences of each character in a sample corpus: a file, or all the regular files of a directory and of its sub-directories, listed like the files of an archive
+ * \param path Name of the file or of the directory
+ * \param arrayOfOccurrences Array receiving the occurrences of the characters
+ * \param nbFiles Receives the number of files read
+ * \return The number of characters counted
+ */
+
+uint64_t countSampleOccurrences(const char* path, uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE], int* nbFiles)
+{
+    struct stat fileStat;
+    ArchiveMember* files=NULL;
+    char* fileName=NULL;
+    uint64_t sampleSize=0;
+    uint64_t nbCountedChars=0;
+
+    for(int i=0; i<N_VALUES_IN_BYTE; i++)
+        arrayOfOccurrences[i]=0;
+    *nbFiles=0;
+    if(stat(path, &fileStat)!=0 || !S_ISDIR(fileStat.st_mode)){
+        *nbFiles=1;
+        return countFileOccurrences(path, arrayOfOccurrences);
+    }
+
+    files=listArchiveMembers(path, nbFiles, &sampleSize);
+    for(int i=0; i<*nbFiles; i++){
+        fileName=joinPath(path, files[i].name);
+        nbCountedChars+=countFileOccurrences(fileName, arrayOfOccurrences);
+        free(fileName);
+    }
+    freeArchiveMembers(&files, *nbFiles);
+    return nbCountedChars;
+}
+
+/**
+ * \fn uint64_t createSharedTable(uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE], int maxCodeLength, SharedTable* table)
+ * \brief Creates the codes of a shared table from the occurrences of the characters in the sample corpus. The characters that are not in the sample are counted once, so that every character has a code and any file can be compressed with the table
+ * \param arrayOfOccurrences Occurrences of the characters in the sample corpus. The missing characters are set to 1
+ * \param maxCodeLength Maximum length of the Huffman codes
+ * \param table Table that is created
+ * \return The number of bits added to the sample by the limit of the length of the codes
+ */
+
+uint64_t createSharedTable(uint64_t arrayOfOccurrences[N_VALUES_IN_BYTE], int maxCodeLength, SharedTable* table)
+{
+    uint64_t addedBits=0;
+
+    for(int i=0; i<N_VALUES_IN_BYTE; i++){
+        if(arrayOfOccurrences[i]==0)
+            arrayOfOccurrences[i]=1;
+    }
+    addedBits=createCodeLengths(arrayOfOccurrences, table->codeLengths, maxCodeLength);
+    createCanonicalCodeTable(table->codeLengths, table->codeTable);
+    table->nbChars=N_VALUES_IN_BYTE;
+    table->id=getTableId(table->codeLengths);
+    return addedBits;
+}
+
+/**
+ * \fn void saveSharedTable(SharedTable* table, const char* fileName)
+ * \brief Saves a shared table in a file: TABLE_MAGIC, the version of the format, the ID of the table and the length of the codes
+ * \param table Table that is saved
+ * \param fileName Name of the table file
+ */
+
+void saveSharedTable(SharedTable* table, const char* fileName)
+{
+    unsigned char buffer[TABLE_HEADER_SIZE+N_VALUES_IN_BYTE+1];
+    int size=TABLE_HEADER_SIZE;
+    FILE* fileOutput=fopen(fileName, "wb");
+
+    checkFopen(fileOutput);
+    memcpy(buffer, TABLE_MAGIC, 4);
+    buffer[4]=TABLE_FORMAT_VERSION;
+    writeLittleEndian(buffer+5, table->id, 4);
+    size+=saveCodeLengthsInBuffer(table->codeLengths, buffer+size);
+    fwriteAndCheck(buffer, size, fileOutput);
+    fcloseAndCheck(fileOutput);
+}
+
+/**
+ * \fn void loadSharedTable(const char* fileName, SharedTable* table)
+ * \brief Reads and checks a table file saved by saveSharedTable, and creates its codes. If the file is incorrect then the program is stopped
+ * \param fileName Name of the table file
+ * \param table Table that is read
+ */
+
+void loadSharedTable(const char* fileName, SharedTable* table)
+{
+    InputFile inputFile;
+    int sectionSize=-1;
+
+    openInputFile(fileName, &inputFile);
+    if(inputFile.size>=TABLE_HEADER_SIZE && !memcmp(inputFile.content, TABLE_MAGIC, 4) && inputFile.content[4]==TABLE_FORMAT_VERSION){
+        table->id=readLittleEndian(inputFile.content+5, 4);
+        sectionSize=getCodeLengthsFromBuffer(inputFile.content+TABLE_HEADER_SIZE, inputFile.size-TABLE_HEADER_SIZE, table->codeLengths, &table->nbChars);
+    }
+    if(sectionSize<0 || (size_t) (TABLE_HEADER_SIZE+sectionSize)!=inputFile.size || table->nbChars<2 || table->id!=getTableId(table->codeLengths)){
+        fprintf(stderr, "ERROR: %s is not a correct table file\n", fileName);
+        exit(EXIT_FAILURE);
+    }
+    closeInputFile(&inputFile);
+    createCanonicalCodeTable(table->codeLengths, table->codeTable);
+}
@@ -0,0 +1,319 @@
+/**
+ * \file stats.c
+ * \brief Contains the functions measuring the time and the hardware counters of each phase for the option --stats
+ * \date 2021
+ */
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/stats.h"
+#include <time.h>  // Used for clock_gettime
+#include <unistd.h>  // Used for read and close
+#include <sys/resource.h>  // Used for getrusage
+#ifdef __linux__
+#include <sys/syscall.h>  // Used for perf_event_open, which has no wrapper in the libc
+#include <linux/perf_event.h>  // Used for the hardware counters
+#endif
+
+/**
+ * \fn Stats* createStats(int format)
+ * \brief Creates the statistics of a run and opens the hardware counters that are available
+ * \param format STATS_TEXT or STATS_JSON
+ * \return The new statistics
+ */
+
+Stats* createStats(int format)
+{
+    Stats* stats=NULL;
+
+    MALLOC(stats, Stats, 1);
+    memset(stats, 0, sizeof(Stats));
+    stats->format=format;
+    stats->currentPhase=-1;
+    stats->averageCodeLength=-1;
+    stats->bytesRead=UINT64_MAX;
+    stats->bytesWritten=UINT64_MAX;
+    openPerfCounters(stats);
+    return stats;
+}
+
+/**
+ * \fn void freeStats(Stats** stats)
+ * \brief Closes the hardware counters and frees the statistics
+ * \param stats Statistics that are freed, set to NULL
+ */
+
+void freeStats(Stats** stats)
+{
+    if(*stats==NULL)
+        return;
+    for(int i=0; i<NB_PERF_COUNTERS; i++){
+        if((*stats)->perfDescriptors[i]>=0)
+            close((*stats)->perfDescriptors[i]);
+    }
+    free(*stats);
+    *stats=NULL;
+}
+
+/**
+ * \fn void openPerfCounters(Stats* stats)
+ * \brief Opens the hardware counters with perf_event_open. They count the user space of this process and of the threads it creates. A counter that can't be opened (other system, virtual machine, perf_event_paranoid...) is just not displayed
+ * \param stats Statistics whose perfDescriptors are set
+ */
+
+void openPerfCounters(Stats* stats)
+{
+#ifdef __linux__
+    static const uint32_t types[NB_PERF_COUNTERS]={PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE};
+    static const uint64_t configs[NB_PERF_COUNTERS]={
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ<<8) | (PERF_COUNT_HW_CACHE_RESULT_MISS<<16),
+        PERF_COUNT_HW_CACHE_MISSES
+    };
+    struct perf_event_attr attributes;
+
+    for(int i=0; i<NB_PERF_COUNTERS; i++){
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.size=sizeof(attributes);
+        attributes.type=types[i];
+        attributes.config=configs[i];
+        attributes.exclude_kernel=1;
+        attributes.exclude_hv=1;
+        attributes.inherit=1; // The threads compressing the blocks are counted too
+        stats->perfDescriptors[i]=(int) syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+    }
+#else
+    for(int i=0; i<NB_PERF_COUNTERS; i++)
+        stats->perfDescriptors[i]=-1;
+#endif
+}
+
+/**
+ * \fn uint64_t readPerfCounter(int perfDescriptor)
+ * \brief Reads the value of a hardware counter
+ * \param perfDescriptor File descriptor of the counter
+ * \return Value of the counter, 0 if it can't be read
+ */
+
+uint64_t readPerfCounter(int perfDescriptor)
+{
+    uint64_t value=0;
+
+    if(perfDescriptor<0 || read(perfDescriptor, &value, sizeof(value))!=sizeof(value))
+        return 0;
+    return value;
+}
+
+/**
+ * \fn double getClockTime(clockid_t clock)
+ * \brief Gives the time of a clock in seconds
+ * \param clock CLOCK_MONOTONIC for the elapsed time, CLOCK_PROCESS_CPUTIME_ID for the processor time of all the threads
+ * \return Time in seconds
+ */
+
+double getClockTime(clockid_t clock)
+{
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return now.tv_sec+now.tv_nsec*1e-9;
+}
+
+/**
+ * \fn void startPhase(Stats* stats, int phase)
+ * \brief Starts measuring a phase, after ending the current one. Does nothing when stats is NULL, so that --stats costs nothing when it isn't given
+ * \param stats Statistics of the run, or NULL
+ * \param phase Phase that starts (PHASE_OPEN, PHASE_HISTOGRAM...)
+ */
+
+void startPhase(Stats* stats, int phase)
+{
+    struct rusage usage;
+
+    if(stats==NULL)
+        return;
+    endPhase(stats);
+    stats->currentPhase=phase;
+    getrusage(RUSAGE_SELF, &usage);
+    stats->startMinorFaults=usage.ru_minflt;
+    stats->startMajorFaults=usage.ru_majflt;
+    for(int i=0; i<NB_PERF_COUNTERS; i++)
+        stats->startCounters[i]=readPerfCounter(stats->perfDescriptors[i]);
+    stats->startCpuTime=getClockTime(CLOCK_PROCESS_CPUTIME_ID);
+    stats->startWallTime=getClockTime(CLOCK_MONOTONIC);
+}
+
+/**
+ * \fn void endPhase(Stats* stats)
+ * \brief Ends the current phase and adds what it used to its statistics. Does nothing when stats is NULL or when no phase is measured
+ * \param stats Statistics of the run, or NULL
+ */
+
+void endPhase(Stats* stats)
+{
+    double wallTime=0;
+    double cpuTime=0;
+    struct rusage usage;
+    PhaseStats* phase=NULL;
+
+    if(stats==NULL || stats->currentPhase<0)
+        return;
+    wallTime=getClockTime(CLOCK_MONOTONIC);
+    cpuTime=getClockTime(CLOCK_PROCESS_CPUTIME_ID);
+    phase=&stats->phases[stats->currentPhase];
+    for(int i=0; i<NB_PERF_COUNTERS; i++)
+        phase->counters[i]+=readPerfCounter(stats->perfDescriptors[i])-stats->startCounters[i];
+    getrusage(RUSAGE_SELF, &usage);
+    phase->minorFaults+=usage.ru_minflt-stats->startMinorFaults;
+    phase->majorFaults+=usage.ru_majflt-stats->startMajorFaults;
+    phase->wallTime+=wallTime-stats->startWallTime;
+    phase->cpuTime+=cpuTime-stats->startCpuTime;
+    phase->nbRuns++;
+    stats->currentPhase=-1;
+}
+
+/**
+ * \fn void setCodeStats(Stats* stats, unsigned char codeLengths[N_VALUES_IN_BYTE], double averageCodeLength)
+ * \brief Saves the number of characters and the length of their codes. Does nothing when stats is NULL
+ * \param stats Statistics of the run, or NULL
+ * \param codeLengths Length of the code of each character, 0 if the character isn't in the file
+ * \param averageCodeLength Average number of bits per character
+ */
+
+void setCodeStats(Stats* stats, unsigned char codeLengths[N_VALUES_IN_BYTE], double averageCodeLength)
+{
+    if(stats==NULL)
+        return;
+    stats->nbChars=0;
+    stats->maxCodeLength=0;
+    for(int i=0; i<N_VALUES_IN_BYTE; i++){
+        if(codeLengths[i]>0)
+            stats->nbChars++;
+        if(codeLengths[i]>stats->maxCodeLength)
+            stats->maxCodeLength=codeLengths[i];
+    }
+    stats->averageCodeLength=averageCodeLength;
+}
+
+/**
+ * \fn const char* getPhaseName(int phase)
+ * \brief Gives the name of a phase, as displayed by --stats
+ * \param phase Phase (PHASE_OPEN, PHASE_HISTOGRAM...)
+ * \return Name of the phase
+ */
+
+const char* getPhaseName(int phase)
+{
+    static const char* names[NB_PHASES]={"open", "histogram", "code_lengths", "code_table", "header", "encode", "decode_table", "decode", "blocks", "close"};
+    return names[phase];
+}
+
+/**
+ * \fn const char* getPerfCounterName(int counter)
+ * \brief Gives the name of a hardware counter, as displayed by --stats
+ * \param counter Index of the counter
+ * \return Name of the counter
+ */
+
+const char* getPerfCounterName(int counter)
+{
+    static const char* names[NB_PERF_COUNTERS]={"cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses"};
+    return names[counter];
+}
+
+/**
+ * \fn void printStatsSize(FILE* fileOutput, const char* label, uint64_t size, const char* unknown, const char* end)
+ * \brief Displays a size of the statistics, which can be unknown
+ * \param fileOutput File where the size is displayed
+ * \param label Text displayed before the size
+ * \param size Size displayed, UINT64_MAX if it's unknown
+ * \param unknown Text displayed instead of an unknown size
+ * \param end Text displayed after the size
+ */
+
+void printStatsSize(FILE* fileOutput, const char* label, uint64_t size, const char* unknown, const char* end)
+{
+    if(size==UINT64_MAX)
+        fprintf(fileOutput, "%s%s%s", label, unknown, end);
+    else
+        fprintf(fileOutput, "%s%" PRIu64 "%s", label, size, end);
+}
+
+/**
+ * \fn void printStats(Stats* stats, FILE* fileOutput)
+ * \brief Displays the statistics of the phases that were run, then the sizes and the codes. Ends the current phase first
+ * \param stats Statistics of the run, or NULL (nothing is displayed)
+ * \param fileOutput File where the statistics are displayed
+ */
+
+void printStats(Stats* stats, FILE* fileOutput)
+{
+    int isFirst=1;
+
+    if(stats==NULL)
+        return;
+    endPhase(stats);
+    if(stats->format==STATS_JSON){
+        fprintf(fileOutput, "{\n  \"phases\": {");
+        for(int p=0; p<NB_PHASES; p++){
+            PhaseStats* phase=&stats->phases[p];
+            if(phase->nbRuns==0)
+                continue;
+            fprintf(fileOutput, "%s\n    \"%s\": {\"wall_s\": %.6f, \"cpu_s\": %.6f, \"minor_faults\": %ld, \"major_faults\": %ld", isFirst ? "" : ",", getPhaseName(p), phase->wallTime, phase->cpuTime, phase->minorFaults, phase->majorFaults);
+            for(int i=0; i<NB_PERF_COUNTERS; i++){
+                if(stats->perfDescriptors[i]>=0)
+                    fprintf(fileOutput, ", \"%s\": %" PRIu64, getPerfCounterName(i), phase->counters[i]);
+                else
+                    fprintf(fileOutput, ", \"%s\": null", getPerfCounterName(i));
+            }
+            fprintf(fileOutput, "}");
+            isFirst=0;
+        }
+        fprintf(fileOutput, "\n  },\n");
+        printStatsSize(fileOutput, "  \"bytes_read\": ", stats->bytesRead, "null", ",\n");
+        printStatsSize(fileOutput, "  \"bytes_written\": ", stats->bytesWritten, "null", ",\n");
+        if(stats->headerSize>0)
+            fprintf(fileOutput, "  \"header_size\": %d,\n", stats->headerSize);
+        else
+            fprintf(fileOutput, "  \"header_size\": null,\n");
+        if(stats->nbChars>0)
+            fprintf(fileOutput, "  \"nb_chars\": %d,\n  \"max_code_length\": %d,\n", stats->nbChars, stats->maxCodeLength);
+        else
+            fprintf(fileOutput, "  \"nb_chars\": null,\n  \"max_code_length\": null,\n");
+        if(stats->averageCodeLength>=0)
+            fprintf(fileOutput, "  \"average_code_length\": %.4f\n}\n", stats->averageCodeLength);
+        else
+            fprintf(fileOutput, "  \"average_code_length\": null\n}\n");
+    }
+    else{
+        fprintf(fileOutput, "\n%-13s %10s %10s %10s %10s", "phase", "wall (s)", "cpu (s)", "min. flt", "maj. flt");
+        for(int i=0; i<NB_PERF_COUNTERS; i++)
+            fprintf(fileOutput, " %14s", getPerfCounterName(i));
+        fprintf(fileOutput, "\n");
+        for(int p=0; p<NB_PHASES; p++){
+            PhaseStats* phase=&stats->phases[p];
+            if(phase->nbRuns==0)
+                continue;
+            fprintf(fileOutput, "%-13s %10.4f %10.4f %10ld %10ld", getPhaseName(p), phase->wallTime, phase->cpuTime, phase->minorFaults, phase->majorFaults);
+            for(int i=0; i<NB_PERF_COUNTERS; i++){
+                if(stats->perfDescriptors[i]>=0)
+                    fprintf(fileOutput, " %14" PRIu64, phase->counters[i]);
+                else
+                    fprintf(fileOutput, " %14s", "-");
+            }
+            fprintf(fileOutput, "\n");
+        }
+        printStatsSize(fileOutput, "bytes read: ", stats->bytesRead, "unknown", "");
+        printStatsSize(fileOutput, ", bytes written: ", stats->bytesWritten, "unknown", "");
+        if(stats->headerSize>0)
+            fprintf(fileOutput, ", header: %d bytes", stats->headerSize);
+        fprintf(fileOutput, "\n");
+        if(stats->nbChars>0)
+            fprintf(fileOutput, "characters: %d, maximum code length: %d bits", stats->nbChars, stats->maxCodeLength);
+        if(stats->averageCodeLength>=0)
+            fprintf(fileOutput, ", average code length: %.4f bits", stats->averageCodeLength);
+        if(stats->nbChars>0)
+            fprintf(fileOutput, "\n");
+    }
+}
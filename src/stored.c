@@ -0,0 +1,93 @@
+/**
+ * \file stored.c
+ * \brief Contains functions used to store the files that can't be compressed: their characters are copied after the header without being encoded
+ * \date 2021
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE  // Used for copy_file_range
+#endif
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/file_functions.h"
+#include "../include/header.h"
+#include "../include/stored.h"
+#include <unistd.h>  // Used for copy_file_range
+
+/**
+ * \fn int isCompressible(uint64_t originalSize, uint64_t compressedSize)
+ * \brief Tells if encoding data saves enough bytes to be worth decoding it, from the size of its encoded version estimated with the histogram and the length of the codes before encoding it
+ * \param originalSize Size of the data
+ * \param compressedSize Size that the encoded data would have, with its header
+ * \return 1 if the data has to be encoded, 0 if it has to be stored
+ */
+
+int isCompressible(uint64_t originalSize, uint64_t compressedSize)
+{
+    return compressedSize+originalSize/STORED_MIN_GAIN<originalSize;
+}
+
+/**
+ * \fn uint64_t storedCompression(const unsigned char* input, size_t inputSize, FileHeader* header, FILE* fileOutput)
+ * \brief Writes a file of type FILE_TYPE_STORED: a header containing the original size, followed by the characters of input
+ * \param input Content of the file that is stored
+ * \param inputSize Size of input
+ * \param header Header of the file, whose content is set by this function
+ * \param fileOutput File where the stored file is written
+ * \return The number of bytes written in fileOutput
+ */
+
+uint64_t storedCompression(const unsigned char* input, size_t inputSize, FileHeader* header, FILE* fileOutput)
+{
+    header->type=FILE_TYPE_STORED;
+    header->originalSize=inputSize;
+    header->nbBitstreams=1;
+    saveFileHeader(header, fileOutput);
+    fwriteAndCheck(input, inputSize, fileOutput);
+    return header->size+inputSize;
+}
+
+/**
+ * \fn void storedDecompression(FILE* fileInput, const InputFile* inputFile, uint64_t offset, uint64_t fileSize, FILE* fileOutput)
+ * \brief Copies the characters of a file of type FILE_TYPE_STORED without decoding them. On Linux, the characters of a file are copied by the kernel with copy_file_range, without going through the memory of the process, when the output is a regular file
+ * \param fileInput Stored file read from its current position, just after the header. It's only used if inputFile is NULL
+ * \param inputFile Content of the stored file, or NULL if it's read from fileInput
+ * \param offset Size of the header, i.e. position of the first character in inputFile
+ * \param fileSize Number of characters, read from the header
+ * \param fileOutput File where the characters are written
+ */
+
+void storedDecompression(FILE* fileInput, const InputFile* inputFile, uint64_t offset, uint64_t fileSize, FILE* fileOutput)
+{
+    unsigned char* buffer=NULL;
+    size_t size=0;
+#ifdef __linux__
+    loff_t inputOffset=offset;
+    ssize_t nbCopiedBytes=0;
+#endif
+
+    if(inputFile==NULL){ // The stream is copied by blocks
+        MALLOC(buffer, unsigned char, IO_BUFFER_SIZE);
+        while(fileSize>0){
+            size=(fileSize<IO_BUFFER_SIZE) ? fileSize : IO_BUFFER_SIZE;
+            freadAndCheck(buffer, size, fileInput);
+            fwriteAndCheck(buffer, size, fileOutput);
+            fileSize-=size;
+        }
+        free(buffer);
+        return;
+    }
+    if(inputFile->size-offset!=fileSize){
+        fprintf(stderr, "ERROR: the size of the stored file is incorrect\n");
+        exit(EXIT_FAILURE);
+    }
+#ifdef __linux__
+    if(fflush(fileOutput)==0){
+        while(fileSize>0 && (nbCopiedBytes=copy_file_range(inputFile->fileDescriptor, &inputOffset, fileno(fileOutput), NULL, fileSize, 0))>0)
+            fileSize-=nbCopiedBytes;
+        offset=inputOffset; // The characters that weren't copied (e.g. in a pipe) are written from the mapping
+    }
+#endif
+    fwriteAndCheck(inputFile->content+offset, fileSize, fileOutput);
+}
@@ -0,0 +1,64 @@
+/**
+ * \file threads.c
+ * \brief Contains functions used to start and wait for the threads compressing or decompressing blocks in parallel
+ * \date 2021
+ */
+
+#include "../include/types.h"
+#include "../include/macros_constants_headers.h"
+#include "../include/threads.h"
+#include <unistd.h>  // Used for sysconf
+
+/**
+ * \fn pthread_t* startThreads(void* (*function)(void*), void* argument, int nbThreads)
+ * \brief Starts threads that all run the same function with the same argument
+ * \param function Function run by each thread
+ * \param argument Argument given to the function. It's shared by all the threads
+ * \param nbThreads Number of threads started
+ * \return Array containing the threads. It's freed by joinThreads
+ */
+
+pthread_t* startThreads(void* (*function)(void*), void* argument, int nbThreads)
+{
+    pthread_t* threads=NULL;
+    MALLOC(threads, pthread_t, nbThreads);
+    for(int i=0; i<nbThreads; i++){
+        if(pthread_create(&threads[i], NULL, function, argument)!=0){
+            fprintf(stderr, "ERROR: can't create a thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return threads;
+}
+
+/**
+ * \fn void joinThreads(pthread_t* threads, int nbThreads)
+ * \brief Waits until all the threads are finished and frees the array containing them
+ * \param threads Array containing the threads, returned by startThreads
+ * \param nbThreads Number of threads in the array
+ */
+
+void joinThreads(pthread_t* threads, int nbThreads)
+{
+    for(int i=0; i<nbThreads; i++){
+        if(pthread_join(threads[i], NULL)!=0){
+            fprintf(stderr, "ERROR: can't wait for the end of a thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    free(threads);
+}
+
+/**
+ * \fn int getNumberOfCores()
+ * \brief Gives the number of cores that can be used by the threads
+ * \return The number of online processors, or 1 if it can't be determined
+ */
+
+int getNumberOfCores()
+{
+    long nbCores=sysconf(_SC_NPROCESSORS_ONLN);
+    if(nbCores<1)
+        return 1;
+    return (int) nbCores;
+}
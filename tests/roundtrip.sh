@@ -0,0 +1,196 @@
+#!/bin/sh
+# Round trips of every mode and format of huffman on generated files: each file is compressed then decompressed and compared with cmp
+# Usage: tests/roundtrip.sh [PROGRAM] (default: ./bin/huffman)
+
+HUFFMAN=${1:-./bin/huffman}
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+nbTests=0
+nbFailures=0
+
+# fail DESCRIPTION
+fail()
+{
+    nbFailures=$((nbFailures+1))
+    echo "FAILED: $1"
+}
+
+# check DESCRIPTION ORIGINAL DECOMPRESSED
+check()
+{
+    nbTests=$((nbTests+1))
+    cmp -s "$2" "$3" || fail "$1"
+}
+
+# writeLittleEndian FILE OFFSET VALUE NB_BYTES : writes the NB_BYTES low bytes of VALUE (negative values are written modulo 2^64) at OFFSET in FILE
+writeLittleEndian()
+{
+    bytes=""
+    i=0
+    while [ $i -lt $4 ]; do
+        bytes="$bytes\\$(printf %o $((($3>>(8*i))&255)))"
+        i=$((i+1))
+    done
+    printf "$bytes" | dd of="$1" bs=1 seek=$2 conv=notrunc 2>/dev/null
+}
+
+# roundTrip NAME FILE [OPTIONS OF -c]... : compresses FILE then decompresses it with -d and with -d --tree-walk
+roundTrip()
+{
+    name=$1
+    file=$2
+    shift 2
+    rm -f "$DIR/out.huf" "$DIR/out"
+    "$HUFFMAN" -c "$@" "$file" "$DIR/out.huf" >/dev/null 2>&1 || fail "$name: -c $* $file"
+    "$HUFFMAN" -d "$DIR/out.huf" "$DIR/out" >/dev/null 2>&1 || fail "$name: -d $file"
+    check "$name: $file" "$file" "$DIR/out"
+    rm -f "$DIR/out"
+    "$HUFFMAN" -d --tree-walk "$DIR/out.huf" "$DIR/out" >/dev/null 2>&1 || fail "$name: -d --tree-walk $file"
+    check "$name --tree-walk: $file" "$file" "$DIR/out"
+}
+
+# Files of each kind: a single character, text, binary, random data (stored) and a file of a single repeated character
+mkdir "$DIR/data" "$DIR/data/sub"
+printf 'a' > "$DIR/data/one"
+printf 'Huffman coding\n' > "$DIR/data/small.txt"
+seq 1 100000 | sed 's/$/ is a line of text compressed by huffman/' > "$DIR/data/text.txt"
+cp "$HUFFMAN" "$DIR/data/sub/program"
+head -c 300000 /dev/urandom > "$DIR/data/sub/random"
+head -c 100000 /dev/zero > "$DIR/data/sub/zeros"
+files="$DIR/data/one $DIR/data/small.txt $DIR/data/text.txt $DIR/data/sub/program $DIR/data/sub/random $DIR/data/sub/zeros"
+
+mkfifo "$DIR/fifo"
+"$HUFFMAN" --train "$DIR/data" "$DIR/table" >/dev/null 2>&1 || fail "--train"
+nbTests=$((nbTests+1))
+mkdir "$DIR/nested"
+cp -r "$DIR/data" "$DIR/nested"
+"$HUFFMAN" --train "$DIR/nested" "$DIR/table3" >/dev/null 2>&1
+cmp -s "$DIR/table" "$DIR/table3" || fail "--train reads the files of the sub-directories"
+
+for file in $files; do
+    roundTrip "default" "$file"
+    roundTrip "--bitstreams 1" "$file" --bitstreams 1
+    roundTrip "--max-code-len 8" "$file" --max-code-len 8
+    roundTrip "--adaptive" "$file" --adaptive
+    roundTrip "--context" "$file" --context
+    roundTrip "-b 1" "$file" -b 1
+    roundTrip "-j 2 -b 1" "$file" -j 2 -b 1
+    roundTrip "--sample" "$file" --sample
+    roundTrip "--pipeline 2" "$file" --pipeline 2 --pipeline-buffer 4
+
+    # --table: the table is also given to -d
+    rm -f "$DIR/out"
+    "$HUFFMAN" -c --table "$DIR/table" "$file" "$DIR/out.huf" >/dev/null 2>&1 || fail "--table: -c $file"
+    "$HUFFMAN" -d --table "$DIR/table" "$DIR/out.huf" "$DIR/out" >/dev/null 2>&1 || fail "--table: -d $file"
+    check "--table: $file" "$file" "$DIR/out"
+
+    # Streams, read in memory or by chunks, with or without pipeline, decompressed in a pipe
+    for options in "" "--memory 0" "--memory 0 -b 1" "--pipeline 2 --pipeline-buffer 4" "--adaptive"; do
+        "$HUFFMAN" -c $options - - < "$file" 2>/dev/null | "$HUFFMAN" -d - - 2>/dev/null > "$DIR/out"
+        check "stdin $options: $file" "$file" "$DIR/out"
+    done
+
+    # Pipes given by their name, read like stdin
+    for options in "" "--memory 0" "-b 1" "--context"; do
+        cat "$file" > "$DIR/fifo" &
+        "$HUFFMAN" -c $options "$DIR/fifo" "$DIR/out.huf" >/dev/null 2>&1
+        wait
+        cat "$DIR/out.huf" > "$DIR/fifo" &
+        "$HUFFMAN" -d "$DIR/fifo" "$DIR/out" >/dev/null 2>&1
+        wait
+        check "FIFO $options: $file" "$file" "$DIR/out"
+    done
+
+    # Files written at their position (4 bitstreams, blocks, stored) decompressed in a pipe or through a pipeline
+    "$HUFFMAN" -c "$file" "$DIR/out.huf" >/dev/null 2>&1
+    "$HUFFMAN" -d "$DIR/out.huf" - 2>/dev/null | cat > "$DIR/out"
+    check "-d to stdout: $file" "$file" "$DIR/out"
+    "$HUFFMAN" -d "$DIR/out.huf" /dev/fd/3 3>&1 >/dev/null 2>&1 | cat > "$DIR/out"
+    check "-d to a pipe given by its path: $file" "$file" "$DIR/out"
+    cat "$DIR/fifo" > "$DIR/out" &
+    "$HUFFMAN" -d "$DIR/out.huf" "$DIR/fifo" >/dev/null 2>&1
+    wait
+    check "-d to a FIFO: $file" "$file" "$DIR/out"
+    "$HUFFMAN" -c -j 2 -b 1 "$file" "$DIR/out.huf" >/dev/null 2>&1
+    "$HUFFMAN" -d -j 2 "$DIR/out.huf" - 2>/dev/null | cat > "$DIR/out"
+    check "-d -j 2 to stdout: $file" "$file" "$DIR/out"
+    "$HUFFMAN" -d -j 2 "$DIR/out.huf" /dev/fd/3 3>&1 >/dev/null 2>&1 | cat > "$DIR/out"
+    check "-d -j 2 to a pipe given by its path: $file" "$file" "$DIR/out"
+    cat "$DIR/fifo" > "$DIR/out" &
+    "$HUFFMAN" -d -j 2 "$DIR/out.huf" "$DIR/fifo" >/dev/null 2>&1
+    wait
+    check "-d -j 2 to a FIFO: $file" "$file" "$DIR/out"
+    rm -f "$DIR/out"
+    "$HUFFMAN" -d -j 2 --pipeline 2 "$DIR/out.huf" "$DIR/out" >/dev/null 2>&1
+    check "-d -j 2 --pipeline 2: $file" "$file" "$DIR/out"
+done
+
+# Binary header: magic, and random data stored with at most the size of the header
+"$HUFFMAN" -c "$DIR/data/text.txt" "$DIR/out.huf" >/dev/null 2>&1
+nbTests=$((nbTests+1))
+[ "$(head -c 4 "$DIR/out.huf" | od -An -tx1 | tr -d ' \n')" = "89485546" ] || fail "the compressed file starts with the magic"
+"$HUFFMAN" -c "$DIR/data/sub/random" "$DIR/out.huf" >/dev/null 2>&1
+nbTests=$((nbTests+1))
+[ "$(wc -c < "$DIR/out.huf")" -le $((300000+64)) ] || fail "random data is stored"
+"$HUFFMAN" -c --table "$DIR/table" "$DIR/data/sub/random" "$DIR/out.huf" >/dev/null 2>&1
+nbTests=$((nbTests+1))
+[ "$(wc -c < "$DIR/out.huf")" -le $((300000+64)) ] || fail "random data compressed with --table is stored"
+
+# Block files whose index doesn't match the original size given by the header are rejected: the low bit of the size, first varint after the fixed header, is changed
+"$HUFFMAN" -c -b 1 "$DIR/data/text.txt" "$DIR/out.huf" >/dev/null 2>&1
+byte=$(od -An -tu1 -j8 -N1 "$DIR/out.huf")
+printf "\\$(printf %o $((byte^1)))" | dd of="$DIR/out.huf" bs=1 seek=8 conv=notrunc 2>/dev/null
+nbTests=$((nbTests+1))
+"$HUFFMAN" -d -j 2 "$DIR/out.huf" "$DIR/out" >/dev/null 2>&1 && fail "a block file whose index doesn't match its header is rejected"
+nbTests=$((nbTests+1))
+"$HUFFMAN" -d "$DIR/out.huf" - >/dev/null 2>&1 && fail "a block file whose blocks don't match its header is rejected"
+
+# Block files whose trailer or index points outside of the file are rejected by -d -j 2, even when the sizes wrap around in 64 bits: a huge number of blocks with the matching index offset, an index offset in the header, then a first block before the file, inside the header or past the index
+"$HUFFMAN" -c -b 1 "$DIR/data/text.txt" "$DIR/block.huf" >/dev/null 2>&1
+size=$(wc -c < "$DIR/block.huf")
+indexOffset=$(od -An -tu8 -j $((size-16)) -N8 "$DIR/block.huf" | tr -d ' ')
+compressedSize=$(od -An -tu4 -j $((indexOffset+12)) -N4 "$DIR/block.huf" | tr -d ' ')
+for corruption in "$((size-16)) $((size-2000000*16-16)) 8 $((size-8)) 2000000 4" "$((size-16)) 4 8" "$indexOffset $((-compressedSize+1)) 8" "$indexOffset 0 8" "$indexOffset $((size-16-compressedSize+1)) 8"; do
+    cp "$DIR/block.huf" "$DIR/out.huf"
+    set -- $corruption
+    while [ $# -ge 3 ]; do
+        writeLittleEndian "$DIR/out.huf" $1 $2 $3
+        shift 3
+    done
+    nbTests=$((nbTests+1))
+    "$HUFFMAN" -d -j 2 "$DIR/out.huf" "$DIR/out" 2>&1 >/dev/null | grep -q "the index of the blocks is incorrect" || fail "a block file whose index is out of bounds is rejected ($corruption)"
+done
+
+# Files of version 1, where the tree is saved, are still decompressed
+printf '8\n1\n2\n\240\nba\n\226' > "$DIR/version1"
+"$HUFFMAN" -d "$DIR/version1" "$DIR/out" >/dev/null 2>&1 || fail "-d of a file of version 1"
+printf 'abbabaab' > "$DIR/original"
+check "file of version 1" "$DIR/original" "$DIR/out"
+printf '5\n0\n1\nA' > "$DIR/version1"
+"$HUFFMAN" -d "$DIR/version1" "$DIR/out" >/dev/null 2>&1 || fail "-d of a file of version 1 with a single character"
+printf 'AAAAA' > "$DIR/original"
+check "file of version 1 with a single character" "$DIR/original" "$DIR/out"
+
+# Files that aren't compressed by huffman are rejected before DEST is truncated
+for content in 'abc' '9999999999\n0\n1\nA\n' '99999\n0\n1\nA\n' '1000\n2\n3\n\240\nba\n\226'; do
+    printf "$content" > "$DIR/foreign"
+    printf 'kept' > "$DIR/out"
+    nbTests=$((nbTests+1))
+    "$HUFFMAN" -d "$DIR/foreign" "$DIR/out" >/dev/null 2>&1 && fail "the foreign file $content is rejected"
+    [ "$(cat "$DIR/out")" = "kept" ] || fail "DEST is kept when $content is rejected"
+done
+
+# Archives: all the files, then a single member
+for options in "" "-j 2"; do
+    rm -rf "$DIR/extracted"
+    "$HUFFMAN" -c -r $options "$DIR/data" "$DIR/archive" >/dev/null 2>&1 || fail "-c -r $options"
+    "$HUFFMAN" -d -r "$DIR/archive" "$DIR/extracted" >/dev/null 2>&1 || fail "-d -r $options"
+    nbTests=$((nbTests+1))
+    diff -r "$DIR/data" "$DIR/extracted" >/dev/null || fail "-r $options: the extracted directory is the original one"
+done
+rm -f "$DIR/out"
+"$HUFFMAN" -d --member sub/random "$DIR/archive" "$DIR/out" >/dev/null 2>&1 || fail "--member"
+check "--member sub/random" "$DIR/data/sub/random" "$DIR/out"
+
+echo "huffman: $nbTests round trips and checks, $nbFailures failed"
+[ "$nbFailures" -eq 0 ]
@@ -0,0 +1,49 @@
+#!/bin/sh
+# Round trips of a sparse file bigger than 4 GiB, to check the 64 bits sizes, counts and offsets: its holes are read as zeros, and a few lines of text are written before and after 2 GiB and 4 GiB
+# The compressed files take about 540 MiB (1 bit per zero), the decompressed ones are compared with cmp through a pipe
+# Usage: tests/sparse.sh [PROGRAM] (default: ./bin/huffman)
+
+HUFFMAN=${1:-./bin/huffman}
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+FILE="$DIR/sparse"
+nbTests=0
+nbFailures=0
+
+# fail DESCRIPTION
+fail()
+{
+    nbFailures=$((nbFailures+1))
+    echo "FAILED: $1"
+}
+
+# check [OPTIONS OF -d]... : decompresses $DIR/out.huf in a pipe and compares it with $FILE, the test being described by $name
+check()
+{
+    nbTests=$((nbTests+1))
+    "$HUFFMAN" -d "$@" "$DIR/out.huf" - 2>/dev/null | cmp -s - "$FILE" || fail "$name"
+}
+
+truncate -s 4300M "$FILE" || exit 1
+for offset in 0 2047 2048 4095 4096 4299; do # In MiB
+    seq 1 1000 | dd of="$FILE" bs=1M seek=$offset conv=notrunc 2>/dev/null
+done
+
+for options in "" "-j 0" "--sample" "--bitstreams 1"; do
+    name="-c $options"
+    "$HUFFMAN" -c $options "$FILE" "$DIR/out.huf" >/dev/null 2>&1 || fail "$name: compression"
+    check
+done
+name="-c -j 0, -d -j 0"
+"$HUFFMAN" -c -j 0 "$FILE" "$DIR/out.huf" >/dev/null 2>&1
+check -j 0
+
+name="stdin"
+"$HUFFMAN" -c - "$DIR/out.huf" < "$FILE" >/dev/null 2>&1 || fail "$name: compression"
+check
+name="stdin with a pipe"
+cat "$FILE" | "$HUFFMAN" -c - - 2>/dev/null > "$DIR/out.huf"
+check
+
+echo "huffman: $nbTests round trips of a sparse file of 4300 MiB, $nbFailures failed"
+[ "$nbFailures" -eq 0 ]
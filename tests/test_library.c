@@ -0,0 +1,164 @@
+/**
+ * \file test_library.c
+ * \brief Tests of libhuffman: buffers of each kind and size are compressed and decompressed with huffmanCompress and huffmanDecompress, then one after the other with the same context, and incorrect buffers must be rejected
+ * \date 2021
+ */
+
+#include "../include/library.h"
+
+/**
+ * \def TEST_MAX_SIZE
+ * \brief Size of the biggest buffer that is tested
+ */
+
+#define TEST_MAX_SIZE (1024*1024)
+
+/**
+ * \def TEST_NB_KINDS
+ * \brief Number of kinds of buffers created by fillTestBuffer
+ */
+
+#define TEST_NB_KINDS 5
+
+int nbChecks=0; // Number of conditions checked
+int nbFailures=0; // Number of conditions that were false
+
+/**
+ * \fn void fillTestBuffer(unsigned char* buffer, size_t size, int kind, uint32_t seed)
+ * \brief Fills a buffer with pseudo-random content, always the same for a given seed
+ * \param buffer Buffer that is filled
+ * \param size Size of buffer
+ * \param kind 0: English-like words, 1: uniform bytes (stored), 2: a single character, 3: two characters, one much rarer, 4: bytes whose frequency decreases with their value
+ * \param seed Seed of the pseudo-random generator
+ */
+
+void fillTestBuffer(unsigned char* buffer, size_t size, int kind, uint32_t seed)
+{
+    const char* words[]={"the ", "of ", "and ", "huffman ", "code ", "table ", "is ", "a ", "compressed ", "stream\n"};
+    uint32_t state=seed*2654435761u+1;
+    size_t i=0;
+    const char* word=NULL;
+
+    while(i<size){
+        state^=state<<13;
+        state^=state>>17;
+        state^=state<<5;
+        if(kind==0){
+            for(word=words[state%10]; *word!='\0' && i<size; word++, i++)
+                buffer[i]=*word;
+        }
+        else{
+            if(kind==1)
+                buffer[i]=state>>24;
+            else if(kind==2)
+                buffer[i]='A';
+            else if(kind==3)
+                buffer[i]=(state%1000==0) ? 'b' : 'a';
+            else
+                buffer[i]=(state>>24)&(state>>16)&(state>>8);
+            i++;
+        }
+    }
+}
+
+/**
+ * \fn void check(int condition, const char* message, int kind, size_t size)
+ * \brief Counts a check and displays it if it failed
+ * \param condition Result of the check
+ * \param message Description of the check
+ * \param kind Kind of the tested buffer
+ * \param size Size of the tested buffer
+ */
+
+void check(int condition, const char* message, int kind, size_t size)
+{
+    nbChecks++;
+    if(!condition){
+        nbFailures++;
+        fprintf(stderr, "FAILED: %s (kind %d, %zu bytes)\n", message, kind, size);
+    }
+}
+
+/**
+ * \fn void testRoundTrip(HuffmanContext* context, const unsigned char* input, size_t size, int kind, unsigned char* compressed, unsigned char* output)
+ * \brief Compresses and decompresses a buffer, checks the result, then checks that a buffer too small or a truncated compressed buffer is rejected
+ * \param context Context used by both functions, or NULL to use huffmanCompress and huffmanDecompress
+ * \param input Buffer that is tested
+ * \param size Size of input, at least 1
+ * \param kind Kind of input
+ * \param compressed Buffer of huffmanCompressBound(TEST_MAX_SIZE) bytes
+ * \param output Buffer of TEST_MAX_SIZE bytes
+ */
+
+void testRoundTrip(HuffmanContext* context, const unsigned char* input, size_t size, int kind, unsigned char* compressed, unsigned char* output)
+{
+    size_t bound=huffmanCompressBound(size);
+    size_t compressedSize=0;
+    size_t outputSize=0;
+
+    if(context!=NULL)
+        compressedSize=huffmanCompressWithContext(context, input, size, compressed, bound);
+    else
+        compressedSize=huffmanCompress(input, size, compressed, bound);
+    check(compressedSize>0 && compressedSize<=bound, "the compressed size is within the bound", kind, size);
+    if(compressedSize==0)
+        return;
+    check(compressedSize<=size+FILE_HEADER_MAX_SIZE, "a buffer that can't be compressed is stored", kind, size);
+    check(!memcmp(compressed, FILE_MAGIC, 4), "the compressed buffer starts with the magic", kind, size);
+
+    if(context!=NULL)
+        outputSize=huffmanDecompressWithContext(context, compressed, compressedSize, output, size);
+    else
+        outputSize=huffmanDecompress(compressed, compressedSize, output, size);
+    check(outputSize==size && !memcmp(input, output, size), "the decompressed buffer is the original one", kind, size);
+
+    check(huffmanDecompress(compressed, compressedSize, output, size-1)==0, "a destination too small is rejected", kind, size);
+    check(huffmanCompress(input, size, compressed, compressedSize-1)==0, "a compressed buffer bigger than the capacity is rejected", kind, size);
+    check(huffmanDecompress(compressed, compressedSize-1, output, size)==0, "a truncated buffer is rejected", kind, size);
+    check(huffmanDecompress(compressed, FILE_HEADER_FIXED_SIZE-1, output, size)==0, "a truncated header is rejected", kind, size);
+    compressed[0]^=0xFF;
+    check(huffmanDecompress(compressed, compressedSize, output, size)==0, "a buffer without the magic is rejected", kind, size);
+}
+
+int main()
+{
+    const size_t sizes[]={1, 2, 100, 4096, INTERLEAVED_MIN_SIZE-1, INTERLEAVED_MIN_SIZE, 100000, TEST_MAX_SIZE};
+    const int nbSizes=sizeof(sizes)/sizeof(sizes[0]);
+    unsigned char* input=NULL;
+    unsigned char* compressed=NULL;
+    unsigned char* output=NULL;
+    HuffmanContext* context=NULL;
+
+    MALLOC(input, unsigned char, TEST_MAX_SIZE);
+    MALLOC(compressed, unsigned char, huffmanCompressBound(TEST_MAX_SIZE));
+    MALLOC(output, unsigned char, TEST_MAX_SIZE);
+
+    check(huffmanCompress(input, 0, compressed, huffmanCompressBound(0))==0, "an empty buffer is rejected", 0, 0);
+    for(int kind=0; kind<TEST_NB_KINDS; kind++){
+        for(int i=0; i<nbSizes; i++){
+            fillTestBuffer(input, sizes[i], kind, i);
+            testRoundTrip(NULL, input, sizes[i], kind, compressed, output);
+        }
+    }
+
+    // The same context is used for buffers whose codes change, and for buffers with the same codes (small then big) that reuse its decoder
+    context=createHuffmanContext();
+    for(int i=0; i<nbSizes; i++){
+        for(int kind=0; kind<TEST_NB_KINDS; kind++){
+            fillTestBuffer(input, sizes[i], kind, i);
+            testRoundTrip(context, input, sizes[i], kind, compressed, output);
+        }
+    }
+    for(int i=0; i<nbSizes; i++){
+        fillTestBuffer(input, sizes[i], 3, 0);
+        testRoundTrip(context, input, sizes[i], 3, compressed, output);
+        testRoundTrip(context, input, sizes[i], 3, compressed, output);
+    }
+    freeHuffmanContext(&context);
+
+    free(input);
+    free(compressed);
+    free(output);
+    printf("libhuffman: %d checks, %d failed\n", nbChecks, nbFailures);
+    return (nbFailures>0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}